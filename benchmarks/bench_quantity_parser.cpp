@@ -0,0 +1,218 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Compare the quantity parser used by the checks of the highways and places views with the
+ * strtol()/strtod() based parsing it replaced.
+ *
+ * Usage: bench_quantity_parser [TAGS_FILE]
+ *
+ * TAGS_FILE contains one tag per line as key=value, e.g. extracted from a real data set:
+ *
+ *     osmium cat -f opl input.osm.pbf | grep -oE '(maxspeed|maxheight|maxweight|maxlength|lanes|population|admin_level)=[^,]*' | sed 's/%20%/ /g'
+ *
+ * Without a file, a small built-in sample of common values is used.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "check_rules.hpp"
+#include "quantity.hpp"
+
+namespace {
+
+    struct TestValue {
+        std::string key;
+        std::string value;
+        const CheckRule* rule;
+    };
+
+    const char* builtin_sample[] = {
+        "maxspeed=50", "maxspeed=30", "maxspeed=70", "maxspeed=100", "maxspeed=60", "maxspeed=80",
+        "maxspeed=30 mph", "maxspeed=25 mph", "maxspeed=DE:urban", "maxspeed=none", "maxspeed=signals",
+        "maxspeed=50;30", "maxspeed=walk", "maxheight=3.5", "maxheight=4", "maxheight=default",
+        "maxheight=12'6\"", "maxheight=13'", "maxheight=3,5", "maxheight=3.5 m", "maxweight=7.5",
+        "maxweight=3.5", "maxweight=12 t", "maxweight=3500 kg", "maxweight=20 st", "maxweight=7,5",
+        "maxlength=12", "maxlength=18.75", "lanes=2", "lanes=1", "lanes=4", "lanes=3", "lanes=2;3",
+        "population=1234", "population=250000", "population=12 345", "admin_level=8", "admin_level=2",
+        "admin_level=10"
+    };
+
+    /**
+     * Number matching as it was implemented before the quantity parser: every number
+     * specification reads the value again.
+     */
+    bool legacy_matches(const CheckRule::NumberSpec& spec, const char* value) {
+        char* rest;
+        if (spec.format == CheckRule::number_format::real) {
+            const double number = std::strtod(value, &rest);
+            return rest != value && !strcmp(rest, spec.unit.c_str()) && spec.in_range(number);
+        }
+        const long int number = std::strtol(value, &rest, 10);
+        if (rest == value) {
+            return false;
+        }
+        if (spec.format == CheckRule::number_format::integer) {
+            return !strcmp(rest, spec.unit.c_str()) && spec.in_range(number);
+        }
+        if (*rest != '\'' || !spec.in_range(number)) {
+            return false;
+        }
+        ++rest;
+        if (*rest >= '0' && *rest <= '9') {
+            char* rest2;
+            const double inches = std::strtod(rest, &rest2);
+            return inches > 0 || *rest2 == '"';
+        }
+        return *rest == 0;
+    }
+
+    bool legacy_accepts(const CheckRule& rule, const char* value) {
+        if (rule.values.contains(value)) {
+            return true;
+        }
+        for (const CheckRule::NumberSpec& spec : rule.numbers) {
+            if (legacy_matches(spec, value)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Integer checks outside of the rules (lanes, population, admin_level)
+     */
+    bool legacy_integer(const char* value, long& number) {
+        char* rest;
+        number = std::strtol(value, &rest, 10);
+        return !*rest;
+    }
+
+    bool quantity_integer(const char* value, long& number) {
+        const Quantity quantity = Quantity::parse(value);
+        number = quantity.integer;
+        return !*quantity.integer_end;
+    }
+
+    template <typename TFunc>
+    double measure(const std::vector<TestValue>& values, const int rounds, TFunc func) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i) {
+            for (const TestValue& value : values) {
+                func(value);
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(values.size()) * rounds);
+    }
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    CheckRules rules;
+    rules.load_string(CheckRules::default_rules());
+
+    std::vector<std::string> lines;
+    if (argc > 1) {
+        std::ifstream input{argv[1]};
+        if (!input) {
+            std::cerr << "Failed to open " << argv[1] << '\n';
+            return 1;
+        }
+        std::string line;
+        while (std::getline(input, line)) {
+            lines.push_back(line);
+        }
+    } else {
+        std::cerr << "No tags file given, using the built-in sample.\n";
+        for (const char* line : builtin_sample) {
+            lines.emplace_back(line);
+        }
+    }
+
+    std::vector<TestValue> values;
+    for (const std::string& line : lines) {
+        const size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            continue;
+        }
+        TestValue value{line.substr(0, equals), line.substr(equals + 1), nullptr};
+        for (const auto& rule : rules.rules()) {
+            if (rule->key == value.key && !rule->numbers.empty()) {
+                value.rule = rule.get();
+                break;
+            }
+        }
+        values.push_back(value);
+    }
+    if (values.empty()) {
+        std::cerr << "No tags found.\n";
+        return 1;
+    }
+
+    // Both implementations have to agree.
+    size_t mismatches = 0;
+    for (const TestValue& value : values) {
+        if (value.rule) {
+            mismatches += (legacy_accepts(*value.rule, value.value.c_str()) != value.rule->accepts(value.value.c_str()));
+        } else {
+            long legacy = 0;
+            long quantity = 0;
+            mismatches += (legacy_integer(value.value.c_str(), legacy) != quantity_integer(value.value.c_str(), quantity))
+                || legacy != quantity;
+        }
+    }
+
+    const int rounds = std::max(1, static_cast<int>(20000000 / values.size()));
+    size_t sink = 0;
+    const double legacy_ns = measure(values, rounds, [&sink](const TestValue& value) {
+        if (value.rule) {
+            sink += legacy_accepts(*value.rule, value.value.c_str());
+        } else {
+            long number;
+            sink += legacy_integer(value.value.c_str(), number) + number;
+        }
+    });
+    const double quantity_ns = measure(values, rounds, [&sink](const TestValue& value) {
+        if (value.rule) {
+            sink += value.rule->accepts(value.value.c_str());
+        } else {
+            long number;
+            sink += quantity_integer(value.value.c_str(), number) + number;
+        }
+    });
+
+    std::cout << "values:          " << values.size() << " x " << rounds << " rounds\n"
+              << "strtol/strtod:   " << legacy_ns << " ns per value\n"
+              << "Quantity::parse: " << quantity_ns << " ns per value\n"
+              << "speedup:         " << legacy_ns / quantity_ns << "\n"
+              << "(checksum " << sink << ")\n";
+    if (mismatches) {
+        std::cerr << mismatches << " values are judged differently\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,682 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Write a synthetic OSM data set for scaling benchmarks.
+ *
+ * Usage: osmi_generate_data [OPTIONS] OUTPUT_FILE
+ *
+ * The data consists of square tiles placed side by side, each one a small town with a grid of
+ * streets, a place node, an administrative boundary, land use multipolygons and a bus route. The
+ * tags follow the distributions of common values with a share of broken values, so every layer of
+ * every view gets features: misspelled and overlong tags, invalid maxspeed, lanes and turn:lanes
+ * values, places with invalid population, self-intersecting, very long and degenerated ways,
+ * long segments, unclosed boundaries and broken multipolygons.
+ *
+ * The output file grows linearly with the number of tiles. The number of objects and the size of
+ * the file are printed when it is written. The content depends only on the seed and the number of
+ * tiles; the random numbers are drawn from std::mt19937_64 without the distributions of the
+ * standard library because their results differ between implementations.
+ *
+ * The output format is derived from the suffix of OUTPUT_FILE (usually .osm.pbf, .opl is helpful
+ * to look at the data).
+ */
+
+#include <getopt.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/io/any_output.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/box.hpp>
+#include <osmium/osm/location.hpp>
+
+namespace {
+
+    using tags_type = std::vector<std::pair<std::string, std::string>>;
+
+    /// IDs of the objects of a tile start at tile number * stride + 1
+    constexpr osmium::object_id_type NODE_ID_STRIDE = 10000;
+    constexpr osmium::object_id_type WAY_ID_STRIDE = 1000;
+    constexpr osmium::object_id_type RELATION_ID_STRIDE = 100;
+
+    /// maximum size of a tile in degrees
+    constexpr double MAX_TILE_SIZE = 0.05;
+
+    /// number of nodes of the very long ways (the geometry view reports ways with 1900 nodes or more)
+    constexpr size_t LONG_WAY_NODES = 1950;
+
+    /// buffers are handed to the writer if they are filled up to this size
+    constexpr size_t BUFFER_SIZE = 4 * 1024 * 1024;
+
+    struct GeneratedNode {
+        osmium::object_id_type id;
+        osmium::Location location;
+        tags_type tags;
+    };
+
+    struct GeneratedWay {
+        osmium::object_id_type id;
+        std::vector<osmium::object_id_type> nodes;
+        tags_type tags;
+    };
+
+    struct GeneratedRelation {
+        osmium::object_id_type id;
+        std::vector<osmium::builder::attr::member_type> members;
+        tags_type tags;
+    };
+
+    struct Tile {
+        std::vector<GeneratedNode> nodes;
+        std::vector<GeneratedWay> ways;
+        std::vector<GeneratedRelation> relations;
+    };
+
+    /**
+     * Value with its weight for weighted random choices.
+     */
+    struct Weighted {
+        const char* value;
+        unsigned int weight;
+    };
+
+    const Weighted highway_classes[] = {
+        {"residential", 35}, {"service", 15}, {"unclassified", 10}, {"tertiary", 10},
+        {"secondary", 7}, {"primary", 5}, {"track", 8}, {"footway", 6}, {"trunk", 2},
+        {"motorway", 1}, {"living_street", 1}
+    };
+
+    const Weighted maxspeed_values[] = {
+        {"30", 25}, {"50", 30}, {"70", 10}, {"100", 8}, {"30 mph", 5}, {"DE:urban", 5},
+        {"none", 2}, {"walk", 2}, {"50;30", 2}, {"fast", 1}, {"5O", 1}
+    };
+
+    const Weighted lanes_values[] = {
+        {"1", 30}, {"2", 45}, {"3", 10}, {"4", 8}, {"2;3", 2}, {"two", 2}, {"0", 1}
+    };
+
+    const Weighted oneway_values[] = {
+        {"yes", 70}, {"-1", 10}, {"no", 15}, {"true", 5}
+    };
+
+    const Weighted place_classes[] = {
+        {"city", 2}, {"town", 10}, {"village", 50}, {"hamlet", 30}, {"suburb", 8}
+    };
+
+    const Weighted broken_population_values[] = {
+        {"ca. 500", 1}, {"1.234", 1}, {"-5", 1}, {"12 345", 1}, {"many", 1}
+    };
+
+    const char* const turn_directions[] = {
+        "left", "through", "right", "slight_left", "slight_right", "none", "left;through",
+        "through;right", ""
+    };
+
+    const char* const landuse_values[] = {
+        "forest", "meadow", "farmland", "residential", "industrial", "grass"
+    };
+
+    /**
+     * Tags with problems found by the tagging view
+     */
+    const std::pair<const char*, const char*> odd_tags[] = {
+        {"name ", "Main Street"}, {"Name", "Main Street"}, {"fixme ", "check"},
+        {"addr:street", "Hauptstraße"}, {"höhe", "12"}, {"name_1", "Old Name"},
+        {"source", "survey"}, {"note", "\xc3\x28 invalid UTF-8"}, {"highway:", "yes"},
+        {"building", "yes;no"}, {"", "empty key"}, {"description", ""}
+    };
+
+    class Random {
+
+        std::mt19937_64 m_engine;
+
+    public:
+        explicit Random(const uint64_t seed) :
+            m_engine(seed) {
+        }
+
+        uint64_t next() {
+            return m_engine();
+        }
+
+        /**
+         * Random number in [0, n)
+         */
+        unsigned int below(const unsigned int n) {
+            return static_cast<unsigned int>(next() % n);
+        }
+
+        /**
+         * Random number in [0, 1)
+         */
+        double uniform() {
+            return static_cast<double>(next() >> 11) / 9007199254740992.0;
+        }
+
+        bool chance(const double probability) {
+            return uniform() < probability;
+        }
+
+        template <size_t N>
+        const char* pick(const Weighted (&values)[N]) {
+            unsigned int total = 0;
+            for (const Weighted& v : values) {
+                total += v.weight;
+            }
+            unsigned int r = below(total);
+            for (const Weighted& v : values) {
+                if (r < v.weight) {
+                    return v.value;
+                }
+                r -= v.weight;
+            }
+            return values[N - 1].value;
+        }
+
+        template <typename T, size_t N>
+        const T& pick(const T (&values)[N]) {
+            return values[below(N)];
+        }
+    };
+
+    /**
+     * Placement of the tiles on the globe. The tiles are arranged as a square around 10° E, 50° N
+     * which grows until it covers the whole world.
+     */
+    class Layout {
+
+        size_t m_columns;
+        double m_width;
+        double m_height;
+        double m_min_lon;
+        double m_min_lat;
+
+    public:
+        explicit Layout(const size_t tiles) {
+            m_columns = std::max<size_t>(1, static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(tiles)))));
+            const size_t rows = (tiles + m_columns - 1) / m_columns;
+            m_width = std::min(MAX_TILE_SIZE, 350.0 / m_columns);
+            m_height = std::min(MAX_TILE_SIZE, 140.0 / std::max<size_t>(rows, 1));
+            m_min_lon = std::max(-175.0, 10.0 - m_width * m_columns / 2);
+            m_min_lat = std::min(std::max(-70.0, 50.0 - m_height * rows / 2), 70.0 - m_height * rows);
+        }
+
+        osmium::Location origin(const size_t tile) const {
+            return osmium::Location{m_min_lon + (tile % m_columns) * m_width, m_min_lat + (tile / m_columns) * m_height};
+        }
+
+        double width() const noexcept {
+            return m_width;
+        }
+
+        double height() const noexcept {
+            return m_height;
+        }
+
+        osmium::Box box(const size_t tiles) const {
+            const size_t rows = (tiles + m_columns - 1) / m_columns;
+            return osmium::Box{m_min_lon, m_min_lat, m_min_lon + m_columns * m_width, m_min_lat + rows * m_height};
+        }
+    };
+
+    /**
+     * Generates the content of one tile. The objects only refer to objects of the same tile.
+     */
+    class TileGenerator {
+
+        Random m_random;
+        Tile m_tile;
+        osmium::Location m_origin;
+        double m_width;
+        double m_height;
+        osmium::object_id_type m_next_node_id;
+        osmium::object_id_type m_next_way_id;
+        osmium::object_id_type m_next_relation_id;
+        size_t m_tile_number;
+
+        osmium::Location at(const double x, const double y) const {
+            return osmium::Location{m_origin.lon() + x * m_width, m_origin.lat() + y * m_height};
+        }
+
+        osmium::object_id_type add_node(const osmium::Location location, tags_type tags = tags_type{}) {
+            m_tile.nodes.push_back(GeneratedNode{m_next_node_id, location, std::move(tags)});
+            return m_next_node_id++;
+        }
+
+        osmium::object_id_type add_way(std::vector<osmium::object_id_type> nodes, tags_type tags) {
+            add_odd_tags(tags);
+            m_tile.ways.push_back(GeneratedWay{m_next_way_id, std::move(nodes), std::move(tags)});
+            return m_next_way_id++;
+        }
+
+        void add_relation(std::vector<osmium::builder::attr::member_type> members, tags_type tags) {
+            add_odd_tags(tags);
+            m_tile.relations.push_back(GeneratedRelation{m_next_relation_id++, std::move(members), std::move(tags)});
+        }
+
+        std::string name(const char* prefix, const unsigned int number) const {
+            return std::string{prefix} + ' ' + std::to_string(m_tile_number) + '-' + std::to_string(number);
+        }
+
+        void add_odd_tags(tags_type& tags) {
+            if (m_random.chance(0.03)) {
+                const std::pair<const char*, const char*>& tag = m_random.pick(odd_tags);
+                tags.emplace_back(tag.first, tag.second);
+            }
+            if (m_random.chance(0.002)) {
+                tags.emplace_back("description", std::string(300, 'x'));
+            }
+        }
+
+        std::string turn_lanes(const int lanes) {
+            std::string value;
+            // sometimes too few lanes
+            const int count = m_random.chance(0.1) ? std::max(lanes - 1, 1) : lanes;
+            for (int i = 0; i < count; ++i) {
+                if (i > 0) {
+                    value += '|';
+                }
+                value += m_random.pick(turn_directions);
+            }
+            if (m_random.chance(0.05)) {
+                value += ";back";
+            }
+            return value;
+        }
+
+        tags_type highway_tags(const unsigned int number) {
+            tags_type tags;
+            const char* highway = m_random.pick(highway_classes);
+            tags.emplace_back("highway", highway);
+            const bool minor = !strcmp(highway, "service") || !strcmp(highway, "track") || !strcmp(highway, "footway");
+            if (!minor) {
+                const unsigned int r = m_random.below(100);
+                if (r < 70) {
+                    tags.emplace_back("name", name("Street", number));
+                } else if (r < 73) {
+                    tags.emplace_back("name", "fixme");
+                } else if (r < 75) {
+                    tags.emplace_back("name", name("Street", number) + '?');
+                }
+            }
+            if ((!strcmp(highway, "primary") || !strcmp(highway, "trunk") || !strcmp(highway, "motorway"))
+                    && m_random.chance(0.6)) {
+                tags.emplace_back("ref", "B " + std::to_string(m_random.below(500) + 1));
+            }
+            if (m_random.chance(0.4)) {
+                tags.emplace_back("maxspeed", m_random.pick(maxspeed_values));
+            }
+            bool oneway = false;
+            if (m_random.chance(0.15)) {
+                const char* value = m_random.pick(oneway_values);
+                tags.emplace_back("oneway", value);
+                oneway = strcmp(value, "no") != 0;
+            }
+            if (m_random.chance(0.3)) {
+                const char* lanes_value = m_random.pick(lanes_values);
+                tags.emplace_back("lanes", lanes_value);
+                const int lanes = std::atoi(lanes_value);
+                if (lanes >= 2 && m_random.chance(0.2)) {
+                    // sometimes inconsistent
+                    const int forward = lanes / 2 + (m_random.chance(0.1) ? 1 : 0);
+                    tags.emplace_back("lanes:forward", std::to_string(forward));
+                    tags.emplace_back("lanes:backward", std::to_string(lanes - lanes / 2));
+                }
+                if (lanes >= 1 && (oneway || m_random.chance(0.02)) && m_random.chance(0.3)) {
+                    tags.emplace_back("turn:lanes", turn_lanes(lanes));
+                }
+            }
+            return tags;
+        }
+
+        /**
+         * Grid of streets, some of them split into two ways
+         */
+        void add_streets() {
+            const unsigned int size = 6 + m_random.below(7);
+            std::vector<osmium::object_id_type> grid;
+            grid.reserve(size * size);
+            for (unsigned int row = 0; row < size; ++row) {
+                for (unsigned int column = 0; column < size; ++column) {
+                    const double jitter_x = (m_random.uniform() - 0.5) * 0.02;
+                    const double jitter_y = (m_random.uniform() - 0.5) * 0.02;
+                    grid.push_back(add_node(at(0.1 + 0.8 * column / (size - 1) + jitter_x, 0.1 + 0.8 * row / (size - 1) + jitter_y)));
+                }
+            }
+            unsigned int number = 0;
+            for (unsigned int i = 0; i < size; ++i) {
+                std::vector<osmium::object_id_type> horizontal;
+                std::vector<osmium::object_id_type> vertical;
+                for (unsigned int j = 0; j < size; ++j) {
+                    horizontal.push_back(grid[i * size + j]);
+                    vertical.push_back(grid[j * size + i]);
+                }
+                for (std::vector<osmium::object_id_type>* street : {&horizontal, &vertical}) {
+                    ++number;
+                    if (m_random.chance(0.3)) {
+                        const size_t split = 1 + m_random.below(static_cast<unsigned int>(street->size() - 2));
+                        std::vector<osmium::object_id_type> second{street->begin() + split, street->end()};
+                        street->resize(split + 1);
+                        add_way(std::move(second), highway_tags(number));
+                    }
+                    add_way(std::move(*street), highway_tags(number));
+                }
+            }
+            // a few crossings carry traffic signals or a misspelled crossing tag
+            for (unsigned int i = 0; i < size; ++i) {
+                if (m_random.chance(0.2)) {
+                    GeneratedNode& node = m_tile.nodes[grid[m_random.below(size * size)] - m_tile.nodes.front().id];
+                    if (node.tags.empty()) {
+                        node.tags.emplace_back("highway", m_random.chance(0.9) ? "traffic_signals" : "trafic_signals");
+                    }
+                }
+            }
+            // bus route over the first horizontal street
+            if (m_random.chance(0.3)) {
+                std::vector<osmium::builder::attr::member_type> members;
+                for (const GeneratedWay& way : m_tile.ways) {
+                    if (way.nodes.front() >= grid.front() && way.nodes.front() < grid.front() + size
+                            && way.nodes.back() < grid.front() + size) {
+                        members.emplace_back(osmium::item_type::way, way.id, "");
+                    }
+                }
+                add_relation(std::move(members), tags_type{{"type", "route"}, {"route", "bus"}, {"ref", std::to_string(m_random.below(200) + 1)}});
+            }
+        }
+
+        osmium::object_id_type add_place() {
+            tags_type tags;
+            const char* place = m_random.pick(place_classes);
+            tags.emplace_back("place", place);
+            if (m_random.chance(0.95)) {
+                tags.emplace_back("name", name("Town", 0));
+            }
+            unsigned int max_population = 1000;
+            if (!strcmp(place, "city")) {
+                max_population = 5000000;
+            } else if (!strcmp(place, "town")) {
+                max_population = 300000;
+            } else if (!strcmp(place, "village")) {
+                max_population = 5000;
+            } else if (!strcmp(place, "hamlet")) {
+                max_population = 200;
+            }
+            const unsigned int r = m_random.below(100);
+            if (r < 65) {
+                tags.emplace_back("population", std::to_string(m_random.below(max_population) + 1));
+            } else if (r < 70) {
+                tags.emplace_back("population", m_random.pick(broken_population_values));
+            }
+            if (m_random.chance(0.02)) {
+                tags.emplace_back("capital", m_random.chance(0.5) ? "yes" : std::to_string(2 + m_random.below(7)));
+                if (m_random.chance(0.5)) {
+                    tags.emplace_back("admin_level", std::to_string(2 + m_random.below(7)));
+                }
+            }
+            if (m_random.chance(0.01)) {
+                tags.emplace_back("is_capital", "country");
+            }
+            return add_node(at(0.4 + m_random.uniform() * 0.2, 0.4 + m_random.uniform() * 0.2), std::move(tags));
+        }
+
+        /**
+         * Ring of nodes along a circle, the first node is repeated at the end.
+         */
+        std::vector<osmium::object_id_type> ring(const double center_x, const double center_y, const double radius, const unsigned int count) {
+            std::vector<osmium::object_id_type> nodes;
+            for (unsigned int i = 0; i < count; ++i) {
+                const double angle = 2 * M_PI * i / count;
+                nodes.push_back(add_node(at(center_x + radius * std::cos(angle), center_y + radius * std::sin(angle))));
+            }
+            nodes.push_back(nodes.front());
+            return nodes;
+        }
+
+        void add_boundary(const osmium::object_id_type place_node) {
+            std::vector<osmium::object_id_type> nodes;
+            const unsigned int per_side = 4 + m_random.below(8);
+            for (unsigned int i = 0; i < per_side; ++i) {
+                nodes.push_back(add_node(at(0.02 + 0.96 * i / per_side, 0.02)));
+            }
+            for (unsigned int i = 0; i < per_side; ++i) {
+                nodes.push_back(add_node(at(0.98, 0.02 + 0.96 * i / per_side)));
+            }
+            for (unsigned int i = 0; i < per_side; ++i) {
+                nodes.push_back(add_node(at(0.98 - 0.96 * i / per_side, 0.98)));
+            }
+            for (unsigned int i = 0; i < per_side; ++i) {
+                nodes.push_back(add_node(at(0.02, 0.98 - 0.96 * i / per_side)));
+            }
+            // some boundaries are not closed
+            if (!m_random.chance(0.04)) {
+                nodes.push_back(nodes.front());
+            }
+            const osmium::object_id_type way = add_way(std::move(nodes), tags_type{{"boundary", "administrative"}, {"admin_level", "8"}});
+            std::vector<osmium::builder::attr::member_type> members;
+            members.emplace_back(osmium::item_type::way, way, "outer");
+            members.emplace_back(osmium::item_type::node, place_node, m_random.chance(0.5) ? "admin_centre" : "label");
+            tags_type tags{{"type", "boundary"}, {"boundary", "administrative"}, {"admin_level", "8"}, {"name", name("Town", 0)}};
+            if (m_random.chance(0.1)) {
+                tags.emplace_back("place", "municipality");
+            }
+            add_relation(std::move(members), std::move(tags));
+        }
+
+        void add_landuse() {
+            const unsigned int count = m_random.below(3);
+            for (unsigned int i = 0; i < count; ++i) {
+                const double x = 0.2 + m_random.uniform() * 0.6;
+                const double y = 0.2 + m_random.uniform() * 0.6;
+                const double radius = 0.03 + m_random.uniform() * 0.05;
+                std::vector<osmium::object_id_type> outer = ring(x, y, radius, 8 + m_random.below(24));
+                if (m_random.chance(0.05)) {
+                    // self-intersecting outer ring
+                    std::swap(outer[1], outer[outer.size() / 2]);
+                }
+                const char* landuse = m_random.pick(landuse_values);
+                if (m_random.chance(0.5)) {
+                    add_way(std::move(outer), tags_type{{"landuse", landuse}});
+                    continue;
+                }
+                std::vector<osmium::builder::attr::member_type> members;
+                members.emplace_back(osmium::item_type::way, add_way(std::move(outer), tags_type{}), "outer");
+                members.emplace_back(osmium::item_type::way, add_way(ring(x, y, radius / 3, 6), tags_type{}), "inner");
+                add_relation(std::move(members), tags_type{{"type", "multipolygon"}, {"landuse", landuse}});
+            }
+            // place areas
+            if (m_random.chance(0.05)) {
+                add_way(ring(0.3, 0.7, 0.05, 12), tags_type{{"place", "locality"}, {"name", name("Locality", 1)}});
+            }
+        }
+
+        void add_geometry_problems() {
+            if (m_random.chance(0.2)) {
+                // self-intersecting building (bow tie)
+                const osmium::object_id_type a = add_node(at(0.85, 0.85));
+                const osmium::object_id_type b = add_node(at(0.9, 0.9));
+                const osmium::object_id_type c = add_node(at(0.9, 0.85));
+                const osmium::object_id_type d = add_node(at(0.85, 0.9));
+                add_way({a, b, c, d, a}, tags_type{{"building", "yes"}});
+            }
+            if (m_random.chance(0.05)) {
+                // very long river
+                std::vector<osmium::object_id_type> nodes;
+                for (size_t i = 0; i < LONG_WAY_NODES; ++i) {
+                    const double x = 0.05 + 0.9 * i / LONG_WAY_NODES;
+                    nodes.push_back(add_node(at(x, 0.05 + 0.02 * std::sin(x * 40))));
+                }
+                add_way(std::move(nodes), tags_type{{"waterway", "river"}, {"name", name("River", 1)}});
+            }
+            if (m_random.chance(0.05)) {
+                // way with a duplicate node
+                const osmium::object_id_type a = add_node(at(0.12, 0.92));
+                const osmium::object_id_type b = add_node(at(0.18, 0.95));
+                add_way({a, b, b, add_node(at(0.22, 0.92))}, tags_type{{"highway", "footway"}});
+            }
+            if (m_random.chance(0.03)) {
+                // degenerated way
+                const osmium::object_id_type a = add_node(at(0.15, 0.15));
+                add_way({a, a}, tags_type{{"barrier", "fence"}});
+            }
+            if (m_random.chance(0.02)) {
+                // long segment
+                const osmium::object_id_type a = add_node(at(0.5, 0.5));
+                const osmium::object_id_type b = add_node(osmium::Location{m_origin.lon() + 0.5 * m_width + 0.4, m_origin.lat()});
+                add_way({a, b}, tags_type{{"power", "line"}});
+            }
+        }
+
+    public:
+        TileGenerator(const uint64_t seed, const size_t tile_number, const Layout& layout) :
+            m_random(seed * 0x9e3779b97f4a7c15ULL + tile_number),
+            m_tile(),
+            m_origin(layout.origin(tile_number)),
+            m_width(layout.width()),
+            m_height(layout.height()),
+            m_next_node_id(static_cast<osmium::object_id_type>(tile_number) * NODE_ID_STRIDE + 1),
+            m_next_way_id(static_cast<osmium::object_id_type>(tile_number) * WAY_ID_STRIDE + 1),
+            m_next_relation_id(static_cast<osmium::object_id_type>(tile_number) * RELATION_ID_STRIDE + 1),
+            m_tile_number(tile_number) {
+        }
+
+        Tile generate() {
+            add_streets();
+            const osmium::object_id_type place = add_place();
+            add_boundary(place);
+            add_landuse();
+            add_geometry_problems();
+            return std::move(m_tile);
+        }
+    };
+
+    struct Counts {
+        size_t nodes = 0;
+        size_t ways = 0;
+        size_t relations = 0;
+    };
+
+    const char* timestamp = "2026-01-01T00:00:00Z";
+
+    void add_tile(const Tile& tile, const osmium::item_type type, osmium::memory::Buffer& buffer, Counts& counts) {
+        using namespace osmium::builder::attr;
+        if (type == osmium::item_type::node) {
+            for (const GeneratedNode& node : tile.nodes) {
+                osmium::builder::add_node(buffer, _id(node.id), _version(1), _timestamp(timestamp), _location(node.location), _tags(node.tags));
+            }
+            counts.nodes += tile.nodes.size();
+        } else if (type == osmium::item_type::way) {
+            for (const GeneratedWay& way : tile.ways) {
+                osmium::builder::add_way(buffer, _id(way.id), _version(1), _timestamp(timestamp), _nodes(way.nodes), _tags(way.tags));
+            }
+            counts.ways += tile.ways.size();
+        } else {
+            for (const GeneratedRelation& relation : tile.relations) {
+                osmium::builder::add_relation(buffer, _id(relation.id), _version(1), _timestamp(timestamp), _members(relation.members), _tags(relation.tags));
+            }
+            counts.relations += tile.relations.size();
+        }
+    }
+
+    void print_help(const char* arg0) {
+        std::cerr << "Usage: " << arg0 << " [OPTIONS] OUTPUT_FILE\n" \
+                  << "Options:\n" \
+                  << "  -h, --help           This help message.\n" \
+                  << "  -n, --tiles=N        Number of tiles (default: 100)\n" \
+                  << "  -s, --seed=SEED      Seed of the random number generator (default: 1)\n";
+    }
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    static struct option long_options[] = {
+        {"help",   no_argument, 0, 'h'},
+        {"tiles", required_argument, 0, 'n'},
+        {"seed", required_argument, 0, 's'},
+        {0, 0, 0, 0}
+    };
+
+    size_t tiles = 100;
+    uint64_t seed = 1;
+    while (true) {
+        int c = getopt_long(argc, argv, "hn:s:", long_options, 0);
+        if (c == -1) {
+            break;
+        }
+        switch (c) {
+            case 'n':
+                tiles = static_cast<size_t>(std::strtoull(optarg, nullptr, 10));
+                break;
+            case 's':
+                seed = std::strtoull(optarg, nullptr, 10);
+                break;
+            default:
+                print_help(argv[0]);
+                exit(1);
+        }
+    }
+    if (argc - optind != 1 || tiles == 0) {
+        print_help(argv[0]);
+        exit(1);
+    }
+    const char* output_filename = argv[optind];
+
+    const Layout layout{tiles};
+    osmium::io::Header header;
+    header.set("generator", "osmi_generate_data");
+    header.set("osmi_generate_data_seed", std::to_string(seed));
+    header.set("osmi_generate_data_tiles", std::to_string(tiles));
+    header.add_box(layout.box(tiles));
+    osmium::io::Writer writer{output_filename, header, osmium::io::overwrite::allow};
+
+    // Objects have to be written sorted by type and ID. Therefore all tiles are generated once per
+    // object type. A tile is small and cheap to generate.
+    Counts counts;
+    for (const osmium::item_type type : {osmium::item_type::node, osmium::item_type::way, osmium::item_type::relation}) {
+        osmium::memory::Buffer buffer{BUFFER_SIZE + 1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+        for (size_t tile = 0; tile < tiles; ++tile) {
+            add_tile(TileGenerator{seed, tile, layout}.generate(), type, buffer, counts);
+            if (buffer.committed() >= BUFFER_SIZE) {
+                writer(std::move(buffer));
+                buffer = osmium::memory::Buffer{BUFFER_SIZE + 1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+            }
+        }
+        if (buffer.committed() > 0) {
+            writer(std::move(buffer));
+        }
+    }
+    writer.close();
+
+    struct stat file_info;
+    const long long size = stat(output_filename, &file_info) == 0 ? static_cast<long long>(file_info.st_size) : -1;
+    std::cerr << "Wrote " << counts.nodes << " nodes, " << counts.ways << " ways and " << counts.relations
+              << " relations of " << tiles << " tiles (" << size << " bytes) to " << output_filename << '\n';
+    return 0;
+}
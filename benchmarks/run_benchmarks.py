@@ -0,0 +1,247 @@
+#! /usr/bin/env python3
+#
+#  © 2026 Geofabrik GmbH
+#
+#  This file is part of osmi_simple_views.
+#
+#  osmi_simple_views is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  osmi_simple_views is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+
+"""
+End-to-end scaling benchmark of osmi_simple_views.
+
+Generates inputs of increasing size with osmi_generate_data (a "ladder" of tile counts) and runs
+every view on its own and all views together on each of them. For every run, the wall time, CPU
+time, peak resident set size, objects read per second and the output size of every layer are
+recorded.
+
+The results are compared with a baseline file written earlier with --update-baseline on the same
+machine. The script exits with status 1 if the throughput of any run dropped by more than the
+threshold. Without a baseline file, the results are printed only.
+
+Example:
+
+    run_benchmarks.py --binary src/osmi_simple_views \\
+        --generator benchmarks/osmi_generate_data \\
+        --ladder 100,1000,10000 --baseline baseline.json
+"""
+
+import argparse
+import json
+import os
+import platform
+import re
+import shutil
+import sqlite3
+import subprocess
+import sys
+import time
+
+VIEWS = ["tagging", "highways", "places", "geometry", "topology"]
+
+# Tables created by GDAL in SQLite output besides the layers
+SQLITE_METADATA_TABLES = {"geometry_columns", "spatial_ref_sys", "spatialite_history",
+                          "sqlite_sequence", "views_geometry_columns",
+                          "virts_geometry_columns", "geometry_columns_auth"}
+
+
+def generate_input(args, tiles):
+    """
+    Generate the input file for a rung of the ladder unless it exists already.
+
+    Returns the path of the file and the number of objects in it.
+    """
+    path = os.path.join(args.work_dir, "synthetic-{}-{}.osm.pbf".format(tiles, args.seed))
+    count_path = path + ".count"
+    if os.path.exists(path) and os.path.exists(count_path):
+        with open(count_path) as count_file:
+            return path, int(count_file.read())
+    result = subprocess.run([args.generator, "--tiles={}".format(tiles),
+                             "--seed={}".format(args.seed), path],
+                            stderr=subprocess.PIPE, universal_newlines=True, check=True)
+    match = re.search(r"Wrote (\d+) nodes, (\d+) ways and (\d+) relations", result.stderr)
+    if not match:
+        sys.stderr.write(result.stderr)
+        raise RuntimeError("Unexpected output of {}".format(args.generator))
+    objects = sum(int(n) for n in match.groups())
+    with open(count_path, "w") as count_file:
+        count_file.write(str(objects))
+    return path, objects
+
+
+def layer_sizes(output_directory):
+    """
+    Number of features and bytes of every layer in the output directory.
+
+    Layers of SQLite output are measured using the dbstat table of SQLite if it is available. For
+    other formats, the size of each output file is reported.
+    """
+    layers = {}
+    for filename in sorted(os.listdir(output_directory)):
+        path = os.path.join(output_directory, filename)
+        if not filename.endswith(".db"):
+            layers[filename] = {"features": None, "bytes": os.path.getsize(path)}
+            continue
+        view = filename[:-3]
+        connection = sqlite3.connect(path)
+        try:
+            tables = [row[0] for row in connection.execute(
+                "SELECT name FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%'")
+                if row[0] not in SQLITE_METADATA_TABLES and not row[0].startswith("idx_")]
+            for table in tables:
+                features = connection.execute('SELECT count(*) FROM "{}"'.format(table)).fetchone()[0]
+                try:
+                    size = connection.execute("SELECT sum(pgsize) FROM dbstat WHERE name = ?",
+                                              (table,)).fetchone()[0]
+                except sqlite3.OperationalError:
+                    # SQLite was compiled without SQLITE_ENABLE_DBSTAT_VTAB
+                    size = None
+                layers["{}/{}".format(view, table)] = {"features": features, "bytes": size}
+        finally:
+            connection.close()
+    return layers
+
+
+def run_once(args, input_file, views, output_directory):
+    """
+    Run osmi_simple_views once and measure it.
+    """
+    if os.path.exists(output_directory):
+        shutil.rmtree(output_directory)
+    os.makedirs(output_directory)
+    command = [args.binary, "-f", args.format]
+    for view in views:
+        command += ["-t", view]
+    command += [input_file, output_directory]
+    start = time.monotonic()
+    process = subprocess.Popen(command, stdout=subprocess.DEVNULL)
+    # wait4 returns the resource usage of this child only
+    _, status, usage = os.wait4(process.pid, 0)
+    wall = time.monotonic() - start
+    # tell Popen that the process has been reaped
+    process.returncode = status
+    if not os.WIFEXITED(status) or os.WEXITSTATUS(status) != 0:
+        raise RuntimeError("{} failed with status {}".format(" ".join(command), status))
+    return {
+        "wall_seconds": wall,
+        "cpu_seconds": usage.ru_utime + usage.ru_stime,
+        # kilobytes on Linux, bytes on macOS
+        "peak_rss_kb": usage.ru_maxrss if platform.system() != "Darwin" else usage.ru_maxrss // 1024,
+    }
+
+
+def run_configuration(args, input_file, objects, views, name):
+    """
+    Run a configuration several times and keep the run with the median wall time.
+    """
+    output_directory = os.path.join(args.work_dir, "output-" + name)
+    runs = [run_once(args, input_file, views, output_directory) for _ in range(args.repeat)]
+    runs.sort(key=lambda run: run["wall_seconds"])
+    result = runs[len(runs) // 2]
+    result["objects"] = objects
+    result["objects_per_second"] = objects / result["wall_seconds"]
+    result["layers"] = layer_sizes(output_directory)
+    shutil.rmtree(output_directory)
+    return result
+
+
+def compare(results, baseline, threshold):
+    """
+    Compare the throughput with the baseline.
+
+    Returns the list of regressions.
+    """
+    regressions = []
+    for key, result in sorted(results.items()):
+        if key not in baseline:
+            print("{:<28} no baseline".format(key))
+            continue
+        expected = baseline[key]["objects_per_second"]
+        ratio = result["objects_per_second"] / expected
+        print("{:<28} {:>12.0f} obj/s  baseline {:>12.0f} obj/s  {:+6.1f}%".format(
+            key, result["objects_per_second"], expected, (ratio - 1) * 100))
+        if ratio < 1 - threshold:
+            regressions.append(key)
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1],
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--binary", required=True, help="osmi_simple_views executable")
+    parser.add_argument("--generator", required=True, help="osmi_generate_data executable")
+    parser.add_argument("--work-dir", default="benchmark-data",
+                        help="directory for generated inputs and output (default: benchmark-data)")
+    parser.add_argument("--ladder", default="100,1000,10000",
+                        help="comma separated numbers of tiles of the inputs (default: 100,1000,10000)")
+    parser.add_argument("--seed", type=int, default=1, help="seed of the generator (default: 1)")
+    parser.add_argument("--repeat", type=int, default=3,
+                        help="runs per configuration, the median is kept (default: 3)")
+    parser.add_argument("--format", default="SQlite", help="output format (default: SQlite)")
+    parser.add_argument("--baseline", help="baseline JSON file")
+    parser.add_argument("--threshold", type=float, default=0.1,
+                        help="accepted drop of throughput as a fraction (default: 0.1)")
+    parser.add_argument("--update-baseline", action="store_true",
+                        help="write the results to the baseline file instead of comparing")
+    parser.add_argument("--results", help="write the results to this JSON file")
+    args = parser.parse_args()
+    if args.update_baseline and not args.baseline:
+        parser.error("--update-baseline requires --baseline")
+
+    os.makedirs(args.work_dir, exist_ok=True)
+    configurations = [(view, [view]) for view in VIEWS] + [("all", VIEWS)]
+    results = {}
+    for tiles in (int(t) for t in args.ladder.split(",")):
+        input_file, objects = generate_input(args, tiles)
+        for name, views in configurations:
+            key = "{}/{}".format(tiles, name)
+            results[key] = run_configuration(args, input_file, objects, views,
+                                             "{}-{}".format(tiles, name))
+            print("{:<28} {:8.2f} s wall {:8.2f} s CPU {:10d} kB RSS {:12.0f} obj/s".format(
+                key, results[key]["wall_seconds"], results[key]["cpu_seconds"],
+                results[key]["peak_rss_kb"], results[key]["objects_per_second"]), flush=True)
+
+    document = {
+        "machine": {"node": platform.node(), "system": platform.platform(),
+                    "processor": platform.processor(), "cpus": os.cpu_count()},
+        "seed": args.seed,
+        "results": results,
+    }
+    if args.results:
+        with open(args.results, "w") as results_file:
+            json.dump(document, results_file, indent=2, sort_keys=True)
+
+    if args.update_baseline:
+        with open(args.baseline, "w") as baseline_file:
+            json.dump(document, baseline_file, indent=2, sort_keys=True)
+        print("Baseline written to {}".format(args.baseline))
+        return 0
+    if not args.baseline or not os.path.exists(args.baseline):
+        print("No baseline to compare with. Run with --update-baseline to create one.")
+        return 0
+    with open(args.baseline) as baseline_file:
+        baseline = json.load(baseline_file)
+    if baseline.get("seed") != args.seed:
+        print("WARNING: baseline was created with seed {}".format(baseline.get("seed")))
+    if baseline.get("machine", {}).get("node") != platform.node():
+        print("WARNING: baseline was created on {}".format(baseline.get("machine", {}).get("node")))
+    regressions = compare(results, baseline["results"], args.threshold)
+    if regressions:
+        print("Throughput dropped by more than {:.0f}%: {}".format(args.threshold * 100,
+                                                                 ", ".join(regressions)))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
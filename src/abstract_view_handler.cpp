@@ -21,12 +21,17 @@
 
 #include <stdio.h>
 #include <unistd.h>
+#include <algorithm>
+#include <atomic>
 #include <locale>
+#include <thread>
 
-AbstractViewHandler::AbstractViewHandler(Options& options) :
+AbstractViewHandler::AbstractViewHandler(Options& options, gdalcpp::Dataset* shared_dataset /*= nullptr*/) :
         OGROutputBase(options),
         m_datasets(),
-        m_dataset_names() {
+        m_dataset_names(),
+        m_shared_dataset(shared_dataset),
+        m_own_tag_summary(MAX_FIELD_LENGTH) {
 }
 
 AbstractViewHandler::~AbstractViewHandler() {
@@ -48,12 +53,75 @@ bool case_insensitive_comp_left(const std::string& a, const std::string& b) {
 
 bool AbstractViewHandler::one_layer_per_datasource_only() {
     return case_insensitive_comp_left(m_options.output_format, "geojson")
-        || case_insensitive_comp_left(m_options.output_format, "esri shapefile");
+        || case_insensitive_comp_left(m_options.output_format, "esri shapefile")
+        || case_insensitive_comp_left(m_options.output_format, "flatgeobuf")
+        || case_insensitive_comp_left(m_options.output_format, "parquet");
+}
+
+bool AbstractViewHandler::use_default_layer_options() {
+    return case_insensitive_comp_left(m_options.output_format, "flatgeobuf")
+        || case_insensitive_comp_left(m_options.output_format, "parquet")
+        || (m_options.spatial_index && case_insensitive_comp_left(m_options.output_format, "sqlite"))
+        || (m_options.spatial_index && case_insensitive_comp_left(m_options.output_format, "gpkg"));
+}
+
+void AbstractViewHandler::build_spatial_index(gdalcpp::Dataset& dataset) {
+    TraceScope scope{m_options.tracer, "spatial index " + dataset.dataset_name(), "output"};
+    // The index can only be built on committed data.
+    dataset.disable_auto_transactions();
+    GDALDataset* gdal_dataset = dataset.get();
+    for (int i = 0; i < gdal_dataset->GetLayerCount(); ++i) {
+        OGRLayer* layer = gdal_dataset->GetLayer(i);
+        if (layer->GetGeomType() == wkbNone) {
+            continue;
+        }
+        std::string sql;
+        if (case_insensitive_comp_left(m_options.output_format, "sqlite")
+                || case_insensitive_comp_left(m_options.output_format, "esri shapefile")) {
+            sql = "CREATE SPATIAL INDEX ON ";
+            sql += layer->GetName();
+        } else if (case_insensitive_comp_left(m_options.output_format, "gpkg")) {
+            sql = "SELECT gpkgAddSpatialIndex('";
+            sql += layer->GetName();
+            sql += "', '";
+            sql += layer->GetGeometryColumn();
+            sql += "')";
+        } else {
+            // other formats build their index on their own or don't have one
+            return;
+        }
+        dataset.exec(sql);
+    }
+}
+
+void AbstractViewHandler::build_spatial_indexes() {
+    // Datasets are independent from each other. Index them in parallel.
+    std::atomic<size_t> next_dataset {0};
+    auto worker = [this, &next_dataset]() {
+        for (size_t i = next_dataset++; i < m_datasets.size(); i = next_dataset++) {
+            build_spatial_index(*m_datasets[i]);
+        }
+    };
+    const size_t thread_count = std::min<size_t>(m_datasets.size(),
+            std::max<size_t>(std::thread::hardware_concurrency(), 1));
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_count; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : threads) {
+        t.join();
+    }
 }
 
 void AbstractViewHandler::close_datasets() {
+    if (m_options.spatial_index) {
+        build_spatial_indexes();
+    }
     for (auto& d : m_datasets) {
         m_dataset_names.push_back(d->dataset_name());
+        // closing commits the last transaction
+        TraceScope scope{m_options.tracer, "close " + d->dataset_name(), "output"};
         d.reset();
     }
 }
@@ -63,11 +131,16 @@ std::string AbstractViewHandler::filename_suffix() {
         return ".json";
     } else if (case_insensitive_comp_left(m_options.output_format, "sqlite")) {
         return ".db";
+    } else if (case_insensitive_comp_left(m_options.output_format, "pmtiles")) {
+        return ".pmtiles";
+    } else if (case_insensitive_comp_left(m_options.output_format, "parquet")) {
+        return ".parquet";
     }
     return "";
 }
 
 void AbstractViewHandler::rename_output_files(const std::string& view_name) {
+    TraceScope scope{m_options.tracer, "rename " + view_name, "output"};
     if (m_dataset_names.size() == 1 && filename_suffix().length()) {
         // rename output file if there is one output dataset only
         std::string destination_name {m_options.output_directory};
@@ -111,43 +184,45 @@ bool AbstractViewHandler::all_nodes_valid(const osmium::WayNodeList& wnl) {
 }
 
 void AbstractViewHandler::ensure_writeable_dataset(const char* layer_name) {
+    if (m_shared_dataset) {
+        return;
+    }
     if (m_datasets.empty() || one_layer_per_datasource_only()) {
         std::string output_filename = m_options.output_directory;
         output_filename += '/';
         output_filename += layer_name;
+        if (case_insensitive_comp_left(m_options.output_format, "flatgeobuf")) {
+            // Without the suffix, the FlatGeobuf driver would create a directory.
+            output_filename += ".fgb";
+        }
         std::unique_ptr<gdalcpp::Dataset> ds {new gdalcpp::Dataset(m_options.output_format, output_filename, gdalcpp::SRS(m_options.srs), get_gdal_default_dataset_options())};
         m_datasets.push_back(std::move(ds));
-        m_datasets.back()->enable_auto_transactions(10000);
+        enable_transactions(*m_datasets.back());
     }
 }
 
 gdalcpp::Dataset* AbstractViewHandler::get_dataset_pointer(const char* layer_name) {
     ensure_writeable_dataset(layer_name);
+    if (m_shared_dataset) {
+        return m_shared_dataset;
+    }
     return m_datasets.back().get();
 }
 
 std::unique_ptr<gdalcpp::Layer> AbstractViewHandler::create_layer(const char* layer_name, OGRwkbGeometryType type,
         const std::vector<std::string>& options /*= {}*/) {
-    ensure_writeable_dataset(layer_name);
-    return std::unique_ptr<gdalcpp::Layer>{new gdalcpp::Layer(*(m_datasets.back()), layer_name, type, options)};
+    if (options.empty() && use_default_layer_options()) {
+        return std::unique_ptr<gdalcpp::Layer>{new gdalcpp::Layer(*get_dataset_pointer(layer_name), layer_name, type,
+                get_gdal_default_layer_options())};
+    }
+    return std::unique_ptr<gdalcpp::Layer>{new gdalcpp::Layer(*get_dataset_pointer(layer_name), layer_name, type, options)};
 }
 
-std::string AbstractViewHandler::tags_string(const osmium::TagList& tags, const char* not_include) {
-    std::string tag_str;
-    // only add tags to the tags string if their key and value are shorter than 50 characters
-    for (const osmium::Tag& t : tags) {
-        if (not_include && !strcmp(t.key(), not_include)) {
-            continue;
-        }
-        size_t add_length = strlen(t.key()) + strlen(t.value()) + 2;
-        if (add_length < 50 && tag_str.length() + add_length < MAX_FIELD_LENGTH) {
-            tag_str += t.key();
-            tag_str += '=';
-            tag_str += t.value();
-            tag_str += '|';
-        }
+const std::string& AbstractViewHandler::tags_string(const osmium::TagList& tags, const char* not_include) {
+    if (!m_shared_tag_summary) {
+        // Nobody tells us when the next object starts.
+        m_own_tag_summary.reset();
+        return m_own_tag_summary.get(tags, not_include);
     }
-    // remove last | from tag_str
-    tag_str.pop_back();
-    return tag_str;
+    return m_shared_tag_summary->get(tags, not_include);
 }
@@ -25,6 +25,7 @@
 #include <osmium/handler.hpp>
 #include <osmium/osm/way.hpp>
 #include "ogr_output_base.hpp"
+#include "tag_summary.hpp"
 
 class AbstractViewHandler : public osmium::handler::Handler, public OGROutputBase {
 
@@ -44,6 +45,27 @@ class AbstractViewHandler : public osmium::handler::Handler, public OGROutputBas
      */
     bool one_layer_per_datasource_only();
 
+    /**
+     * Return if layers created without explicit layer creation options should use the default layer
+     * creation options of the output format.
+     *
+     * This is the case for formats which need tuning for streaming output and if spatial indexes are
+     * built after all data has been written.
+     */
+    bool use_default_layer_options();
+
+    /**
+     * Build the spatial indexes of all layers of a dataset after all features have been written.
+     *
+     * Building the index from the complete table is much faster than updating it on every insert.
+     */
+    void build_spatial_index(gdalcpp::Dataset& dataset);
+
+    /**
+     * Build the spatial indexes of all datasets in parallel.
+     */
+    void build_spatial_indexes();
+
 protected:
 
     /// ORG dataset
@@ -57,6 +79,20 @@ protected:
      */
     std::vector<std::string> m_dataset_names;
 
+    /**
+     * Dataset shared with the other handlers (vector tile output). If it is set, the handler does not
+     * create datasets on its own and the owner of the shared dataset is responsible for closing it.
+     */
+    gdalcpp::Dataset* m_shared_dataset;
+
+    /**
+     * String of the tags of the current object shared with the other handlers. If it is not set,
+     * m_own_tag_summary is used and recomputed on every call of tags_string().
+     */
+    TagSummary* m_shared_tag_summary = nullptr;
+
+    TagSummary m_own_tag_summary;
+
     static constexpr double UPPER_LIMIT_LATITUDE = 90.0;
 
     /**
@@ -66,6 +102,9 @@ protected:
 
     void rename_output_files(const std::string& view_name);
 
+    /**
+     * Close all datasets. If requested by the user, spatial indexes are built before.
+     */
     void close_datasets();
 
     inline bool coordinates_valid(const osmium::Location location) {
@@ -77,6 +116,17 @@ protected:
 #endif
     }
 
+    /**
+     * Maximum absolute latitude of locations which can be written (exclusive), 0 = no limit
+     */
+    inline double latitude_limit() const {
+#ifdef ONLYMERCATOROUTPUT
+        return UPPER_LIMIT_LATITUDE;
+#else
+        return m_options.srs != 3857 ? 0 : UPPER_LIMIT_LATITUDE;
+#endif
+    }
+
     inline bool coordinates_valid(const osmium::Node& node) {
         return coordinates_valid(node.location());
     }
@@ -115,7 +165,12 @@ protected:
 public:
     AbstractViewHandler() = delete;
 
-    AbstractViewHandler(Options& options);
+    /**
+     * \param options program options
+     * \param shared_dataset dataset to write all layers to instead of creating own datasets
+     * (optional, ownership stays with the caller)
+     */
+    AbstractViewHandler(Options& options, gdalcpp::Dataset* shared_dataset = nullptr);
 
     /**
      * Add proper file name suffix to the output files. If there is one output dataset only,
@@ -133,6 +188,21 @@ public:
 
     virtual void area(const osmium::Area&) = 0;
 
+    /**
+     * Use a tag summary shared with the other handlers. The owner has to reset it before the next
+     * object is processed.
+     */
+    void share_tag_summary(TagSummary& summary) noexcept {
+        m_shared_tag_summary = &summary;
+    }
+
+    /**
+     * Number of datasets owned by this handler
+     */
+    size_t dataset_count() const noexcept {
+        return m_datasets.size();
+    }
+
     /**
      * Add a new dataset to the vector if the last one cannot be use for multiple layers
      */
@@ -143,6 +213,12 @@ public:
      */
     gdalcpp::Dataset* get_dataset_pointer(const char* layer_name);
 
+    /**
+     * Create a new layer.
+     *
+     * If no layer creation options are given, the default layer creation options of the output format
+     * may be used (see use_default_layer_options()).
+     */
     std::unique_ptr<gdalcpp::Layer> create_layer(const char* layer_name, OGRwkbGeometryType type, const std::vector<std::string>& options = {});
 
     template <size_t TKeyCount>
@@ -162,7 +238,9 @@ public:
             }
         }
         // remove last | from tag_str
-        tag_str.pop_back();
+        if (!tag_str.empty()) {
+            tag_str.pop_back();
+        }
         return tag_str;
     }
 
@@ -175,9 +253,9 @@ public:
      * \param not_include key whose value should not be included in the string of all tags.
      * If it is a null pointer, this check is skipped.
      *
-     * \returns string with the tags
+     * \returns string with the tags, valid until the next call
      */
-    std::string tags_string(const osmium::TagList& tags, const char* not_include);
+    const std::string& tags_string(const osmium::TagList& tags, const char* not_include);
 
     /**
      * Close all open layers and datasets.
@@ -22,7 +22,9 @@
 #include "tagging_view_handler.hpp"
 
 AnyRelationCollector::AnyRelationCollector(Options& options) :
-        OGROutputBase(options) { }
+        OGROutputBase(options),
+        m_member_ways(options.max_memory),
+        m_deferred_ways(options.max_memory) { }
 
 bool AnyRelationCollector::keep_relation(const osmium::Relation& relation) const {
     // whitelisted route=piste/ski/ferry because both can contain member ways without tags.
@@ -33,13 +35,71 @@ bool AnyRelationCollector::keep_relation(const osmium::Relation& relation) const
             || (relation.tags().has_tag("type", "route") && relation.tags().has_tag("route", "ferry"));
 }
 
-bool AnyRelationCollector::keep_member(const osmium::relations::RelationMeta&,
-        const osmium::RelationMember& member) const {
+bool AnyRelationCollector::keep_member(const osmium::RelationMember& member) const {
     return (member.type() == osmium::item_type::way);
 }
 
+void AnyRelationCollector::relation(const osmium::Relation& relation) {
+    // The relations are read in single-pass mode even if the tagging view is not produced.
+    if ((m_options.single_pass && !m_tagging_ways_without_tags) || !keep_relation(relation)) {
+        return;
+    }
+    for (const auto& member : relation.members()) {
+        if (keep_member(member)) {
+            m_member_ways.add(member.ref());
+        }
+    }
+}
+
+void AnyRelationCollector::prepare() {
+    m_member_ways.prepare();
+    m_options.verbose_output << "Member ways of relations: " << m_member_ways.size();
+    if (m_member_ways.spilled()) {
+        m_options.verbose_output << " (spilled to disk)";
+    }
+    m_options.verbose_output << '\n';
+}
+
+void AnyRelationCollector::way(const osmium::Way& way) {
+    // Tagged ways are never written, skip the lookup.
+    if (way.tags().size() > 0 || !m_tagging_ways_without_tags) {
+        return;
+    }
+    if (m_options.single_pass) {
+        // The relations follow the ways.
+        if (m_options.shard.owns(way)) {
+            m_deferred_ways.add(way);
+        }
+    } else if (!m_member_ways.contains(way.id())) {
+        way_not_in_any_relation(way);
+    }
+}
+
+void AnyRelationCollector::flush() {
+    if (!m_options.single_pass || !m_tagging_ways_without_tags) {
+        return;
+    }
+    prepare();
+    m_options.verbose_output << "Writing " << m_deferred_ways.size() << " deferred untagged ways";
+    if (m_deferred_ways.spilled()) {
+        m_options.verbose_output << " (spilled to disk)";
+    }
+    m_options.verbose_output << '\n';
+    m_deferred_ways.for_each([this](const osmium::Way& way) {
+        try {
+            if (!m_member_ways.contains(way.id())) {
+                way_not_in_any_relation(way);
+            }
+        } catch (osmium::invalid_location& err) {
+            m_options.verbose_output << err.what() << '\n';
+        }
+    });
+    m_deferred_ways.clear();
+}
+
 void AnyRelationCollector::way_not_in_any_relation(const osmium::Way& way) {
-    if (way.tags().size() > 0 || !m_tagging_ways_without_tags || !coordinates_valid(way.nodes())) {
+    if (way.tags().size() > 0 || !m_tagging_ways_without_tags || !m_options.shard.owns(way)
+            || !coordinates_valid(way.nodes())) {
         // m_tagging_ways_without_tags is empty if AnyRelationCollector was initialized but no tagging view should be produced
         return;
     }
@@ -48,14 +108,12 @@ void AnyRelationCollector::way_not_in_any_relation(const osmium::Way& way) {
         geometry =m_factory.create_linestring(way);
         gdalcpp::Feature feature(*(m_tagging_ways_without_tags.get()), std::move(geometry));
         TaggingViewHandler::set_basic_fields(feature, way, nullptr, nullptr);
-        feature.add_to_layer();
+        write_feature(feature, *m_tagging_ways_without_tags);
     } catch (osmium::geometry_error& err) {
         m_options.verbose_output << err.what() << "\n";
     }
 }
 
-void AnyRelationCollector::complete_relation(osmium::relations::RelationMeta&) {}
-
 void AnyRelationCollector::create_layer(gdalcpp::Dataset* dataset) {
     m_tagging_ways_without_tags =
             std::unique_ptr<gdalcpp::Layer>(new gdalcpp::Layer(*dataset, "tagging_ways_without_tags",
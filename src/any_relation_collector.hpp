@@ -22,14 +22,31 @@
 #define SRC_ANY_RELATION_COLLECTOR_HPP_
 
 #include <gdalcpp.hpp>
-#include <osmium/relations/collector.hpp>
+#include <osmium/handler.hpp>
+#include "deferred_ways.hpp"
+#include "member_id_store.hpp"
 #include "ogr_output_base.hpp"
 
-class AnyRelationCollector : public osmium::relations::Collector<AnyRelationCollector,
-true, true, true>, public OGROutputBase {
+/**
+ * Find untagged ways which are not member of any relation which may have untagged member ways.
+ *
+ * The relation pass only collects the IDs of the member ways of these relations because neither
+ * the relations nor their members are needed for anything else. The IDs are kept in a
+ * MemberIdStore which is spilled to disk if it exceeds the memory budget (--max-memory).
+ *
+ * In single-pass mode, the relations are read after the ways. Untagged ways are kept until the
+ * relations have been read and written when flush() is called.
+ */
+class AnyRelationCollector : public osmium::handler::Handler, public OGROutputBase {
 
     std::unique_ptr<gdalcpp::Layer> m_tagging_ways_without_tags;
 
+    /// IDs of member ways of all relations we are interested in
+    MemberIdStore m_member_ways;
+
+    /// untagged ways waiting for the relations (single-pass mode only)
+    DeferredWays m_deferred_ways;
+
     static constexpr double UPPER_LIMIT_LATITUDE = 90.0;
 
     inline bool coordinates_valid(const osmium::Location location) {
@@ -67,18 +84,43 @@ public:
     /**
      * Tells Osmium which members to keep for a relation of interest.
      */
-    bool keep_member(const osmium::relations::RelationMeta&, const osmium::RelationMember& member) const;
+    bool keep_member(const osmium::RelationMember& member) const;
+
+    /**
+     * Relation pass: Remember the member ways of the relations we are interested in.
+     */
+    void relation(const osmium::Relation& relation);
+
+    /**
+     * Finish the relation pass. This method has to be called before the way pass starts.
+     */
+    void prepare();
+
+    /**
+     * Way pass: Write untagged ways which are not member of any relation we are interested in.
+     *
+     * In single-pass mode, untagged ways are kept until flush() is called.
+     */
+    void way(const osmium::Way& way);
+
+    /**
+     * Single-pass mode: Write the untagged ways which are not member of any relation we are
+     * interested in after all relations have been read. Nothing is done otherwise.
+     */
+    void flush();
 
     /**
      * This method is called for all ways that are not a member of
      * any relation.
-     *
-     * Overwrite this method in a child class if you are interested
-     * in this.
      */
     void way_not_in_any_relation(const osmium::Way& way);
 
-    void complete_relation(osmium::relations::RelationMeta&);
+    /**
+     * Memory in bytes used for the member IDs and the ways kept in single-pass mode.
+     */
+    size_t used_memory() const noexcept {
+        return m_member_ways.used_memory() + m_deferred_ways.used_memory();
+    }
 
     /**
      * Assign the pointer pointing to a dataset.
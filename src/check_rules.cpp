@@ -0,0 +1,381 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "check_rules.hpp"
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+    const char* built_in_rules = R"RULES(# Check rules of osmi_simple_views
+#
+# Print them with --print-default-rules, modify them and use them with --rules=FILE.
+
+[highway_oneway]
+view = highways
+key = oneway
+layer = highway_oneway
+values = yes no -1
+
+[highway_maxspeed]
+view = highways
+key = maxspeed
+layer = highway_maxspeed
+number = integer (0,150]
+number = integer " mph" (0,112]
+values = " none" signals none walk
+values = AT:urban AT:rural AT:motorway
+values = CZ:urban
+values = DE:urban DE:rural DE:living_street DE:walk
+values = IT:urban IT:rural
+values = RO:urban RO:rural RO:trunk RO:motorway
+values = RU:urban RU:rural RU:living_street RU:motorway
+values = UA:urban UA:rural
+
+[highway_maxheight]
+view = highways
+key = maxheight
+layer = highway_maxheight
+values = none default physical
+number = real (0,)
+number = feet_inches (0,)
+
+[highway_maxlength]
+view = highways
+key = maxlength
+layer = highway_maxlength
+values = none default physical
+number = real (0,)
+number = feet_inches (0,)
+
+[highway_maxweight]
+view = highways
+key = maxweight
+layer = highway_maxweight
+values = unsigned
+number = real (0,90)
+number = integer " t" (0,90)
+number = integer " st" (0,81.646623)
+number = integer " lt" (0,91.44423)
+number = integer " kg" (0,90000)
+
+[highway_unknown_way]
+view = highways
+key = highway
+layer = highway_unknown_way
+values = motorway motorway_link trunk trunk_link primary primary_link
+values = secondary secondary_link tertiary tertiary_link
+values = residential living_street pedestrian unclassified service track
+values = path footway cycleway bridleway steps corridor elevator platform
+values = raceway bus_guideway emergency_bay road
+values = construction disused abandoned proposed razed no
+closed_values = services rest_area traffic_island
+
+[highway_unknown_node]
+view = highways
+object = node
+key = highway
+layer = highway_unknown_node
+values = bus_stop platform motorway_junction services rest_area checkpoint toll_gantry
+values = construction proposed turning_circle turning_loop mini_roundabout passing_place
+values = crossing traffic_signals stop give_way ford elevator
+values = street_lamp milestone speed_camera speed_display traffic_mirror
+values = emergency_access_point emergency_bay
+
+[place_type]
+view = places
+key = place
+values = continent country state region county municipality
+values = city town village hamlet isolated_dwelling farm
+values = suburb quarter neighbourhood subdivision square locality
+values = island islet sea ocean
+)RULES";
+
+    std::string trim(const std::string& str) {
+        const size_t begin = str.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) {
+            return "";
+        }
+        const size_t end = str.find_last_not_of(" \t\r");
+        return str.substr(begin, end - begin + 1);
+    }
+
+    /**
+     * Split a list of whitespace separated values. Values may be quoted with ".
+     */
+    std::vector<std::string> split_values(const std::string& str, const std::string& location) {
+        std::vector<std::string> values;
+        size_t pos = 0;
+        while (pos < str.size()) {
+            if (isspace(static_cast<unsigned char>(str[pos]))) {
+                ++pos;
+            } else if (str[pos] == '"') {
+                const size_t end = str.find('"', pos + 1);
+                if (end == std::string::npos) {
+                    throw CheckRulesError{location + ": missing closing quotation mark"};
+                }
+                values.push_back(str.substr(pos + 1, end - pos - 1));
+                pos = end + 1;
+            } else {
+                size_t end = pos;
+                while (end < str.size() && !isspace(static_cast<unsigned char>(str[end]))) {
+                    ++end;
+                }
+                values.push_back(str.substr(pos, end - pos));
+                pos = end;
+            }
+        }
+        return values;
+    }
+
+    void parse_bound(const std::string& str, double& bound, bool& has_bound, const std::string& location) {
+        const std::string bound_str = trim(str);
+        if (bound_str.empty()) {
+            has_bound = false;
+            return;
+        }
+        char* rest;
+        bound = std::strtod(bound_str.c_str(), &rest);
+        if (*rest || rest == bound_str.c_str()) {
+            throw CheckRulesError{location + ": invalid bound '" + bound_str + "'"};
+        }
+        has_bound = true;
+    }
+
+    /**
+     * Parse a range like (0,150] or [1,).
+     */
+    void parse_range(const std::string& str, CheckRule::NumberSpec& spec, const std::string& location) {
+        const size_t comma = str.find(',');
+        if (str.size() < 3 || comma == std::string::npos || (str.front() != '(' && str.front() != '[')
+                || (str.back() != ')' && str.back() != ']')) {
+            throw CheckRulesError{location + ": invalid range '" + str + "'"};
+        }
+        spec.min_inclusive = str.front() == '[';
+        spec.max_inclusive = str.back() == ']';
+        parse_bound(str.substr(1, comma - 1), spec.min, spec.has_min, location);
+        parse_bound(str.substr(comma + 1, str.size() - comma - 2), spec.max, spec.has_max, location);
+    }
+
+    bool is_range(const std::string& token) {
+        return !token.empty() && (token.front() == '(' || token.front() == '[');
+    }
+
+    CheckRule::NumberSpec parse_number_spec(const std::string& str, const std::string& location) {
+        CheckRule::NumberSpec spec;
+        std::vector<std::string> tokens = split_values(str, location);
+        if (tokens.empty() || tokens.size() > 3) {
+            throw CheckRulesError{location + ": number must be FORMAT [UNIT] [RANGE]"};
+        }
+        if (tokens[0] == "integer") {
+            spec.format = CheckRule::number_format::integer;
+        } else if (tokens[0] == "real") {
+            spec.format = CheckRule::number_format::real;
+        } else if (tokens[0] == "feet_inches") {
+            spec.format = CheckRule::number_format::feet_inches;
+        } else {
+            throw CheckRulesError{location + ": unknown number format '" + tokens[0] + "'"};
+        }
+        size_t next = 1;
+        if (next < tokens.size() && !is_range(tokens[next])) {
+            spec.unit = tokens[next++];
+        }
+        if (next < tokens.size()) {
+            if (!is_range(tokens[next])) {
+                throw CheckRulesError{location + ": number must be FORMAT [UNIT] [RANGE]"};
+            }
+            parse_range(tokens[next++], spec, location);
+        }
+        if (next < tokens.size()) {
+            throw CheckRulesError{location + ": number must be FORMAT [UNIT] [RANGE]"};
+        }
+        if (spec.format == CheckRule::number_format::feet_inches && !spec.unit.empty()) {
+            throw CheckRulesError{location + ": feet_inches does not take a unit"};
+        }
+        return spec;
+    }
+
+} // namespace
+
+void StringSet::insert(const std::string& str) {
+    if (contains(str.c_str())) {
+        return;
+    }
+    m_storage.push_back(str);
+    m_index.insert(m_storage.back().c_str());
+}
+
+bool CheckRule::NumberSpec::matches(const Quantity& quantity) const {
+    if (format == number_format::real) {
+        return quantity.has_real() && !strcmp(quantity.real_end, unit.c_str()) && in_range(quantity.real);
+    }
+    if (!quantity.has_integer()) {
+        return false;
+    }
+    if (format == number_format::integer) {
+        return !strcmp(quantity.integer_end, unit.c_str()) && in_range(quantity.integer);
+    }
+    // feet and inches
+    const char* rest = quantity.integer_end;
+    if (*rest != '\'' || !in_range(quantity.integer)) {
+        return false;
+    }
+    ++rest;
+    if (*rest >= '0' && *rest <= '9') {
+        const Quantity inches = Quantity::parse(rest);
+        return inches.real > 0 || *inches.real_end == '"';
+    }
+    return *rest == 0;
+}
+
+bool CheckRule::NumberSpec::matches(const char* value) const {
+    return matches(Quantity::parse(value));
+}
+
+bool CheckRule::accepts(const char* value, const bool closed /*= false*/) const {
+    if (values.contains(value)) {
+        return true;
+    }
+    if (closed && closed_values.contains(value)) {
+        return true;
+    }
+    if (numbers.empty()) {
+        return false;
+    }
+    // The value is read only once for all number specifications.
+    const Quantity quantity = Quantity::parse(value);
+    for (const NumberSpec& spec : numbers) {
+        if (spec.matches(quantity)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CheckTable::add(const CheckRule* rule) {
+    m_rules_by_key[rule->key.c_str()].push_back(rule);
+}
+
+const char* CheckRules::default_rules() {
+    return built_in_rules;
+}
+
+void CheckRules::load_file(const std::string& filename) {
+    std::ifstream input{filename};
+    if (!input) {
+        throw CheckRulesError{"Failed to open rules file " + filename};
+    }
+    parse(input, filename);
+}
+
+void CheckRules::load_string(const std::string& rules, const std::string& source /*= "default rules"*/) {
+    std::istringstream input{rules};
+    parse(input, source);
+}
+
+void CheckRules::parse(std::istream& input, const std::string& source) {
+    std::vector<std::unique_ptr<CheckRule>> rules;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(input, line)) {
+        ++line_number;
+        const std::string location = source + ":" + std::to_string(line_number);
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (line[0] == '[') {
+            if (line.back() != ']' || line.size() < 3) {
+                throw CheckRulesError{location + ": invalid section header"};
+            }
+            std::unique_ptr<CheckRule> rule{new CheckRule()};
+            rule->name = trim(line.substr(1, line.size() - 2));
+            for (const auto& r : rules) {
+                if (r->name == rule->name) {
+                    throw CheckRulesError{location + ": duplicate check " + rule->name};
+                }
+            }
+            rule->index = rules.size();
+            rules.push_back(std::move(rule));
+            continue;
+        }
+        const size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            throw CheckRulesError{location + ": expected FIELD = VALUE"};
+        }
+        if (rules.empty()) {
+            throw CheckRulesError{location + ": field outside of a section"};
+        }
+        CheckRule& rule = *rules.back();
+        const std::string field = trim(line.substr(0, equals));
+        const std::string value = trim(line.substr(equals + 1));
+        if (field == "view") {
+            rule.view = value;
+        } else if (field == "key") {
+            rule.key = value;
+        } else if (field == "layer") {
+            rule.layer = value;
+        } else if (field == "object") {
+            if (value == "node") {
+                rule.object = CheckRule::object_type::node;
+            } else if (value == "way") {
+                rule.object = CheckRule::object_type::way;
+            } else {
+                throw CheckRulesError{location + ": object must be node or way"};
+            }
+        } else if (field == "values" || field == "closed_values") {
+            StringSet& set = (field == "values") ? rule.values : rule.closed_values;
+            for (const std::string& v : split_values(value, location)) {
+                set.insert(v);
+            }
+        } else if (field == "number") {
+            rule.numbers.push_back(parse_number_spec(value, location));
+        } else {
+            throw CheckRulesError{location + ": unknown field '" + field + "'"};
+        }
+    }
+    for (const auto& rule : rules) {
+        if (rule->view.empty() || rule->key.empty()) {
+            throw CheckRulesError{source + ": check " + rule->name + " lacks view or key"};
+        }
+    }
+    m_rules = std::move(rules);
+}
+
+const CheckRule* CheckRules::find(const char* name) const {
+    for (const auto& rule : m_rules) {
+        if (rule->name == name) {
+            return rule.get();
+        }
+    }
+    return nullptr;
+}
+
+CheckTable CheckRules::table(const char* view, const CheckRule::object_type object) const {
+    CheckTable table;
+    for (const auto& rule : m_rules) {
+        if (rule->view == view && rule->object == object) {
+            table.add(rule.get());
+        }
+    }
+    return table;
+}
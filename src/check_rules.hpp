@@ -0,0 +1,298 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_CHECK_RULES_HPP_
+#define SRC_CHECK_RULES_HPP_
+
+#include <string.h>
+#include <deque>
+#include <istream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "quantity.hpp"
+
+/**
+ * Error in the checks of allowed tag values: a malformed rules file or a check a view cannot apply
+ */
+class CheckRulesError : public std::runtime_error {
+public:
+    explicit CheckRulesError(const std::string& what) :
+        std::runtime_error(what) {
+    }
+};
+
+/**
+ * FNV-1a hash of a null-terminated string
+ */
+struct CStringHash {
+    size_t operator()(const char* str) const noexcept {
+        size_t hash = 14695981039346656037ULL;
+        for (; *str; ++str) {
+            hash ^= static_cast<unsigned char>(*str);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+};
+
+struct CStringEqual {
+    bool operator()(const char* a, const char* b) const noexcept {
+        return !strcmp(a, b);
+    }
+};
+
+/**
+ * Hashed set of strings which can be queried with C strings without creating a temporary
+ * std::string.
+ */
+class StringSet {
+
+    /// owns the strings, its elements are never moved
+    std::deque<std::string> m_storage;
+
+    std::unordered_set<const char*, CStringHash, CStringEqual> m_index;
+
+public:
+    StringSet() = default;
+
+    StringSet(const StringSet&) = delete;
+    StringSet& operator=(const StringSet&) = delete;
+
+    void insert(const std::string& str);
+
+    bool contains(const char* str) const {
+        return m_index.find(str) != m_index.end();
+    }
+
+    size_t size() const noexcept {
+        return m_index.size();
+    }
+};
+
+/**
+ * A check of the value of a tag, e.g. "the value of maxspeed must be a number between 1 and
+ * 150 or one of the values RO:urban, RO:rural, …".
+ *
+ * A value is valid if it is one of the allowed values or matches one of the number
+ * specifications. Objects without the key always pass the check.
+ */
+struct CheckRule {
+
+    enum class object_type : char {
+        node = 0,
+        way = 1
+    };
+
+    enum class number_format : char {
+        /// integer followed by the unit
+        integer = 0,
+        /// decimal number followed by the unit
+        real = 1,
+        /// feet as integer followed by ', optionally followed by inches (e.g. 12'6")
+        feet_inches = 2
+    };
+
+    /**
+     * Allowed numbers. The unit has to follow the number directly (including any whitespace,
+     * e.g. " mph"). The number has to be inside the range.
+     */
+    struct NumberSpec {
+        number_format format = number_format::integer;
+        std::string unit;
+        double min = 0;
+        double max = 0;
+        bool has_min = false;
+        bool has_max = false;
+        bool min_inclusive = false;
+        bool max_inclusive = false;
+
+        bool in_range(const double number) const noexcept {
+            if (number != number) { // NaN
+                return false;
+            }
+            if (has_min && (number < min || (!min_inclusive && number == min))) {
+                return false;
+            }
+            if (has_max && (number > max || (!max_inclusive && number == max))) {
+                return false;
+            }
+            return true;
+        }
+
+        bool matches(const Quantity& quantity) const;
+
+        bool matches(const char* value) const;
+    };
+
+    /// name of the check (name of the section in the rules file)
+    std::string name;
+
+    /// view the check belongs to (highways, places)
+    std::string view;
+
+    /// type of the objects to be checked
+    object_type object = object_type::way;
+
+    /// key whose value is checked
+    std::string key;
+
+    /// output layer of objects failing the check (empty if the view decides)
+    std::string layer;
+
+    /// position of the check in the rule set
+    size_t index = 0;
+
+    StringSet values;
+
+    /// values allowed on closed ways only
+    StringSet closed_values;
+
+    std::vector<NumberSpec> numbers;
+
+    /**
+     * Check a value.
+     *
+     * \param value value of the tag
+     * \param closed true if the object is a closed way
+     *
+     * \returns true if the value is valid
+     */
+    bool accepts(const char* value, const bool closed = false) const;
+};
+
+/**
+ * Decision table of all checks of one view and object type. The checks are looked up by the
+ * keys of the tags of an object, i.e. the tags are scanned once for all checks.
+ */
+class CheckTable {
+
+    std::unordered_map<const char*, std::vector<const CheckRule*>, CStringHash, CStringEqual> m_rules_by_key;
+
+public:
+    /**
+     * Add a check. The rule has to outlive the table.
+     */
+    void add(const CheckRule* rule);
+
+    bool empty() const noexcept {
+        return m_rules_by_key.empty();
+    }
+
+    /**
+     * Run all checks on the tags of an object.
+     *
+     * \param tags tag list (e.g. osmium::TagList), its elements need key() and value()
+     * \param closed true if the object is a closed way
+     * \param failed failing checks are appended to this vector
+     */
+    template <typename TTags>
+    void evaluate(const TTags& tags, const bool closed, std::vector<const CheckRule*>& failed) const {
+        if (m_rules_by_key.empty()) {
+            return;
+        }
+        for (const auto& tag : tags) {
+            auto it = m_rules_by_key.find(tag.key());
+            if (it == m_rules_by_key.end()) {
+                continue;
+            }
+            for (const CheckRule* rule : it->second) {
+                if (!rule->accepts(tag.value(), closed)) {
+                    failed.push_back(rule);
+                }
+            }
+        }
+    }
+};
+
+/**
+ * Set of all checks whose definitions are read from a rules file at startup.
+ *
+ * The rules file consists of sections, one per check:
+ *
+ *     # comment
+ *     [highway_maxspeed]
+ *     view = highways
+ *     object = way
+ *     key = maxspeed
+ *     layer = highway_maxspeed
+ *     values = none signals "RO:urban"
+ *     number = integer (0,150]
+ *     number = integer " mph" (0,112]
+ *
+ * `values` and `closed_values` (values allowed on closed ways only) contain a whitespace separated
+ * list of values which may be quoted with ". They can be given multiple times. `number` has the
+ * format `FORMAT [UNIT] [RANGE]` where FORMAT is one of integer, real and feet_inches and RANGE
+ * is an interval like (0,150] with optional bounds.
+ */
+class CheckRules {
+
+    std::vector<std::unique_ptr<CheckRule>> m_rules;
+
+    void parse(std::istream& input, const std::string& source);
+
+public:
+    /**
+     * Rules reproducing the built-in checks
+     */
+    static const char* default_rules();
+
+    /**
+     * Replace the rules by the rules read from a file.
+     *
+     * \throws CheckRulesError if the file cannot be read or is malformed
+     */
+    void load_file(const std::string& filename);
+
+    /**
+     * Replace the rules by the rules in a string.
+     *
+     * \param rules content of a rules file
+     * \param source name of the source used in error messages
+     *
+     * \throws CheckRulesError if the rules are malformed
+     */
+    void load_string(const std::string& rules, const std::string& source = "default rules");
+
+    /**
+     * Get a check by its name.
+     *
+     * \returns pointer to the check or nullptr if it does not exist
+     */
+    const CheckRule* find(const char* name) const;
+
+    /**
+     * Build the decision table of all checks of a view for one type of objects.
+     */
+    CheckTable table(const char* view, const CheckRule::object_type object) const;
+
+    const std::vector<std::unique_ptr<CheckRule>>& rules() const noexcept {
+        return m_rules;
+    }
+
+    size_t size() const noexcept {
+        return m_rules.size();
+    }
+};
+
+#endif /* SRC_CHECK_RULES_HPP_ */
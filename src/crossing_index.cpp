@@ -0,0 +1,311 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "crossing_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <stdexcept>
+
+constexpr int32_t CrossingIndex::CELL_SIZE;
+
+namespace {
+
+    /// number of grid columns (longitude -180 to 180)
+    constexpr uint64_t GRID_COLUMNS = 3600000000ULL / CrossingIndex::CELL_SIZE + 1;
+
+    inline uint64_t column(const int32_t x) noexcept {
+        return static_cast<uint64_t>(static_cast<int64_t>(x) + 1800000000) / CrossingIndex::CELL_SIZE;
+    }
+
+    inline uint64_t row(const int32_t y) noexcept {
+        return static_cast<uint64_t>(static_cast<int64_t>(y) + 900000000) / CrossingIndex::CELL_SIZE;
+    }
+
+    /// number of grid rows (latitude -90 to 90)
+    constexpr uint64_t GRID_ROWS = 1800000000ULL / CrossingIndex::CELL_SIZE + 1;
+
+    /// x coordinate of the western border of a grid column
+    inline int64_t column_start(const uint64_t column) noexcept {
+        return static_cast<int64_t>(column * CrossingIndex::CELL_SIZE) - 1800000000;
+    }
+
+    inline int64_t floor_div(const int64_t numerator, const int64_t denominator) noexcept {
+        const int64_t quotient = numerator / denominator;
+        return (numerator % denominator != 0 && numerator < 0) ? quotient - 1 : quotient;
+    }
+
+    inline int64_t ceil_div(const int64_t numerator, const int64_t denominator) noexcept {
+        const int64_t quotient = numerator / denominator;
+        return (numerator % denominator != 0 && numerator > 0) ? quotient + 1 : quotient;
+    }
+
+    /**
+     * Call a function with the row and the column of every grid cell a segment passes through
+     * (grid traversal column by column).
+     *
+     * The part of the segment within a column is clipped at the borders of the column including
+     * the eastern one, and its y range is rounded outwards. Cells touched at their border are
+     * therefore included, i.e. every point of the segment is located in one of the cells.
+     */
+    template <typename TFunction>
+    void for_each_cell(osmium::Location a, osmium::Location b, TFunction&& function) {
+        if (a.x() > b.x()) {
+            std::swap(a, b);
+        }
+        const int64_t dx = static_cast<int64_t>(b.x()) - a.x();
+        const int64_t dy = static_cast<int64_t>(b.y()) - a.y();
+        const uint64_t last_column = column(b.x());
+        for (uint64_t c = column(a.x()); c <= last_column; ++c) {
+            int64_t min_y = std::min(a.y(), b.y());
+            int64_t max_y = std::max(a.y(), b.y());
+            if (dx != 0) {
+                // y coordinates of the segment where it enters and leaves the column (the
+                // products fit into 64 bits)
+                const int64_t x0 = std::max(static_cast<int64_t>(a.x()), column_start(c)) - a.x();
+                const int64_t x1 = std::min(static_cast<int64_t>(b.x()), column_start(c + 1)) - a.x();
+                min_y = a.y() + floor_div(std::min(x0 * dy, x1 * dy), dx);
+                max_y = a.y() + ceil_div(std::max(x0 * dy, x1 * dy), dx);
+            }
+            const uint64_t last_row = row(static_cast<int32_t>(max_y));
+            for (uint64_t r = row(static_cast<int32_t>(min_y)); r <= last_row; ++r) {
+                function(r, c);
+            }
+        }
+    }
+
+    /**
+     * Side of the line through a and b point c is located on: 1 = left, -1 = right, 0 = on the line
+     *
+     * The two products fit into 64-bit integers but their difference might not. Therefore they are
+     * compared instead of being subtracted.
+     */
+    inline int orientation(const osmium::Location a, const osmium::Location b, const osmium::Location c) noexcept {
+        const int64_t left = (static_cast<int64_t>(b.x()) - a.x()) * (static_cast<int64_t>(c.y()) - a.y());
+        const int64_t right = (static_cast<int64_t>(b.y()) - a.y()) * (static_cast<int64_t>(c.x()) - a.x());
+        return (left > right) - (left < right);
+    }
+
+    osmium::Location intersection(const osmium::Location a, const osmium::Location b, const osmium::Location c,
+            const osmium::Location d) {
+        const double abx = static_cast<double>(b.x()) - a.x();
+        const double aby = static_cast<double>(b.y()) - a.y();
+        const double cdx = static_cast<double>(d.x()) - c.x();
+        const double cdy = static_cast<double>(d.y()) - c.y();
+        const double t = ((static_cast<double>(c.x()) - a.x()) * cdy - (static_cast<double>(c.y()) - a.y()) * cdx)
+                / (abx * cdy - aby * cdx);
+        return osmium::Location{static_cast<int32_t>(std::lround(a.x() + t * abx)),
+                static_cast<int32_t>(std::lround(a.y() + t * aby))};
+    }
+
+    /**
+     * Segment of a cell with the values needed to test it against the other segments of the cell
+     */
+    struct CellSegment {
+        osmium::Location a;
+        osmium::Location b;
+        int32_t min_x;
+        int32_t min_y;
+        int32_t max_x;
+        int32_t max_y;
+        size_t way;
+    };
+
+} // anonymous namespace
+
+CrossingIndex::CrossingIndex() :
+    m_way_ids(),
+    m_first_location(1, 0),
+    m_layers(),
+    m_classes(),
+    m_locations() {
+}
+
+void CrossingIndex::add_way(const osmium::object_id_type id, const osmium::WayNodeList& nodes, const int8_t layer,
+        const uint16_t cls /*= 0*/) {
+    if (m_locations.size() + nodes.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error{"Too many locations for the crossing index"};
+    }
+    m_way_ids.push_back(id);
+    m_layers.push_back(layer);
+    m_classes.push_back(cls);
+    for (const osmium::NodeRef& nd_ref : nodes) {
+        m_locations.push_back(nd_ref.location());
+    }
+    m_first_location.push_back(static_cast<uint32_t>(m_locations.size()));
+}
+
+size_t CrossingIndex::way_of_location(const uint32_t location) const {
+    return static_cast<size_t>(std::upper_bound(m_first_location.begin(), m_first_location.end(), location)
+            - m_first_location.begin()) - 1;
+}
+
+void CrossingIndex::find_in_cells(const uint64_t* begin, const uint64_t* end, std::vector<Crossing>& crossings) const {
+    std::vector<CellSegment> segments;
+    while (begin != end) {
+        const uint64_t current_cell = *begin >> 32;
+        segments.clear();
+        for (; begin != end && (*begin >> 32) == current_cell; ++begin) {
+            const uint32_t first = static_cast<uint32_t>(*begin);
+            const osmium::Location a = m_locations[first];
+            const osmium::Location b = m_locations[first + 1];
+            segments.push_back(CellSegment{a, b, std::min(a.x(), b.x()), std::min(a.y(), b.y()),
+                std::max(a.x(), b.x()), std::max(a.y(), b.y()), way_of_location(first)});
+        }
+        for (size_t i = 0; i < segments.size(); ++i) {
+            const CellSegment& s1 = segments[i];
+            for (size_t j = i + 1; j < segments.size(); ++j) {
+                const CellSegment& s2 = segments[j];
+                if (s1.way == s2.way || m_layers[s1.way] != m_layers[s2.way]
+                        || s1.max_x < s2.min_x || s2.max_x < s1.min_x || s1.max_y < s2.min_y || s2.max_y < s1.min_y) {
+                    continue;
+                }
+                if (orientation(s1.a, s1.b, s2.a) * orientation(s1.a, s1.b, s2.b) >= 0
+                        || orientation(s2.a, s2.b, s1.a) * orientation(s2.a, s2.b, s1.b) >= 0) {
+                    continue;
+                }
+                crossings.push_back(Crossing{std::min(s1.way, s2.way), std::max(s1.way, s2.way),
+                    intersection(s1.a, s1.b, s2.a, s2.b)});
+            }
+        }
+    }
+}
+
+template <typename TFunction>
+void CrossingIndex::for_each_segment(TFunction&& function) const {
+    for (size_t way = 0; way < m_way_ids.size(); ++way) {
+        for (uint32_t i = m_first_location[way]; i + 1 < m_first_location[way + 1]; ++i) {
+            if (m_locations[i] != m_locations[i + 1]) {
+                function(i, m_locations[i], m_locations[i + 1]);
+            }
+        }
+    }
+}
+
+void CrossingIndex::find_in_registrations(const std::vector<uint64_t>& registrations, const unsigned int threads,
+        std::vector<Crossing>& crossings) const {
+    // Split the registrations into ranges of about equal size at cell borders.
+    const size_t thread_count = std::max(threads, 1u);
+    const uint64_t* const data = registrations.data();
+    const uint64_t* const end = data + registrations.size();
+    std::vector<const uint64_t*> borders;
+    borders.push_back(data);
+    for (size_t t = 1; t < thread_count; ++t) {
+        const uint64_t* border = std::max(data + registrations.size() * t / thread_count, borders.back());
+        if (border != end) {
+            // move to the first registration of the next cell
+            border = std::upper_bound(border, end, *border | 0xffffffffULL);
+        }
+        borders.push_back(border);
+    }
+    borders.push_back(end);
+
+    std::vector<std::vector<Crossing>> results(thread_count);
+    std::vector<std::future<void>> workers;
+    for (size_t t = 0; t < thread_count; ++t) {
+        const uint64_t* range_begin = borders[t];
+        const uint64_t* range_end = borders[t + 1];
+        std::vector<Crossing>* result = &results[t];
+        workers.push_back(std::async(std::launch::async, [this, range_begin, range_end, result]() {
+            find_in_cells(range_begin, range_end, *result);
+        }));
+    }
+    for (auto& w : workers) {
+        w.get();
+    }
+    for (const auto& result : results) {
+        crossings.insert(crossings.end(), result.begin(), result.end());
+    }
+}
+
+std::vector<CrossingIndex::Crossing> CrossingIndex::find_crossings(const unsigned int threads,
+        const size_t max_memory /*= 0*/) const {
+    // Count the registrations of each row of the grid and group the rows into batches whose
+    // registrations fit into the memory budget. A single row exceeding the budget forms a batch
+    // of its own.
+    std::vector<uint64_t> row_counts(GRID_ROWS, 0);
+    for_each_segment([&row_counts](const uint32_t, const osmium::Location a, const osmium::Location b) {
+        for_each_cell(a, b, [&row_counts](const uint64_t r, const uint64_t) {
+            ++row_counts[r];
+        });
+    });
+    const uint64_t max_registrations = max_memory / sizeof(uint64_t);
+    std::vector<uint64_t> batch_ends;
+    uint64_t batch_size = 0;
+    for (uint64_t r = 0; r < GRID_ROWS; ++r) {
+        if (max_registrations > 0 && batch_size > 0 && batch_size + row_counts[r] > max_registrations) {
+            batch_ends.push_back(r);
+            batch_size = 0;
+        }
+        batch_size += row_counts[r];
+    }
+    batch_ends.push_back(GRID_ROWS);
+
+    std::vector<Crossing> crossings;
+    std::vector<uint64_t> registrations;
+    uint64_t first_row = 0;
+    for (const uint64_t end_row : batch_ends) {
+        registrations.clear();
+        for_each_segment([&registrations, first_row, end_row](const uint32_t i, const osmium::Location a,
+                const osmium::Location b) {
+            if (row(std::max(a.y(), b.y())) < first_row || row(std::min(a.y(), b.y())) >= end_row) {
+                return;
+            }
+            for_each_cell(a, b, [&registrations, i, first_row, end_row](const uint64_t r, const uint64_t c) {
+                if (r >= first_row && r < end_row) {
+                    registrations.push_back(((r * GRID_COLUMNS + c) << 32) | i);
+                }
+            });
+        });
+        std::sort(registrations.begin(), registrations.end());
+        find_in_registrations(registrations, threads, crossings);
+        first_row = end_row;
+    }
+
+    // A crossing close to the border of a cell is found in all cells both segments touch.
+    std::sort(crossings.begin(), crossings.end(), [](const Crossing& lhs, const Crossing& rhs) {
+        if (lhs.way1 != rhs.way1) {
+            return lhs.way1 < rhs.way1;
+        }
+        if (lhs.way2 != rhs.way2) {
+            return lhs.way2 < rhs.way2;
+        }
+        return lhs.location < rhs.location;
+    });
+    crossings.erase(std::unique(crossings.begin(), crossings.end(), [](const Crossing& lhs, const Crossing& rhs) {
+            return lhs.way1 == rhs.way1 && lhs.way2 == rhs.way2 && lhs.location == rhs.location;
+        }), crossings.end());
+    return crossings;
+}
+
+size_t CrossingIndex::used_memory() const noexcept {
+    return m_way_ids.capacity() * sizeof(osmium::object_id_type) + m_first_location.capacity() * sizeof(uint32_t)
+            + m_layers.capacity() * sizeof(int8_t) + m_classes.capacity() * sizeof(uint16_t)
+            + m_locations.capacity() * sizeof(osmium::Location);
+}
+
+void CrossingIndex::clear() {
+    std::vector<osmium::object_id_type>{}.swap(m_way_ids);
+    std::vector<uint32_t>(1, 0).swap(m_first_location);
+    std::vector<int8_t>{}.swap(m_layers);
+    std::vector<uint16_t>{}.swap(m_classes);
+    std::vector<osmium::Location>{}.swap(m_locations);
+}
@@ -0,0 +1,161 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_CROSSING_INDEX_HPP_
+#define SRC_CROSSING_INDEX_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <osmium/osm/location.hpp>
+#include <osmium/osm/way.hpp>
+
+/**
+ * Spatial index of the segments of many ways to find segments of different ways crossing each
+ * other.
+ *
+ * The locations of all ways are kept in one array. When the crossings are searched, every segment
+ * is registered in the cells of a regular grid it passes through, i.e. the number of registrations
+ * grows with the length of a segment. The registrations are packed into 64-bit integers (cell
+ * number in the upper half, segment number in the lower half) and sorted, so the segments of each
+ * cell are adjacent in memory. The cells are split into ranges which are processed by several
+ * threads. If the registrations do not fit into the memory budget, the rows of the grid are
+ * processed in batches.
+ *
+ * Only proper crossings are reported, i.e. the segments intersect at a point which is not an end
+ * point of one of the segments. Ways sharing a node at their intersection or touching each other
+ * do not cross. A crossing found in several cells is reported once.
+ *
+ * The index can hold up to 2^32 locations.
+ */
+class CrossingIndex {
+
+public:
+    struct Crossing {
+        /// index of the first way (smaller than way2)
+        size_t way1;
+        size_t way2;
+        osmium::Location location;
+    };
+
+    /// width and height of a grid cell in units of osmium::Location (0.01 degrees)
+    static constexpr int32_t CELL_SIZE = 100000;
+
+private:
+    std::vector<osmium::object_id_type> m_way_ids;
+
+    /// index of the first location of each way in m_locations, followed by the number of locations
+    std::vector<uint32_t> m_first_location;
+
+    std::vector<int8_t> m_layers;
+
+    /// user defined value of each way
+    std::vector<uint16_t> m_classes;
+
+    std::vector<osmium::Location> m_locations;
+
+    /**
+     * Find the crossings in a range of sorted registrations whose ends are cell borders.
+     */
+    void find_in_cells(const uint64_t* begin, const uint64_t* end, std::vector<Crossing>& crossings) const;
+
+    /**
+     * Find the crossings in sorted registrations using several threads and append them to crossings.
+     */
+    void find_in_registrations(const std::vector<uint64_t>& registrations, const unsigned int threads,
+            std::vector<Crossing>& crossings) const;
+
+    /**
+     * Call a function with the index of the first location, the first and the second location of
+     * every segment (except segments of length 0).
+     */
+    template <typename TFunction>
+    void for_each_segment(TFunction&& function) const;
+
+    /**
+     * Index of the way a location belongs to.
+     */
+    size_t way_of_location(const uint32_t location) const;
+
+public:
+    CrossingIndex();
+
+    /**
+     * Add a way. The locations of all nodes have to be valid.
+     *
+     * \param id ID of the way
+     * \param nodes nodes of the way
+     * \param layer value of the layer tag, only ways on the same layer cross each other
+     * \param cls arbitrary value to be kept with the way (e.g. to look up its type later)
+     *
+     * \throws std::length_error if the index is full
+     */
+    void add_way(const osmium::object_id_type id, const osmium::WayNodeList& nodes, const int8_t layer,
+            const uint16_t cls = 0);
+
+    /**
+     * Find all crossings.
+     *
+     * \param threads number of threads processing the grid cells
+     * \param max_memory memory budget of the registrations of the segments in the grid cells in
+     *                   bytes, 0 = no limit
+     *
+     * \returns crossings sorted by way1, way2 and location
+     */
+    std::vector<Crossing> find_crossings(const unsigned int threads, const size_t max_memory = 0) const;
+
+    size_t size() const noexcept {
+        return m_way_ids.size();
+    }
+
+    osmium::object_id_type id(const size_t way) const {
+        return m_way_ids[way];
+    }
+
+    uint16_t cls(const size_t way) const {
+        return m_classes[way];
+    }
+
+    /**
+     * First location of a way
+     */
+    const osmium::Location* begin(const size_t way) const {
+        return m_locations.data() + m_first_location[way];
+    }
+
+    /**
+     * End of the locations of a way
+     */
+    const osmium::Location* end(const size_t way) const {
+        return m_locations.data() + m_first_location[way + 1];
+    }
+
+    /**
+     * Memory in bytes used by the ways (not including the registrations allocated during the search)
+     */
+    size_t used_memory() const noexcept;
+
+    /**
+     * Remove all ways and free the memory.
+     */
+    void clear();
+};
+
+#endif /* SRC_CROSSING_INDEX_HPP_ */
@@ -0,0 +1,101 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "deferred_ways.hpp"
+
+#include <cerrno>
+#include <system_error>
+
+constexpr size_t DeferredWays::CHUNK_SIZE;
+
+DeferredWays::DeferredWays(const size_t max_memory /*= 0*/) :
+    m_max_memory(max_memory),
+    m_chunks(),
+    m_current(CHUNK_SIZE, osmium::memory::Buffer::auto_grow::yes) {
+}
+
+DeferredWays::~DeferredWays() {
+    if (m_file) {
+        std::fclose(m_file);
+    }
+}
+
+void DeferredWays::add(const osmium::Way& way) {
+    // Start a new chunk instead of letting the current one grow. Only a way larger than a chunk
+    // grows the (otherwise empty) buffer.
+    if (m_current.committed() > 0 && m_current.capacity() - m_current.committed() < way.padded_size()) {
+        m_chunks.push_back(std::move(m_current));
+        m_current = osmium::memory::Buffer{CHUNK_SIZE, osmium::memory::Buffer::auto_grow::yes};
+        if (m_max_memory > 0 && used_memory() > m_max_memory) {
+            spill();
+        }
+    }
+    m_current.add_item(way);
+    m_current.commit();
+    ++m_count;
+}
+
+void DeferredWays::spill() {
+    if (!m_file) {
+        m_file = std::tmpfile();
+        if (!m_file) {
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary file"};
+        }
+    }
+    std::fseek(m_file, 0, SEEK_END);
+    for (const auto& chunk : m_chunks) {
+        const uint64_t size = chunk.committed();
+        if (std::fwrite(&size, sizeof(size), 1, m_file) != 1
+                || std::fwrite(chunk.data(), 1, chunk.committed(), m_file) != chunk.committed()) {
+            throw std::system_error{errno, std::system_category(), "Failed to write to temporary file"};
+        }
+    }
+    m_chunks.clear();
+}
+
+bool DeferredWays::read_chunk(std::unique_ptr<unsigned char[]>& data, size_t& size) {
+    uint64_t chunk_size = 0;
+    if (std::fread(&chunk_size, sizeof(chunk_size), 1, m_file) != 1) {
+        return false;
+    }
+    size = static_cast<size_t>(chunk_size);
+    data.reset(new unsigned char[size]);
+    if (std::fread(data.get(), 1, size, m_file) != size) {
+        throw std::system_error{errno, std::system_category(), "Failed to read from temporary file"};
+    }
+    return true;
+}
+
+void DeferredWays::clear() {
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+    m_chunks.clear();
+    m_current = osmium::memory::Buffer{CHUNK_SIZE, osmium::memory::Buffer::auto_grow::yes};
+    m_count = 0;
+}
+
+size_t DeferredWays::used_memory() const noexcept {
+    size_t memory = m_current.capacity();
+    for (const auto& chunk : m_chunks) {
+        memory += chunk.capacity();
+    }
+    return memory;
+}
@@ -0,0 +1,128 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_DEFERRED_WAYS_HPP_
+#define SRC_DEFERRED_WAYS_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/way.hpp>
+
+/**
+ * Copies of ways (including the locations of their nodes) whose processing has to wait until the
+ * relations have been read. This is used if the input can be read only once (single-pass mode).
+ *
+ * The ways are kept in buffers of CHUNK_SIZE bytes. If the buffers exceed the memory budget, they
+ * are written to a temporary file. The ways are handed back in the order they were added.
+ */
+class DeferredWays {
+
+    /// size of the buffers the ways are kept in, only a larger way gets a larger buffer
+    static constexpr size_t CHUNK_SIZE = 16 * 1024 * 1024;
+
+    /// memory budget in bytes, 0 = unlimited
+    size_t m_max_memory;
+
+    /// full buffers in memory
+    std::vector<osmium::memory::Buffer> m_chunks;
+
+    /// buffer ways are currently added to
+    osmium::memory::Buffer m_current;
+
+    /// buffers written to disk, each one as its size (uint64_t) followed by its content
+    FILE* m_file = nullptr;
+
+    size_t m_count = 0;
+
+    /**
+     * Write all full buffers to the temporary file.
+     */
+    void spill();
+
+    /**
+     * Read the next buffer from the temporary file.
+     *
+     * \returns false if the end of the file is reached
+     */
+    bool read_chunk(std::unique_ptr<unsigned char[]>& data, size_t& size);
+
+    template <typename TFunc>
+    static void for_each_in(const osmium::memory::Buffer& buffer, TFunc& func) {
+        for (auto it = buffer.cbegin<osmium::Way>(); it != buffer.cend<osmium::Way>(); ++it) {
+            func(*it);
+        }
+    }
+
+public:
+    /**
+     * \param max_memory memory budget in bytes, 0 = no limit
+     */
+    explicit DeferredWays(const size_t max_memory = 0);
+
+    DeferredWays(const DeferredWays&) = delete;
+    DeferredWays& operator=(const DeferredWays&) = delete;
+
+    ~DeferredWays();
+
+    void add(const osmium::Way& way);
+
+    /**
+     * Call a function for all ways in the order they were added.
+     */
+    template <typename TFunc>
+    void for_each(TFunc func) {
+        if (m_file) {
+            std::rewind(m_file);
+            std::unique_ptr<unsigned char[]> data;
+            size_t size = 0;
+            while (read_chunk(data, size)) {
+                const osmium::memory::Buffer chunk{data.get(), size};
+                for_each_in(chunk, func);
+            }
+        }
+        for (const auto& chunk : m_chunks) {
+            for_each_in(chunk, func);
+        }
+        for_each_in(m_current, func);
+    }
+
+    /**
+     * Remove all ways and free the memory.
+     */
+    void clear();
+
+    size_t size() const noexcept {
+        return m_count;
+    }
+
+    bool spilled() const noexcept {
+        return m_file != nullptr;
+    }
+
+    /**
+     * Memory in bytes used for ways kept in memory
+     */
+    size_t used_memory() const noexcept;
+};
+
+#endif /* SRC_DEFERRED_WAYS_HPP_ */
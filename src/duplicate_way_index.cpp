@@ -0,0 +1,252 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "duplicate_way_index.hpp"
+
+#include <algorithm>
+#include <new>
+
+constexpr size_t DuplicateWayIndex::WINDOW_NODES;
+constexpr size_t DuplicateWayIndex::WINNOWING_WINDOWS;
+constexpr size_t DuplicateWayIndex::MIN_OVERLAP_NODES;
+constexpr uint32_t DuplicateWayIndex::OTHER_WAY;
+
+namespace {
+
+    /// The slot is chosen by the lower 32 bits of the hash.
+    constexpr size_t MAX_TABLE_SIZE = 1ULL << 32;
+
+    constexpr size_t MIN_TABLE_SIZE = 1 << 10;
+
+    /// base of the polynomial hashes (odd, i.e. invertible modulo 2^64)
+    constexpr uint64_t BASE = 0x9e3779b97f4a7c15ULL;
+
+    constexpr uint64_t WAY_SEED = 0x243f6a8885a308d3ULL;
+    constexpr uint64_t RUN_SEED = 0x13198a2e03707344ULL;
+
+    /**
+     * Finalizer of MurmurHash3, spreads the bits of the input over the whole output.
+     */
+    inline uint64_t mix(uint64_t x) noexcept {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    /**
+     * Multiplicative inverse of an odd number modulo 2^64 (Newton's method, every step doubles the
+     * number of correct bits).
+     */
+    uint64_t inverse(const uint64_t x) noexcept {
+        uint64_t y = x;
+        for (int i = 0; i < 5; ++i) {
+            y *= 2 - x * y;
+        }
+        return y;
+    }
+
+    uint64_t power(uint64_t x, size_t n) noexcept {
+        uint64_t result = 1;
+        while (n-- > 0) {
+            result *= x;
+        }
+        return result;
+    }
+
+    /**
+     * Empty slots of the table are marked by fingerprint 0.
+     */
+    inline uint32_t non_zero(const uint32_t fingerprint) noexcept {
+        return fingerprint ? fingerprint : 1;
+    }
+
+} // anonymous namespace
+
+DuplicateWayIndex::DuplicateWayIndex(const size_t max_memory) :
+    m_table(),
+    m_table_size(std::max(MIN_TABLE_SIZE, std::min(MAX_TABLE_SIZE, max_memory / sizeof(Entry)))),
+    m_other_way_ids(),
+    m_mixed(),
+    m_run_hashes() {
+    // calloc() gets zeroed pages from the operating system which are not backed by memory until
+    // they are written to.
+    m_table.reset(static_cast<Entry*>(std::calloc(m_table_size, sizeof(Entry))));
+    if (!m_table) {
+        throw std::bad_alloc{};
+    }
+}
+
+uint32_t DuplicateWayIndex::way_number() const noexcept {
+    if (m_way_id > 0 && m_way_id < static_cast<osmium::object_id_type>(OTHER_WAY)) {
+        return static_cast<uint32_t>(m_way_id);
+    }
+    // The ID is added to m_other_way_ids with the first hash of the way.
+    return OTHER_WAY | static_cast<uint32_t>(m_other_way_ids.size());
+}
+
+osmium::object_id_type DuplicateWayIndex::way_id(const uint32_t way) const noexcept {
+    if (way & OTHER_WAY) {
+        return m_other_way_ids[way & ~OTHER_WAY];
+    }
+    return way;
+}
+
+uint32_t DuplicateWayIndex::find_or_insert(const uint64_t hash, const uint32_t way) {
+    Entry* table = m_table.get();
+    const uint32_t fingerprint = non_zero(static_cast<uint32_t>(hash >> 32));
+    // map the lower 32 bits to [0, m_table_size) without a division
+    size_t slot = static_cast<size_t>(((hash & 0xffffffffULL) * m_table_size) >> 32);
+    while (table[slot].fingerprint) {
+        if (table[slot].fingerprint == fingerprint) {
+            return table[slot].way;
+        }
+        if (++slot == m_table_size) {
+            slot = 0;
+        }
+    }
+    // Fill the table up to 3/4 of its slots.
+    if (m_full || (m_count + 1) * 4 > m_table_size * 3) {
+        m_full = true;
+        return way;
+    }
+    if ((way & OTHER_WAY) && (way & ~OTHER_WAY) == m_other_way_ids.size()) {
+        m_other_way_ids.push_back(m_way_id);
+    }
+    table[slot] = Entry{fingerprint, way};
+    ++m_count;
+    return way;
+}
+
+uint64_t DuplicateWayIndex::way_hash() const noexcept {
+    const size_t count = m_mixed.size();
+    uint64_t forward = 0;
+    uint64_t backward = 0;
+    if (count >= 3 && m_mixed.front() == m_mixed.back()) {
+        // Closed ways are hashed as a ring starting at the node with the smallest mixed ID. The
+        // last node (equal to the first one) is left out.
+        const size_t ring = count - 1;
+        const size_t start = std::min_element(m_mixed.begin(), m_mixed.end() - 1) - m_mixed.begin();
+        for (size_t i = 0; i < ring; ++i) {
+            forward = forward * BASE + m_mixed[(start + i) % ring];
+            backward = backward * BASE + m_mixed[(start + ring - i) % ring];
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            forward = forward * BASE + m_mixed[i];
+            backward = backward * BASE + m_mixed[count - 1 - i];
+        }
+    }
+    return mix(std::min(forward, backward) ^ mix(count + WAY_SEED));
+}
+
+void DuplicateWayIndex::compute_run_hashes(const uint64_t seed) {
+    static const uint64_t base_inverse = inverse(BASE);
+    static const uint64_t top = power(BASE, WINDOW_NODES - 1);
+    m_run_hashes.clear();
+    // forward: hash of the run, backward: hash of the reversed run
+    uint64_t forward = 0;
+    uint64_t backward = 0;
+    for (size_t i = 0; i < WINDOW_NODES; ++i) {
+        forward = forward * BASE + m_mixed[i];
+        backward += m_mixed[i] * power(BASE, i);
+    }
+    for (size_t start = 0; ; ++start) {
+        m_run_hashes.push_back(mix(std::min(forward, backward) ^ seed));
+        const size_t next = start + WINDOW_NODES;
+        if (next == m_mixed.size()) {
+            break;
+        }
+        forward = (forward - m_mixed[start] * top) * BASE + m_mixed[next];
+        backward = (backward - m_mixed[start]) * base_inverse + m_mixed[next] * top;
+    }
+}
+
+osmium::object_id_type DuplicateWayIndex::add_way(const osmium::object_id_type id, const osmium::WayNodeList& nodes,
+        const uint32_t category, std::vector<Overlap>& overlaps) {
+    overlaps.clear();
+    if (!m_table) {
+        return 0;
+    }
+    m_way_id = id;
+    const uint32_t way = way_number();
+    m_mixed.clear();
+    for (const osmium::NodeRef& node_ref : nodes) {
+        m_mixed.push_back(mix(static_cast<uint64_t>(node_ref.ref())));
+    }
+    if (m_mixed.empty()) {
+        return 0;
+    }
+    const uint32_t duplicate_of = find_or_insert(way_hash(), way);
+    if (duplicate_of != way) {
+        return way_id(duplicate_of);
+    }
+    if (category == 0 || m_mixed.size() < MIN_OVERLAP_NODES) {
+        return 0;
+    }
+    compute_run_hashes(mix(category + RUN_SEED));
+    // Winnowing: take the smallest hash (the last one if there are several) of every
+    // WINNOWING_WINDOWS consecutive runs.
+    size_t last_sample = m_run_hashes.size();
+    for (size_t block = 0; block + WINNOWING_WINDOWS <= m_run_hashes.size(); ++block) {
+        size_t sample = block;
+        for (size_t i = block + 1; i < block + WINNOWING_WINDOWS; ++i) {
+            if (m_run_hashes[i] <= m_run_hashes[sample]) {
+                sample = i;
+            }
+        }
+        if (sample == last_sample) {
+            continue;
+        }
+        last_sample = sample;
+        const uint32_t other_way = find_or_insert(m_run_hashes[sample], way);
+        if (other_way == way) {
+            continue;
+        }
+        const osmium::object_id_type other = way_id(other_way);
+        // Within a shared part, the samples are at most WINNOWING_WINDOWS runs apart. A larger
+        // gap starts a new shared part.
+        auto it = std::find_if(overlaps.rbegin(), overlaps.rend(), [other](const Overlap& overlap) {
+                return overlap.other == other;
+            });
+        if (it != overlaps.rend() && sample - (it->last + 1 - WINDOW_NODES) <= WINNOWING_WINDOWS) {
+            it->last = sample + WINDOW_NODES - 1;
+        } else {
+            overlaps.push_back(Overlap{other, sample, sample + WINDOW_NODES - 1});
+        }
+    }
+    return 0;
+}
+
+size_t DuplicateWayIndex::used_memory() const noexcept {
+    return m_table_size * sizeof(Entry) + m_other_way_ids.capacity() * sizeof(osmium::object_id_type)
+        + (m_mixed.capacity() + m_run_hashes.capacity()) * sizeof(uint64_t);
+}
+
+void DuplicateWayIndex::clear() {
+    m_table.reset();
+    m_table_size = 0;
+    std::vector<osmium::object_id_type>{}.swap(m_other_way_ids);
+    std::vector<uint64_t>{}.swap(m_mixed);
+    std::vector<uint64_t>{}.swap(m_run_hashes);
+    m_count = 0;
+    m_full = true;
+}
@@ -0,0 +1,191 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_DUPLICATE_WAY_INDEX_HPP_
+#define SRC_DUPLICATE_WAY_INDEX_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <osmium/osm/types.hpp>
+#include <osmium/osm/way.hpp>
+
+/**
+ * Finds ways with the same nodes as an earlier way (in the same or reverse order, closed ways
+ * may start at any of their nodes) and ways sharing a run of consecutive nodes with an earlier way
+ * in a single pass over the ways.
+ *
+ * Only hashes of node ID sequences are kept: one per way and a sample of the hashes of its runs of
+ * WINDOW_NODES consecutive nodes. The hashes of the runs are computed as rolling polynomial hashes
+ * in both directions at once. The samples are chosen by winnowing (the smallest hash of every
+ * WINNOWING_WINDOWS consecutive runs), which guarantees that two ways sharing at least
+ * MIN_OVERLAP_NODES consecutive nodes have a sample in common.
+ *
+ * The hashes are stored in an open-addressing table of 8 bytes per entry: the upper 32 bits of
+ * the hash as fingerprint (the lower 32 bits select the slot) and the way as 32-bit number. Way
+ * IDs from 1 to 2^31 - 1 are stored as they are, other IDs are remapped to an index in a separate
+ * list. Only the fingerprints are compared, i.e. false matches are possible but rare.
+ *
+ * The table is allocated once with the size of the memory budget. The memory is zeroed lazily by
+ * the operating system, i.e. pages of the table count as used once the first entry is written to
+ * them. If three quarters of the slots are used, hashes of further ways are looked up but not
+ * stored any more.
+ */
+class DuplicateWayIndex {
+
+public:
+    /// number of consecutive nodes of a run
+    static constexpr size_t WINDOW_NODES = 6;
+    /// number of consecutive runs one sample is taken from
+    static constexpr size_t WINNOWING_WINDOWS = 7;
+    /// overlaps of this number of nodes or more are always found
+    static constexpr size_t MIN_OVERLAP_NODES = WINDOW_NODES + WINNOWING_WINDOWS - 1;
+
+    /**
+     * Contiguous part of the current way shared with an earlier way.
+     *
+     * Only the sampled runs are compared, so first and last are approximate: the shared part may
+     * reach up to WINNOWING_WINDOWS - 1 nodes further at either end. Matching samples more than
+     * WINNOWING_WINDOWS runs apart belong to separate shared parts.
+     */
+    struct Overlap {
+        /// ID of the earlier way
+        osmium::object_id_type other;
+        /// index of the first node of the first and the last node of the last shared sampled run
+        size_t first;
+        size_t last;
+    };
+
+private:
+    /// set in the way number of an entry if the number is an index in m_other_way_ids
+    static constexpr uint32_t OTHER_WAY = 1U << 31;
+
+    struct Entry {
+        /// upper 32 bits of the hash, 0 marks an empty slot
+        uint32_t fingerprint;
+        /// way ID or OTHER_WAY and the index in m_other_way_ids
+        uint32_t way;
+    };
+
+    /// releases the table allocated with std::calloc()
+    struct free_deleter {
+        void operator()(Entry* table) const noexcept {
+            std::free(table);
+        }
+    };
+
+    std::unique_ptr<Entry, free_deleter> m_table;
+
+    /// number of slots of the table
+    size_t m_table_size = 0;
+
+    /// IDs of the ways which do not fit in 31 bits (negative IDs for example)
+    std::vector<osmium::object_id_type> m_other_way_ids;
+
+    /// ID of the current way
+    osmium::object_id_type m_way_id = 0;
+
+    size_t m_count = 0;
+
+    bool m_full = false;
+
+    /// mixed node IDs of the current way
+    std::vector<uint64_t> m_mixed;
+
+    /// hashes of the runs of the current way
+    std::vector<uint64_t> m_run_hashes;
+
+    /**
+     * Look up a hash and add it for the current way if it is not in the table yet (and the table
+     * is not full).
+     *
+     * \param way number of the current way (as returned by way_number())
+     *
+     * \returns number of the way the hash was added with earlier, way if the hash is new
+     */
+    uint32_t find_or_insert(const uint64_t hash, const uint32_t way);
+
+    /**
+     * Number of the current way stored in the entries of the table.
+     */
+    uint32_t way_number() const noexcept;
+
+    /**
+     * ID of the way with the given number.
+     */
+    osmium::object_id_type way_id(const uint32_t way) const noexcept;
+
+    /**
+     * Hash of the whole way independent of its direction (and the first node of closed ways).
+     */
+    uint64_t way_hash() const noexcept;
+
+    /**
+     * Compute the hashes of all runs of WINDOW_NODES nodes of the current way.
+     */
+    void compute_run_hashes(const uint64_t seed);
+
+public:
+    /**
+     * \param max_memory memory budget of the hash table in bytes
+     */
+    explicit DuplicateWayIndex(const size_t max_memory);
+
+    /**
+     * Check a way against the ways added before and add it.
+     *
+     * \param id ID of the way
+     * \param nodes nodes of the way
+     * \param category ways share runs of nodes with ways of the same category only, 0 disables the
+     *                 search for shared runs of nodes of this way
+     * \param overlaps set to the parts of this way sharing at least one run of WINDOW_NODES nodes
+     *                 with an earlier way (one entry per contiguous shared part), empty if the way
+     *                 is a duplicate
+     *
+     * \returns ID of an earlier way with the same nodes, 0 if there is none
+     */
+    osmium::object_id_type add_way(const osmium::object_id_type id, const osmium::WayNodeList& nodes,
+            const uint32_t category, std::vector<Overlap>& overlaps);
+
+    /**
+     * Number of hashes in the table
+     */
+    size_t size() const noexcept {
+        return m_count;
+    }
+
+    /**
+     * Has the memory budget been reached (or has the index been cleared)?
+     */
+    bool full() const noexcept {
+        return m_full;
+    }
+
+    size_t used_memory() const noexcept;
+
+    /**
+     * Remove all ways and free the memory. No ways are stored afterwards.
+     */
+    void clear();
+};
+
+#endif /* SRC_DUPLICATE_WAY_INDEX_HPP_ */
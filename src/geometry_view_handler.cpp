@@ -26,11 +26,11 @@
 
 #include "geometry_view_handler.hpp"
 
+#include <cstring>
 #include <vector>
-#include <osmium/geom/haversine.hpp>
 
-GeometryViewHandler::GeometryViewHandler(Options& options) :
-        AbstractViewHandler(options),
+GeometryViewHandler::GeometryViewHandler(Options& options, gdalcpp::Dataset* shared_dataset /*= nullptr*/) :
+        AbstractViewHandler(options, shared_dataset),
         m_geometry_long_ways(create_layer("geometry_long_ways", wkbLineString, get_gdal_default_layer_options())),
         m_geometry_long_seg_seg(create_layer("geometry_long_seg_seg", wkbLineString, get_gdal_default_layer_options())),
         m_geometry_long_seg_way(create_layer("geometry_long_seg_way", wkbLineString, get_gdal_default_layer_options())),
@@ -38,7 +38,11 @@ GeometryViewHandler::GeometryViewHandler(Options& options) :
         m_geometry_duplicate_node_in_way_way(create_layer("geometry_duplicate_node_in_way_way", wkbLineString, get_gdal_default_layer_options())),
         m_geometry_duplicate_node_in_way_node(create_layer("geometry_duplicate_node_in_way_node", wkbPoint, get_gdal_default_layer_options())),
         m_geometry_self_intersection_ways(create_layer("geometry_self_intersection_ways", wkbLineString, get_gdal_default_layer_options())),
-        m_geometry_self_intersection_points(create_layer("geometry_self_intersection_points", wkbPoint, get_gdal_default_layer_options())) {
+        m_geometry_self_intersection_points(create_layer("geometry_self_intersection_points", wkbPoint, get_gdal_default_layer_options())),
+        m_geometry_duplicate_ways_way(create_layer("geometry_duplicate_ways_way", wkbLineString, get_gdal_default_layer_options())),
+        m_geometry_duplicate_ways_overlap(create_layer("geometry_duplicate_ways_overlap", wkbLineString, get_gdal_default_layer_options())),
+        m_duplicate_ways(options.duplicate_ways_max_memory),
+        m_overlaps() {
     // add fields to layers
     m_geometry_long_ways->add_field("way_id", OFTString, 10);
     m_geometry_long_ways->add_field("lastchange", OFTString, 21);
@@ -73,29 +77,24 @@ GeometryViewHandler::GeometryViewHandler(Options& options) :
     m_geometry_self_intersection_points->add_field("node_id", OFTString, 10);
     m_geometry_self_intersection_points->add_field("way_id", OFTString, 10);
     m_geometry_self_intersection_points->add_field("rel_id", OFTString, 10); // TODO why?
+    // ways with the same nodes as another way
+    m_geometry_duplicate_ways_way->add_field("way_id", OFTString, 10);
+    m_geometry_duplicate_ways_way->add_field("other_way_id", OFTString, 10);
+    m_geometry_duplicate_ways_way->add_field("tags", OFTString, MAX_FIELD_LENGTH);
+    m_geometry_duplicate_ways_way->add_field("lastchange", OFTString, 21);
+    // parts of ways sharing nodes with another way
+    m_geometry_duplicate_ways_overlap->add_field("way_id", OFTString, 10);
+    m_geometry_duplicate_ways_overlap->add_field("other_way_id", OFTString, 10);
+    // number of nodes covered by the shared sampled runs (approximate, see DuplicateWayIndex::Overlap)
+    m_geometry_duplicate_ways_overlap->add_field("est_nodes", OFTInteger, 7);
+    m_geometry_duplicate_ways_overlap->add_field("tags", OFTString, MAX_FIELD_LENGTH);
+    m_geometry_duplicate_ways_overlap->add_field("lastchange", OFTString, 21);
 }
 
 void GeometryViewHandler::give_correct_name() {
     rename_output_files("geometry");
 }
 
-std::string GeometryViewHandler::tags_string(const osmium::TagList& tags) {
-    std::string tag_str;
-    // only add tags to the tags string if their key and value are shorter than 50 characters
-    for (const osmium::Tag& t : tags) {
-        size_t add_length = strlen(t.key()) + strlen(t.value()) + 2;
-        if (add_length < 50 && tag_str.length() + add_length < MAX_FIELD_LENGTH) {
-            tag_str += t.key();
-            tag_str += '=';
-            tag_str += t.value();
-            tag_str += '|';
-        }
-    }
-    // remove last | from tag_str
-    tag_str.pop_back();
-    return tag_str;
-}
-
 void GeometryViewHandler::handle_way_many_nodes(const osmium::Way& way) {
     gdalcpp::Feature feature(*m_geometry_long_ways, m_factory.create_linestring(way));
     static char idbuffer[20];
@@ -104,8 +103,8 @@ void GeometryViewHandler::handle_way_many_nodes(const osmium::Way& way) {
     feature.set_field("length", static_cast<int>(way.nodes().size()));
     std::string the_timestamp (way.timestamp().to_iso());
     feature.set_field("lastchange", the_timestamp.c_str());
-    feature.set_field("tags", tags_string(way.tags()).c_str());
-    feature.add_to_layer();
+    feature.set_field("tags", tags_string(way.tags(), nullptr).c_str());
+    write_feature(feature, *m_geometry_long_ways);
 }
 
 std::unique_ptr<OGRGeometry> GeometryViewHandler::build_linestring_from_segment(osmium::WayNodeList::const_iterator start,
@@ -117,15 +116,12 @@ std::unique_ptr<OGRGeometry> GeometryViewHandler::build_linestring_from_segment(
 
 bool GeometryViewHandler::check_segments_length(const osmium::Way& way) {
     bool long_segment = false;
-    for (osmium::WayNodeList::const_iterator it = way.nodes().cbegin();
-            it != (way.nodes().cend() - 1); ++it) {
-        if (!(it->location().valid()) || !((it + 1)->location().valid())) {
-            continue;
-        }
-        double length = osmium::geom::haversine::distance(it->location(), (it + 1)->location());
+    for (size_t i = 0; i < m_segments.segment_count(); ++i) {
+        const double length = m_segments.length(i);
         // 0.3 degree is about 21 km near 49.0° N
         if (length > 20000) {
             long_segment = true;
+            osmium::WayNodeList::const_iterator it = way.nodes().cbegin() + i;
             // build_linestring_from_segment(osmium::WayNodeList::const_iterator, osmium::WayNodeList::const_iterator)
             // has to be called with it+2 as second argument because this will be used as it != end in a for loop.
             gdalcpp::Feature feature(*m_geometry_long_seg_seg, build_linestring_from_segment(it, (it + 2)));
@@ -135,7 +131,7 @@ bool GeometryViewHandler::check_segments_length(const osmium::Way& way) {
             feature.set_field("length", static_cast<int>(length));
             std::string the_timestamp (way.timestamp().to_iso());
             feature.set_field("lastchange", the_timestamp.c_str());
-            feature.add_to_layer();
+            write_feature(feature, *m_geometry_long_seg_seg);
         }
     }
     return long_segment;
@@ -147,10 +143,10 @@ void GeometryViewHandler::handle_long_segments(const osmium::Way& way) {
         static char idbuffer[20];
         sprintf(idbuffer, "%ld", way.id());
         feature.set_field("way_id", idbuffer);
-        feature.set_field("tags", tags_string(way.tags()).c_str());
+        feature.set_field("tags", tags_string(way.tags(), nullptr).c_str());
         std::string the_timestamp (way.timestamp().to_iso());
         feature.set_field("lastchange", the_timestamp.c_str());
-        feature.add_to_layer();
+        write_feature(feature, *m_geometry_long_seg_way);
     }
 }
 
@@ -162,22 +158,18 @@ void GeometryViewHandler::single_node_in_way(const osmium::Way& way) {
     static char idbuffer2[20];
     sprintf(idbuffer2, "%ld", way.nodes().front().ref());
     feature.set_field("node_id", idbuffer2);
-    feature.set_field("tags", tags_string(way.tags()).c_str());
+    feature.set_field("tags", tags_string(way.tags(), nullptr).c_str());
     std::string the_timestamp (way.timestamp().to_iso());
     feature.set_field("lastchange", the_timestamp.c_str());
-    feature.add_to_layer();
+    write_feature(feature, *m_geometry_single_node_in_way);
 }
 
 void GeometryViewHandler::duplicated_node_in_way(const osmium::Way& way) {
     // prevent that a way with duplicates is written twice
     bool multiple_errors = false;
-    for (osmium::WayNodeList::const_iterator it = way.nodes().cbegin(); it != way.nodes().cend() - 1;
-            ++it) {
-        osmium::WayNodeList::const_iterator next = it + 1;
-        if (!(it->location().valid()) || !(next->location().valid())) {
-            continue;
-        }
-        if (it->ref() == next->ref() || (it->lat() == next->lat() && it->lon() == next->lon())) {
+    for (size_t i = 0; i < m_segments.segment_count(); ++i) {
+        if (m_segments.duplicate(i)) {
+            osmium::WayNodeList::const_iterator it = way.nodes().cbegin() + i;
             gdalcpp::Feature feature(*m_geometry_duplicate_node_in_way_node, m_factory.create_point(*it));
             static char idbuffer[20];
             sprintf(idbuffer, "%ld", way.id());
@@ -187,15 +179,15 @@ void GeometryViewHandler::duplicated_node_in_way(const osmium::Way& way) {
             feature.set_field("node_id", idbuffer2);
             std::string the_timestamp (way.timestamp().to_iso());
             feature.set_field("lastchange", the_timestamp.c_str());
-            feature.add_to_layer();
+            write_feature(feature, *m_geometry_duplicate_node_in_way_node);
             if (!multiple_errors) {
                 gdalcpp::Feature way_feature(*m_geometry_duplicate_node_in_way_way, m_factory.create_linestring(way));
                 way_feature.set_field("way_id", idbuffer);
                 way_feature.set_field("node_id", idbuffer);
-                way_feature.set_field("tags", tags_string(way.tags()).c_str());
+                way_feature.set_field("tags", tags_string(way.tags(), nullptr).c_str());
                 std::string the_timestamp (way.timestamp().to_iso());
                 way_feature.set_field("lastchange", the_timestamp.c_str());
-                way_feature.add_to_layer();
+                write_feature(way_feature, *m_geometry_duplicate_node_in_way_way);
             }
             multiple_errors = true;
         }
@@ -236,32 +228,6 @@ void GeometryViewHandler::duplicated_node_in_way(const osmium::Way& way) {
     return osmium::Location();
 }
 
-/**
- * This method was copied from
- * [OSMCoastline](https://github.com/osmcode/osmcoastline/blob/master/src/coastline_ring_collection.cpp)
- */
-/*static*/ bool GeometryViewHandler::outside_x_range(const osmium::UndirectedSegment& s1, const osmium::UndirectedSegment& s2) {
-    if (s1.first().x() > s2.second().x()) {
-        return true;
-    }
-    return false;
-}
-
-/**
- * This method was copied from
- * [OSMCoastline](https://github.com/osmcode/osmcoastline/blob/master/src/coastline_ring_collection.cpp)
- */
-/*static*/ bool GeometryViewHandler::y_range_overlap(const osmium::UndirectedSegment& s1, const osmium::UndirectedSegment& s2) {
-    const int tmin = s1.first().y() < s1.second().y() ? s1.first().y( ) : s1.second().y();
-    const int tmax = s1.first().y() < s1.second().y() ? s1.second().y() : s1.first().y();
-    const int omin = s2.first().y() < s2.second().y() ? s2.first().y()  : s2.second().y();
-    const int omax = s2.first().y() < s2.second().y() ? s2.second().y() : s2.first().y();
-    if (tmin > omax || omin > tmax) {
-        return false;
-    }
-    return true;
-}
-
 void GeometryViewHandler::add_self_intersection_way(const osmium::Way& way, bool already_flagged) {
     if (already_flagged) {
         return;
@@ -270,8 +236,8 @@ void GeometryViewHandler::add_self_intersection_way(const osmium::Way& way, bool
     static char idbuffer[20];
     sprintf(idbuffer, "%ld", way.id());
     feature.set_field("way_id", idbuffer);
-    feature.set_field("tags", tags_string(way.tags()).c_str());
-    feature.add_to_layer();
+    feature.set_field("tags", tags_string(way.tags(), nullptr).c_str());
+    write_feature(feature, *m_geometry_self_intersection_ways);
 }
 
 void GeometryViewHandler::add_self_intersection_point(const osmium::Location& location, const osmium::object_id_type way_id,
@@ -283,7 +249,7 @@ void GeometryViewHandler::add_self_intersection_point(const osmium::Location& lo
     static char idbuffer2[20];
     sprintf(idbuffer2, "%ld", node_id);
     feature.set_field("node_id", idbuffer2);
-    feature.add_to_layer();
+    write_feature(feature, *m_geometry_self_intersection_points);
 }
 
 /**
@@ -291,30 +257,34 @@ void GeometryViewHandler::add_self_intersection_point(const osmium::Location& lo
  * [OSMCoastline](https://github.com/osmcode/osmcoastline/blob/master/src/coastline_ring_collection.cpp)
  */
 void GeometryViewHandler::check_self_intersection(const osmium::Way& way) {
-    std::vector<osmium::UndirectedSegment> segments;
-    for (size_t i = 0; i != way.nodes().size() - 1; ++i) {
-        if (!way.nodes()[i].location().valid() || !way.nodes()[i+1].location().valid()) {
-            continue;
-        }
-        segments.emplace_back(way.nodes()[i].location(), way.nodes()[i+1].location());
+    // Segments are sorted by index instead of copying them. The bounding boxes are looked up by
+    // the index.
+    m_sorted_segments.resize(m_segments.segment_count());
+    for (size_t i = 0; i < m_sorted_segments.size(); ++i) {
+        m_sorted_segments[i] = i;
     }
     bool way_has_error = false;
     // sorting the segments saves about 16 seconds just for Germany
-    std::sort(segments.begin(), segments.end());
-    for (std::vector<osmium::UndirectedSegment>::iterator it1 = segments.begin(); it1 != segments.end()-1; ++it1) {
-        osmium::UndirectedSegment& s1 = *it1;
-        for (std::vector<osmium::UndirectedSegment>::iterator it2 = it1 + 1; it2 != segments.end(); ++it2) {
-            osmium::UndirectedSegment& s2 = *it2;
+    const WaySegments& segments = m_segments;
+    std::sort(m_sorted_segments.begin(), m_sorted_segments.end(), [&segments](const size_t a, const size_t b) {
+            return segments.segment(a) < segments.segment(b);
+        });
+    for (auto it1 = m_sorted_segments.begin(); it1 != m_sorted_segments.end(); ++it1) {
+        const osmium::UndirectedSegment s1 = m_segments.segment(*it1);
+        for (auto it2 = it1 + 1; it2 != m_sorted_segments.end(); ++it2) {
+            const osmium::UndirectedSegment s2 = m_segments.segment(*it2);
             if (s1 == s2) {
                 add_self_intersection_way(way, way_has_error);
                 way_has_error = true;
-                add_self_intersection_point(it1->first(), way.id(), 0);
-                add_self_intersection_point(it1->second(), way.id(), 0);
+                add_self_intersection_point(s1.first(), way.id(), 0);
+                add_self_intersection_point(s1.second(), way.id(), 0);
             } else {
-                if (outside_x_range(s2, s1)) {
+                // The segments are sorted by their western end. If s2 starts east of s1,
+                // all following segments do.
+                if (m_segments.min_x(*it2) > m_segments.max_x(*it1)) {
                     break;
                 }
-                if (y_range_overlap(s1, s2)) {
+                if (m_segments.min_y(*it1) <= m_segments.max_y(*it2) && m_segments.min_y(*it2) <= m_segments.max_y(*it1)) {
                     osmium::Location i = intersection(s1, s2);
                     if (i) {
                         add_self_intersection_way(way, way_has_error);
@@ -327,31 +297,81 @@ void GeometryViewHandler::check_self_intersection(const osmium::Way& way) {
     }
 }
 
-bool GeometryViewHandler::way_is_degenerated(const osmium::WayNodeList& nodes) {
-    if (nodes.size() == 1) {
-        return true;
+/*static*/ uint32_t GeometryViewHandler::overlap_category(const osmium::Way& way) {
+    // Linear features only, areas sharing their border with neighbouring areas are common.
+    static const char* const keys[] = {"highway", "railway", "waterway", "power", "barrier"};
+    const char* area = way.tags().get_value_by_key("area");
+    if (area && !strcmp(area, "yes")) {
+        return 0;
     }
-    for (osmium::WayNodeList::const_iterator it = nodes.cbegin(); it != nodes.cend() - 1;
-            ++it) {
-        osmium::WayNodeList::const_iterator next = it + 1;
-        // If we found two consecutive nodes which have different IDs and locations,
-        // we are able to build a valid LineString. For most valid ways the loop will be
-        // iterated only one time.
-        if (next->lat() != it->lat() || next->lon() != it->lon()) {
-            return false;
+    for (uint32_t i = 0; i < sizeof(keys) / sizeof(keys[0]); ++i) {
+        if (way.tags().has_key(keys[i])) {
+            return i + 1;
         }
     }
-    return true;
+    return 0;
+}
+
+void GeometryViewHandler::check_duplicate_ways(const osmium::Way& way) {
+    const bool was_full = m_duplicate_ways.full();
+    const osmium::object_id_type duplicate_of = m_duplicate_ways.add_way(way.id(), way.nodes(),
+            overlap_category(way), m_overlaps);
+    if (!was_full && m_duplicate_ways.full()) {
+        m_options.verbose_output << "Memory budget of the duplicate ways check reached after " <<
+                m_duplicate_ways.size() << " hashes, ways read later are not checked against each other\n";
+    }
+    static char idbuffer[20];
+    static char idbuffer2[20];
+    if (duplicate_of != 0) {
+        gdalcpp::Feature feature(*m_geometry_duplicate_ways_way, m_factory.create_linestring(way));
+        sprintf(idbuffer, "%ld", way.id());
+        feature.set_field("way_id", idbuffer);
+        sprintf(idbuffer2, "%ld", duplicate_of);
+        feature.set_field("other_way_id", idbuffer2);
+        feature.set_field("tags", tags_string(way.tags(), nullptr).c_str());
+        std::string the_timestamp (way.timestamp().to_iso());
+        feature.set_field("lastchange", the_timestamp.c_str());
+        write_feature(feature, *m_geometry_duplicate_ways_way);
+        return;
+    }
+    for (const DuplicateWayIndex::Overlap& overlap : m_overlaps) {
+        osmium::WayNodeList::const_iterator it = way.nodes().cbegin();
+        gdalcpp::Feature feature(*m_geometry_duplicate_ways_overlap,
+                build_linestring_from_segment(it + overlap.first, it + overlap.last + 1));
+        sprintf(idbuffer, "%ld", way.id());
+        feature.set_field("way_id", idbuffer);
+        sprintf(idbuffer2, "%ld", overlap.other);
+        feature.set_field("other_way_id", idbuffer2);
+        feature.set_field("est_nodes", static_cast<int>(overlap.last - overlap.first + 1));
+        feature.set_field("tags", tags_string(way.tags(), nullptr).c_str());
+        std::string the_timestamp (way.timestamp().to_iso());
+        feature.set_field("lastchange", the_timestamp.c_str());
+        write_feature(feature, *m_geometry_duplicate_ways_overlap);
+    }
+}
+
+bool GeometryViewHandler::load_segments(const osmium::WayNodeList& nodes) {
+    const size_t invalid = m_segments.load(nodes, latitude_limit());
+    if (invalid == nodes.size()) {
+        return true;
+    }
+    const osmium::NodeRef& nd_ref = nodes[invalid];
+    if (!nd_ref.location().valid()) {
+        m_options.verbose_output << "Invalid location for node " << nd_ref.ref() << "\n";
+    } else {
+        m_options.verbose_output << "Unprojectable coordinates for node " << nd_ref.ref() << '\n';
+    }
+    return false;
 }
 
 void GeometryViewHandler::way(const osmium::Way& way) {
-    if (!all_nodes_valid(way.nodes())) {
+    if (way.nodes().empty() || !load_segments(way.nodes())) {
         return;
     }
     if (way.nodes().size() >= 1900) {
         handle_way_many_nodes(way);
     }
-    if (way_is_degenerated(way.nodes())) {
+    if (m_segments.degenerated()) {
         single_node_in_way(way);
         // no more checks necessary
         return;
@@ -359,6 +379,7 @@ void GeometryViewHandler::way(const osmium::Way& way) {
     handle_long_segments(way);
     duplicated_node_in_way(way);
     check_self_intersection(way);
+    check_duplicate_ways(way);
 }
 
 void GeometryViewHandler::close() {
@@ -370,5 +391,12 @@ void GeometryViewHandler::close() {
     m_geometry_duplicate_node_in_way_node.reset();
     m_geometry_self_intersection_ways.reset();
     m_geometry_self_intersection_points.reset();
+    m_geometry_duplicate_ways_way.reset();
+    m_geometry_duplicate_ways_overlap.reset();
+    m_duplicate_ways.clear();
     close_datasets();
 }
+
+size_t GeometryViewHandler::duplicate_ways_memory() const noexcept {
+    return m_duplicate_ways.used_memory();
+}
@@ -30,6 +30,8 @@
 #include <osmium/osm/undirected_segment.hpp>
 
 #include "abstract_view_handler.hpp"
+#include "duplicate_way_index.hpp"
+#include "way_segments.hpp"
 
 class GeometryViewHandler : public AbstractViewHandler {
     /// layer for ways which have many nodes
@@ -48,6 +50,18 @@ class GeometryViewHandler : public AbstractViewHandler {
     std::unique_ptr<gdalcpp::Layer> m_geometry_self_intersection_ways;
     /// layer for intersection points of self intersecting ways
     std::unique_ptr<gdalcpp::Layer> m_geometry_self_intersection_points;
+    /// layer for ways with the same nodes as another way
+    std::unique_ptr<gdalcpp::Layer> m_geometry_duplicate_ways_way;
+    /// layer for parts of ways sharing consecutive nodes with another way
+    std::unique_ptr<gdalcpp::Layer> m_geometry_duplicate_ways_overlap;
+    /// hashes of the node sequences of all ways seen so far
+    DuplicateWayIndex m_duplicate_ways;
+    /// earlier ways sharing nodes with the current way
+    std::vector<DuplicateWayIndex::Overlap> m_overlaps;
+    /// locations and segments of the current way
+    WaySegments m_segments;
+    /// indexes of the segments of the current way sorted by location (self intersection check)
+    std::vector<size_t> m_sorted_segments;
     /**
      * Add a feature to the output layers.
      *
@@ -84,13 +98,6 @@ class GeometryViewHandler : public AbstractViewHandler {
     void add_error(const osmium::OSMObject& osm_object, const osmium::object_id_type id,
             const char* geomtype, std::string error);
 
-    /**
-     * Build a string containing tags (length of key and value below 48 characters)
-     * to be inserted into a "tag" column. The returned string is shorter than
-     * MAX_FIELD_LENGTH characters. No keys or values will be truncated.
-     */
-    std::string tags_string(const osmium::TagList& tags);
-
     /**
      * Build a linestring from a part of a WayNodeList.
      */
@@ -128,16 +135,6 @@ class GeometryViewHandler : public AbstractViewHandler {
      */
     static osmium::Location intersection(const osmium::UndirectedSegment& s1, const osmium::UndirectedSegment&s2);
 
-    /**
-     * Check if the intervals of two segments on the x axis overlap. If not, an intersection is impossible.
-     */
-    static bool outside_x_range(const osmium::UndirectedSegment& s1, const osmium::UndirectedSegment& s2);
-
-    /**
-     * Check if the intervals of two segments on the y axis overlap. If not, an intersection is impossible.
-     */
-    static bool y_range_overlap(const osmium::UndirectedSegment& s1, const osmium::UndirectedSegment& s2);
-
     /**
      * Write a whole way which has a self intersection to the output layer.
      */
@@ -155,17 +152,29 @@ class GeometryViewHandler : public AbstractViewHandler {
     void check_self_intersection(const osmium::Way& way);
 
     /**
-     * Check if a way is degenerated.
+     * Category of a way for the search of overlapping ways, 0 if overlaps of the way are not
+     * reported.
+     */
+    static uint32_t overlap_category(const osmium::Way& way);
+
+    /**
+     * Check if the way has the same nodes as an earlier way or shares a run of consecutive nodes
+     * with an earlier way of the same category and write it to the output layers.
+     */
+    void check_duplicate_ways(const osmium::Way& way);
+
+    /**
+     * Copy the locations of the nodes of a way into m_segments and compute the properties of its
+     * segments. All following checks of the way use m_segments.
      *
-     * A way is degenerated if it has only one node or if it lacks of a pair of two consecutive nodes with
-     * different ID and different location.
+     * \returns false if a location is invalid or cannot be projected
      */
-    bool way_is_degenerated(const osmium::WayNodeList& nodes);
+    bool load_segments(const osmium::WayNodeList& nodes);
 
 public:
     GeometryViewHandler() = delete;
 
-    GeometryViewHandler(Options&);
+    GeometryViewHandler(Options& options, gdalcpp::Dataset* shared_dataset = nullptr);
 
     void give_correct_name();
 
@@ -178,6 +187,11 @@ public:
     std::string name();
 
     void close();
+
+    /**
+     * Memory in bytes used by the hash table of the duplicate ways check
+     */
+    size_t duplicate_ways_memory() const noexcept;
 };
 
 
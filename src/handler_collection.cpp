@@ -7,61 +7,134 @@
 
 #include "handler_collection.hpp"
 
+#include <chrono>
+#include <future>
+
 HandlerCollection::HandlerCollection(Options& options) :
-    m_options(options) {}
+    m_options(options),
+    m_tag_summary(OGROutputBase::MAX_FIELD_LENGTH) {
+    if (m_options.vector_tile_output()) {
+        std::string output_filename = m_options.output_directory;
+        output_filename += "/views";
+        if (m_options.output_format == "PMTiles") {
+            output_filename += ".pmtiles";
+        }
+        m_tile_dataset.reset(new gdalcpp::Dataset(m_options.output_format, output_filename,
+                gdalcpp::SRS(m_options.srs), gdal_default_dataset_options(m_options)));
+        enable_transactions(*m_tile_dataset);
+    }
+}
 
 void HandlerCollection::give_correct_name() {
+    // The join uses all cores. It runs before the other handlers are closed in parallel.
+    if (m_places_handler) {
+        TraceScope scope{m_options.tracer, "join places", "output"};
+        m_places_handler->join_places();
+    }
+    // Handlers may still write features while they are closed. With vector tile output, all of
+    // them write into the shared dataset which must not be used by several threads at the same
+    // time. Otherwise every handler writes into datasets of its own and the handlers are closed
+    // (and their spatial indexes built) in parallel. Their progress messages are written line by
+    // line (see VerboseOutput).
+    const std::launch policy = m_tile_dataset ? std::launch::deferred : std::launch::async;
+    std::vector<std::future<void>> closing_handlers;
     for (auto& h : m_handlers) {
-        h->close();
-        h->give_correct_name();
+        AbstractViewHandler* handler = h.get();
+        const char* name = m_handler_names[&h - m_handlers.data()];
+        Tracer& tracer = m_options.tracer;
+        closing_handlers.push_back(std::async(policy, [handler, name, &tracer]() {
+            TraceScope scope{tracer, std::string{"close "} + name, "output"};
+            handler->close();
+            handler->give_correct_name();
+        }));
+    }
+    // Deferred tasks run one after another in this loop.
+    for (auto& f : closing_handlers) {
+        f.get();
+    }
+    if (m_tile_dataset) {
+        m_options.verbose_output << "Writing vector tiles ...\n";
+        TraceScope scope{m_options.tracer, "write vector tiles", "output"};
+        m_tile_dataset.reset();
+        m_options.verbose_output << "Writing vector tiles done\n";
     }
 }
 
 gdalcpp::Dataset* HandlerCollection::add_handler(ViewType view, const char* layer_name) {
     std::unique_ptr<AbstractViewHandler> handler;
     gdalcpp::Dataset* dataset_ptr = nullptr;
+    const char* name = nullptr;
     if (view == ViewType::geometry) {
-        handler.reset(new GeometryViewHandler(m_options));
+        handler.reset(new GeometryViewHandler(m_options, m_tile_dataset.get()));
+        m_geometry_handler = dynamic_cast<GeometryViewHandler*>(handler.get());
+        name = "geometry";
     } else if (view == ViewType::highways) {
-        handler.reset(new HighwayViewHandler(m_options));
+        handler.reset(new HighwayViewHandler(m_options, m_tile_dataset.get()));
+        m_highway_handler = dynamic_cast<HighwayViewHandler*>(handler.get());
+        name = "highways";
     } else if (view == ViewType::tagging) {
-        handler.reset(new TaggingViewHandler(m_options));
+        handler.reset(new TaggingViewHandler(m_options, m_tile_dataset.get()));
+        name = "tagging";
     } else if (view == ViewType::places) {
-        handler.reset(new PlacesHandler(m_options));
+        handler.reset(new PlacesHandler(m_options, m_tile_dataset.get()));
         m_places_handler = dynamic_cast<PlacesHandler*>(handler.get());
+        name = "places";
+    } else if (view == ViewType::topology) {
+        handler.reset(new TopologyViewHandler(m_options, m_tile_dataset.get()));
+        m_topology_handler = dynamic_cast<TopologyViewHandler*>(handler.get());
+        name = "topology";
     } else {
         return nullptr;
     }
     if (layer_name) {
         dataset_ptr = handler->get_dataset_pointer(layer_name);
     }
+    handler->share_tag_summary(m_tag_summary);
     m_handlers.push_back(std::move(handler));
+    m_handler_names.push_back(name);
+    m_handler_times.emplace_back();
     return dataset_ptr;
 }
 
-void HandlerCollection::add_multipolygon_collector(osmium::area::MultipolygonCollector<osmium::area::Assembler>& collector) {
+void HandlerCollection::add_places_area_collector(PlacesAreaCollector& collector) {
     PlacesHandler& pl = *m_places_handler;
-    m_mp_collector_handler2 = &(collector.handler([&pl](const osmium::memory::Buffer& area_buffer) {
-        osmium::apply(area_buffer, pl);
-        }));
+    const Shard& shard = m_options.shard;
+    TagSummary& tag_summary = m_tag_summary;
+    collector.set_callback([&pl, &shard, &tag_summary](const osmium::memory::Buffer& area_buffer) {
+        for (auto it = area_buffer.cbegin<osmium::Area>(); it != area_buffer.cend<osmium::Area>(); ++it) {
+            if (shard.owns(*it)) {
+                tag_summary.reset();
+                pl.area(*it);
+            }
+        }
+        });
+    m_places_collector = &collector;
 }
 
 void HandlerCollection::node(const osmium::Node& node) {
-    for (std::unique_ptr<AbstractViewHandler>& handler : m_handlers) {
-        handler->node(node);
+    // None of the views writes nodes without tags.
+    if (node.tags().empty() || !m_options.shard.owns(node)) {
+        return;
     }
-    if (m_mp_collector_handler2) {
-        m_mp_collector_handler2->node(node);
+    m_tag_summary.reset();
+    for (size_t i = 0; i < m_handlers.size(); ++i) {
+        TraceTimer timer{m_options.tracer, m_handler_times[i]};
+        m_handlers[i]->node(node);
     }
 }
 
 void HandlerCollection::way(const osmium::Way& way) {
     try {
-        for (std::unique_ptr<AbstractViewHandler>& handler  : m_handlers) {
-            handler->way(way);
+        // Ways of other shards are needed to assemble multipolygons but must not be written.
+        if (m_options.shard.owns(way)) {
+            m_tag_summary.reset();
+            for (size_t i = 0; i < m_handlers.size(); ++i) {
+                TraceTimer timer{m_options.tracer, m_handler_times[i]};
+                m_handlers[i]->way(way);
+            }
         }
-        if (m_mp_collector_handler2) {
-            m_mp_collector_handler2->way(way);
+        if (m_places_collector) {
+            m_places_collector->process_way(way);
         }
     } catch (osmium::invalid_location& err) {
         m_options.verbose_output << err.what() << '\n';
@@ -69,12 +142,14 @@ void HandlerCollection::way(const osmium::Way& way) {
 }
 
 void HandlerCollection::relation(const osmium::Relation& relation) {
+    m_tag_summary.reset();
     try {
-        for (std::unique_ptr<AbstractViewHandler>& handler : m_handlers) {
-            handler->relation(relation);
+        for (size_t i = 0; i < m_handlers.size(); ++i) {
+            TraceTimer timer{m_options.tracer, m_handler_times[i]};
+            m_handlers[i]->relation(relation);
         }
-        if (m_mp_collector_handler2) {
-            m_mp_collector_handler2->relation(relation);
+        if (m_places_collector) {
+            m_places_collector->process_relation(relation);
         }
     } catch (osmium::invalid_location& err) {
         m_options.verbose_output << err.what() << '\n';
@@ -82,11 +157,61 @@ void HandlerCollection::relation(const osmium::Relation& relation) {
 }
 
 void HandlerCollection::area(const osmium::Area& area) {
+    if (!m_options.shard.owns(area)) {
+        return;
+    }
+    m_tag_summary.reset();
     try {
-        for (std::unique_ptr<AbstractViewHandler>& handler : m_handlers) {
-            handler->area(area);
+        for (size_t i = 0; i < m_handlers.size(); ++i) {
+            TraceTimer timer{m_options.tracer, m_handler_times[i]};
+            m_handlers[i]->area(area);
         }
     } catch (osmium::invalid_location& err) {
         m_options.verbose_output << err.what() << '\n';
     }
 }
+
+void HandlerCollection::trace_handlers(const int64_t start) {
+    if (!m_options.tracer.enabled()) {
+        return;
+    }
+    int64_t event_start = start;
+    for (size_t i = 0; i < m_handlers.size(); ++i) {
+        const int64_t duration = std::chrono::duration_cast<std::chrono::microseconds>(m_handler_times[i]).count();
+        if (duration > 0) {
+            m_options.tracer.add_event(m_handler_names[i], "views", event_start, duration);
+            event_start += duration;
+        }
+        m_handler_times[i] = Tracer::clock_type::duration::zero();
+    }
+}
+
+size_t HandlerCollection::dataset_count() const {
+    size_t count = m_tile_dataset ? 1 : 0;
+    for (const auto& handler : m_handlers) {
+        count += handler->dataset_count();
+    }
+    return count;
+}
+
+size_t HandlerCollection::places_join_memory() const {
+    return m_places_handler ? m_places_handler->join_memory() : 0;
+}
+
+size_t HandlerCollection::road_network_memory() const {
+    return m_highway_handler ? m_highway_handler->road_network_memory() : 0;
+}
+
+size_t HandlerCollection::duplicate_ways_memory() const {
+    return m_geometry_handler ? m_geometry_handler->duplicate_ways_memory() : 0;
+}
+
+size_t HandlerCollection::crossing_index_memory() const {
+    return m_topology_handler ? m_topology_handler->crossing_index_memory() : 0;
+}
+
+void HandlerCollection::flush() {
+    if (m_places_collector) {
+        m_places_collector->flush();
+    }
+}
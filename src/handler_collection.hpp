@@ -8,14 +8,15 @@
 #ifndef SRC_HANDLER_COLLECTION_HPP_
 #define SRC_HANDLER_COLLECTION_HPP_
 
-#include <osmium/area/multipolygon_collector.hpp>
-#include <osmium/area/assembler.hpp>
-
 #include "highway_view_handler.hpp"
+#include "ogr_output_base.hpp"
 #include "geometry_view_handler.hpp"
 #include "options.hpp"
+#include "places_area_collector.hpp"
 #include "places_handler.hpp"
+#include "tag_summary.hpp"
 #include "tagging_view_handler.hpp"
+#include "topology_view_handler.hpp"
 
 /**
  * The handler collection manages all handlers and calls their node, way, relation and area callbacks one
@@ -23,16 +24,36 @@
  *
  * The HandlerCollection class must include the header file of the handler class and the handler class must
  * be derived from AbstractViewHandler.
+ *
+ * If the output format is a vector tile format, the handler collection owns the only output dataset and
+ * all handlers write their layers into it. This way, all layers of all views end up in a single tile set.
  */
 class HandlerCollection : public osmium::handler::Handler {
     Options& m_options;
+    /// dataset shared by all handlers (vector tile output only)
+    std::unique_ptr<gdalcpp::Dataset> m_tile_dataset;
     std::vector<std::unique_ptr<AbstractViewHandler>> m_handlers;
-    PlacesHandler* m_places_handler;
-    osmium::area::MultipolygonCollector<osmium::area::Assembler>::HandlerPass2* m_mp_collector_handler2 = nullptr;
+    /// names of the views of the handlers (used for tracing)
+    std::vector<const char*> m_handler_names;
+    /// time spent in the callbacks of each handler since the last call of trace_handlers()
+    std::vector<Tracer::clock_type::duration> m_handler_times;
+    GeometryViewHandler* m_geometry_handler = nullptr;
+    HighwayViewHandler* m_highway_handler = nullptr;
+    PlacesHandler* m_places_handler = nullptr;
+    TopologyViewHandler* m_topology_handler = nullptr;
+    PlacesAreaCollector* m_places_collector = nullptr;
+    /// tags string of the current object, shared by all handlers
+    TagSummary m_tag_summary;
 
 public:
     HandlerCollection(Options& options);
 
+    /**
+     * Close all handlers and their datasets and give the output files their final names.
+     *
+     * Vector tiles are generated when the shared dataset is closed, i.e. this step takes a while
+     * for vector tile output.
+     */
     void give_correct_name();
 
     /**
@@ -47,11 +68,12 @@ public:
     gdalcpp::Dataset* add_handler(ViewType view, const char* layer_name = nullptr);
 
     /**
-     * \brief Add a multipolygon collector.
+     * \brief Add the collector assembling the areas of the places view.
      *
-     * This method has only to be called if the handler to be
+     * This method has only to be called if the places view is produced. The assembled areas are
+     * handed to the PlacesHandler.
      */
-    void add_multipolygon_collector(osmium::area::MultipolygonCollector<osmium::area::Assembler>& collector);
+    void add_places_area_collector(PlacesAreaCollector& collector);
 
     void node(const osmium::Node& node);
 
@@ -60,6 +82,43 @@ public:
     void relation(const osmium::Relation& relation);
 
     void area(const osmium::Area& area);
+
+    /**
+     * Record the time spent in the callbacks of each handler since the last call as one event per
+     * handler. The events are placed one after another, beginning at start (usually the start of
+     * the input buffer), i.e. they show the share of each view and not when the calls happened.
+     */
+    void trace_handlers(const int64_t start);
+
+    /**
+     * Number of open output datasets of all handlers
+     */
+    size_t dataset_count() const;
+
+    /**
+     * Memory in bytes used by the places view for the join of place nodes and areas
+     */
+    size_t places_join_memory() const;
+
+    /**
+     * Memory in bytes used by the highways view for the search for islands of the road network
+     */
+    size_t road_network_memory() const;
+
+    /**
+     * Memory in bytes used by the geometry view for the duplicate ways check
+     */
+    size_t duplicate_ways_memory() const;
+
+    /**
+     * Memory in bytes used by the topology view for the ways collected for the search for crossings
+     */
+    size_t crossing_index_memory() const;
+
+    /**
+     * Wait for the areas still being assembled and process them.
+     */
+    void flush();
 };
 
 
@@ -20,9 +20,17 @@
 
 #include "highway_view_handler.hpp"
 
+#include <stdexcept>
+#include <utility>
 
-HighwayViewHandler::HighwayViewHandler(Options& options) :
-        AbstractViewHandler(options),
+#include <osmium/geom/haversine.hpp>
+
+#include "quantity.hpp"
+#include "turn_lanes.hpp"
+
+
+HighwayViewHandler::HighwayViewHandler(Options& options, gdalcpp::Dataset* shared_dataset /*= nullptr*/) :
+        AbstractViewHandler(options, shared_dataset),
         m_highway_lanes(create_layer("highway_lanes", wkbLineString)),
         m_highway_maxheight(create_layer("highway_maxheight", wkbLineString)),
         m_highway_maxweight(create_layer("highway_maxweight", wkbLineString)),
@@ -34,7 +42,9 @@ HighwayViewHandler::HighwayViewHandler(Options& options) :
         m_highway_oneway(create_layer("highway_oneway", wkbLineString)),
         m_highway_road(create_layer("highway_road", wkbLineString)),
         m_highway_unknown_node(create_layer("highway_unknown_node", wkbPoint)),
-        m_highway_unknown_way(create_layer("highway_unknown_way", wkbLineString)) {
+        m_highway_unknown_way(create_layer("highway_unknown_way", wkbLineString)),
+        m_highway_islands(create_layer("highway_islands", wkbLineString)),
+        m_road_network() {
     // add fields to layers
     m_highway_lanes->add_field("way_id", OFTString, 10);
     m_highway_lanes->add_field("lanes", OFTString, 40);
@@ -72,17 +82,67 @@ HighwayViewHandler::HighwayViewHandler(Options& options) :
     m_highway_unknown_way->add_field("way_id", OFTString, 10);
     m_highway_unknown_way->add_field("highway", OFTString, 40);
     m_highway_unknown_way->add_field("tags", OFTString, MAX_FIELD_LENGTH);
+    m_highway_islands->add_field("way_id", OFTString, 10);
+    m_highway_islands->add_field("highway", OFTString, 40);
+    m_highway_islands->add_field("island_id", OFTString, 10);
+    m_highway_islands->add_field("island_ways", OFTInteger, 10);
+    m_highway_islands->add_field("island_length", OFTInteger, 10);
 
     // register checks
     register_check(name_not_fixme, "name", m_highway_name_fixme.get());
-    register_check(oneway_ok, "oneway", m_highway_oneway.get());
-    register_check(maxheight_ok, "maxheight", m_highway_maxheight.get());
-    register_check(maxweight_ok, "maxweight", m_highway_maxweight.get());
-    register_check(maxlength_ok, "maxlength", m_highway_maxlength.get());
-    register_check(maxspeed_ok, "maxspeed", m_highway_maxspeed.get());
     register_check(name_missing_major, "highway", m_highway_name_missing_major.get());
     register_check(name_missing_minor, "highway", m_highway_name_missing_minor.get());
     register_check(highway_road, "", m_highway_road.get());
+
+    // checks of allowed values (oneway, maxspeed, unknown highway types etc.) from the rules file
+    m_way_rules = m_options.rules.table("highways", CheckRule::object_type::way);
+    m_node_rules = m_options.rules.table("highways", CheckRule::object_type::node);
+    assign_rule_layers();
+}
+
+void HighwayViewHandler::assign_rule_layers() {
+    const std::pair<const char*, gdalcpp::Layer*> layers[] = {
+        {"highway_lanes", m_highway_lanes.get()},
+        {"highway_maxheight", m_highway_maxheight.get()},
+        {"highway_maxweight", m_highway_maxweight.get()},
+        {"highway_maxlength", m_highway_maxlength.get()},
+        {"highway_maxspeed", m_highway_maxspeed.get()},
+        {"highway_name_fixme", m_highway_name_fixme.get()},
+        {"highway_name_missing_major", m_highway_name_missing_major.get()},
+        {"highway_name_missing_minor", m_highway_name_missing_minor.get()},
+        {"highway_oneway", m_highway_oneway.get()},
+        {"highway_road", m_highway_road.get()},
+        {"highway_unknown_node", m_highway_unknown_node.get()},
+        {"highway_unknown_way", m_highway_unknown_way.get()}
+    };
+    m_rule_layers.assign(m_options.rules.size(), nullptr);
+    m_rule_fields.assign(m_options.rules.size(), nullptr);
+    for (const auto& rule : m_options.rules.rules()) {
+        if (rule->view != "highways") {
+            continue;
+        }
+        for (const auto& layer : layers) {
+            if (rule->layer == layer.first) {
+                m_rule_layers[rule->index] = layer.second;
+            }
+        }
+        if (!m_rule_layers[rule->index]) {
+            throw CheckRulesError{"Check " + rule->name + " refers to unknown layer '" + rule->layer
+                + "' of the highways view."};
+        }
+        if (rule->object == CheckRule::object_type::node
+                && m_rule_layers[rule->index] != m_highway_unknown_node.get()) {
+            throw CheckRulesError{"Check " + rule->name + " of nodes must write to layer highway_unknown_node."};
+        }
+        if (rule->object == CheckRule::object_type::way
+                && m_rule_layers[rule->index] == m_highway_unknown_node.get()) {
+            throw CheckRulesError{"Check " + rule->name + " of ways must not write to layer highway_unknown_node."};
+        }
+        // The value is written to the field named like the key if the layer has such a field.
+        if (m_rule_layers[rule->index]->get().GetLayerDefn()->GetFieldIndex(rule->key.c_str()) >= 0) {
+            m_rule_fields[rule->index] = rule->key.c_str();
+        }
+    }
 }
 
 void HighwayViewHandler::give_correct_name() {
@@ -90,6 +150,7 @@ void HighwayViewHandler::give_correct_name() {
 }
 
 void HighwayViewHandler::close() {
+    write_islands();
     m_highway_lanes.reset();
     m_highway_maxheight.reset();
     m_highway_maxspeed.reset();
@@ -100,6 +161,7 @@ void HighwayViewHandler::close() {
     m_highway_road.reset();
     m_highway_unknown_node.reset();
     m_highway_unknown_way.reset();
+    m_highway_islands.reset();
     close_datasets();
 }
 
@@ -109,81 +171,8 @@ void HighwayViewHandler::register_check(std::function<bool (const osmium::TagLis
     m_layers.push_back(layer);
 }
 
-bool HighwayViewHandler::is_valid_const_speed(const char* maxspeed_value) {
-    if (!strcmp(maxspeed_value, "RO:urban")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "none")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "RU:urban")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "RU:rural")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "RO:rural")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "RU:living_street")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "RO:trunk")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "RU:motorway")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "AT:urban")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "DE:urban")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "UA:urban")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "AT:rural")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "UA:rural")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "IT:urban")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "RO:motorway")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "DE:rural")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "CZ:urban")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "RU:urban")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "walk")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "AT:motorway")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "IT:rural")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "DE:living_street")) {
-        return true;
-    }
-    if (!strcmp(maxspeed_value, "DE:walk")) {
-        return true;
-    }
-    return false;
-}
-
 void HighwayViewHandler::set_fields(gdalcpp::Layer* layer, const osmium::Way& way, const char* third_field_name,
-        const char* third_field_value, std::string& other_tags) {
+        const char* third_field_value, const std::string& other_tags) {
     set_fields<osmium::Way>(
             layer, way, third_field_name, third_field_value, other_tags,
             [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
@@ -196,10 +185,10 @@ int HighwayViewHandler::check_lanes_value_and_write_error(const osmium::Way& way
     if (!lanes_value) {
         return 0;
     }
-    char* rest;
-    long int lanes_read = std::strtol(lanes_value, &rest, 10);
-    if (*rest || lanes_read <= 0 || lanes_read > 16) {
-        std::string tags_str = tags_string(way.tags(), "lanes");
+    const Quantity lanes = Quantity::parse(lanes_value);
+    const long int lanes_read = lanes.integer;
+    if (*lanes.integer_end || lanes_read <= 0 || lanes_read > 16) {
+        const std::string& tags_str = tags_string(way.tags(), "lanes");
         std::string error_msg = "invalid number ";
         error_msg += key;
         set_fields<osmium::Way>(
@@ -227,74 +216,6 @@ bool HighwayViewHandler::all_oneway(const osmium::TagList& tags) {
     return true;
 }
 
-int HighwayViewHandler::pipe_separated_items_count(const char* value) {
-    if (!value) {
-        return 0;
-    }
-    int count = 1;
-    for (const char* ptr = value; *ptr != 0; ++ptr) {
-        if (*ptr == '|') {
-            ++count;
-        }
-    }
-    return count;
-}
-
-bool HighwayViewHandler::check_valid_turns(const char* turns) {
-    const std::vector<std::pair<const std::string, const size_t>> valid_turns = {
-            {"left", 4},
-            {"through", 7},
-            {"right", 5},
-            {"slight_left", 11},
-            {"slight_right", 12},
-            {"sharp_left", 10},
-            {"sharp_right", 11},
-            {"reverse", 7},
-            {"merge_to_left", 13},
-            {"merge_to_right", 14},
-            {"none", 4}
-    };
-    if (!turns) {
-        return true;
-    }
-    const char* start = turns;
-    const char* end = strchr(start, '\0');
-    if (end - start < 4) {
-        return false;
-    }
-    while (start < end) {
-        const char* sep = strchr(start, '|');
-        const char* sep_semicolon = strchr(start, ';');
-        if (!sep && !sep_semicolon) {
-            sep = end;
-        } else if ((sep && sep_semicolon && sep_semicolon < sep) || !sep) {
-            sep = sep_semicolon;
-        }
-        bool found = false;
-        size_t item_length = sep - start;
-        for (auto vp : valid_turns) {
-            if (item_length == vp.second && !strncmp(start, vp.first.c_str(), vp.second)) {
-                found = true;
-                break;
-            }
-        }
-        if (item_length == 0
-                && ((start > turns && *(start - 1) == '|') || start == turns)
-                && (*sep == '\0' || *sep == '|')) {
-            // shortcut for direction value "none"
-            found = true;
-        }
-        if (!found) {
-            return false;
-        }
-        if (sep == end) {
-            return true;
-        }
-        start = sep + 1;
-    }
-    return true;
-}
-
 void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     int lanes = check_lanes_value_and_write_error(way, "lanes");
     if (lanes == -1) {
@@ -341,10 +262,9 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
         return;
     }
     // check if turn:lanes is present on bidirectional ways
-    std::string all_tags_str = tags_string(way.tags(), "highway");
     if (way.tags().has_key("turn:lanes") && !pure_oneway) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), tags_string(way.tags(), "highway"),
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes on bidirectional way"
         );
@@ -352,18 +272,18 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     }
     if ((way.tags().has_key("turn:lanes:forward") || way.tags().has_key("turn:lanes:forward")) && pure_oneway) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), tags_string(way.tags(), "highway"),
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "unneccessary direction-dependent turn:lanes on oneway"
         );
         return;
     }
     // number of lanes vs. turn:lanes
-    const char* turn_lanes_value = way.get_value_by_key("turn:lanes");
-    int turn_lanes_count = pipe_separated_items_count(turn_lanes_value);
+    const turn_lanes::TurnLanes turn_lanes = turn_lanes::lex(way.get_value_by_key("turn:lanes"));
+    int turn_lanes_count = turn_lanes.count;
     if (turn_lanes_count > 0 && lanes == 0) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), tags_string(way.tags(), "highway"),
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes without lanes=*"
         );
@@ -371,26 +291,26 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     }
     if (turn_lanes_count > 0 && turn_lanes_count < lanes) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), tags_string(way.tags(), "highway"),
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes contains too few lanes"
         );
         return;
     }
-    if (!check_valid_turns(turn_lanes_value)) {
+    if (!turn_lanes.valid) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), tags_string(way.tags(), "highway"),
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes contains invalid directions"
         );
         return;
     }
     // forward
-    const char* turn_lanes_value_fwd = way.get_value_by_key("turn:lanes:forward");
-    int turn_lanes_count_fwd = pipe_separated_items_count(turn_lanes_value_fwd);
+    const turn_lanes::TurnLanes turn_lanes_fwd = turn_lanes::lex(way.get_value_by_key("turn:lanes:forward"));
+    int turn_lanes_count_fwd = turn_lanes_fwd.count;
     if (turn_lanes_count_fwd > 0 && lanes_fwd == 0) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), tags_string(way.tags(), "highway"),
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes:forward without lanes:forward=*"
         );
@@ -398,26 +318,26 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     }
     if (turn_lanes_count_fwd > 0 && turn_lanes_count_fwd < lanes_fwd) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), tags_string(way.tags(), "highway"),
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes:forward contains too few lanes"
         );
         return;
     }
-    if (!check_valid_turns(turn_lanes_value_fwd)) {
+    if (!turn_lanes_fwd.valid) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), tags_string(way.tags(), "highway"),
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes:forward contains invalid directions"
         );
         return;
     }
     // backward
-    const char* turn_lanes_value_bkwd = way.get_value_by_key("turn:lanes:backward");
-    int turn_lanes_count_bkwd = pipe_separated_items_count(turn_lanes_value_bkwd);
+    const turn_lanes::TurnLanes turn_lanes_bkwd = turn_lanes::lex(way.get_value_by_key("turn:lanes:backward"));
+    int turn_lanes_count_bkwd = turn_lanes_bkwd.count;
     if (turn_lanes_count_bkwd > 0 && lanes_bkwd == 0) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), tags_string(way.tags(), "highway"),
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes:backward without lanes:backward=*"
         );
@@ -425,15 +345,15 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     }
     if (turn_lanes_count_bkwd > 0 && turn_lanes_count_bkwd < lanes_bkwd) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), tags_string(way.tags(), "highway"),
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes:backward contains too few lanes"
         );
         return;
     }
-    if (!check_valid_turns(turn_lanes_value_bkwd)) {
+    if (!turn_lanes_bkwd.valid) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), tags_string(way.tags(), "highway"),
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes:backward contains invalid directions"
         );
@@ -456,124 +376,6 @@ bool HighwayViewHandler::name_not_fixme(const osmium::TagList& tags) {
     return true;
 }
 
-bool HighwayViewHandler::oneway_ok(const osmium::TagList& tags) {
-    const char* oneway_value = tags.get_value_by_key("oneway");
-    if (!oneway_value) {
-        return true;
-    }
-    if (!strcmp(oneway_value, "yes") || !strcmp(oneway_value, "no") || !strcmp(oneway_value, "-1")) {
-        return true;
-    }
-    return false;
-}
-
-bool HighwayViewHandler::maxspeed_ok(const osmium::TagList& tags) {
-    const char* maxspeed_value = tags.get_value_by_key("maxspeed");
-    if (!maxspeed_value) {
-        return true;
-    }
-    char* rest;
-    long int maxspeed_read = std::strtol(maxspeed_value, &rest, 10);
-    if (*rest) { // something behind the number
-        if (!strcmp(rest, " mph") && maxspeed_read <= 112 && maxspeed_read > 0) {
-            return true;
-        }
-        if (maxspeed_value == rest && (!strcmp(rest, " none") || !strcmp(rest, "signals"))) {
-            return true;
-        }
-    } else if (maxspeed_read > 0 && maxspeed_read <= 150) {
-        return true;
-    }
-    // check for national contants
-    return is_valid_const_speed(maxspeed_value);
-}
-
-bool HighwayViewHandler::check_length_value(const char* value) {
-    if (!value) {
-        return true;
-    }
-    if (!strcmp(value, "none") || !strcmp(value, "default") || !strcmp(value, "physical")) {
-        return true;
-    }
-    char* rest;
-    // try parsing as metric
-    double maxheight_m = std::strtod(value, &rest);
-    if (maxheight_m > 0 && *rest == 0) {
-        return true;
-    }
-    // try parsing as imperial
-    long int maxheight_read = std::strtol(value, &rest, 10);
-    if (*rest) { // something behind the number
-        if (*rest == '\'' && maxheight_read > 0) {
-            ++rest; // move one character to the right
-            if (isdigit(*rest)) {
-                char* rest2;
-                double maxheight_read2 = std::strtod(rest, &rest2);
-                if (maxheight_read2 > 0 || *rest2 == '"') {
-                    return true;
-                }
-                return false;
-            } else if (*rest == 0) {
-                // ' followed by nothing
-                return true;
-            } else if (*rest) {
-                // ' is followed by a non-numeric character
-                return false;
-            }
-        }
-    }
-    // This shouldn't happen and we consider this as an error.
-    // If th integer is not followed by a ', it is no imperical unit.
-    return false;
-}
-
-bool HighwayViewHandler::maxheight_ok(const osmium::TagList& tags) {
-    const char* maxheight_value = tags.get_value_by_key("maxheight");
-    return check_length_value(maxheight_value);
-}
-
-bool HighwayViewHandler::maxlength_ok(const osmium::TagList& tags) {
-    const char* maxlength_value = tags.get_value_by_key("maxlength");
-    return check_length_value(maxlength_value);
-}
-
-bool HighwayViewHandler::maxweight_ok(const osmium::TagList& tags) {
-    const char* maxweight_value = tags.get_value_by_key("maxweight");
-    if (!maxweight_value || !strcmp(maxweight_value, "unsigned")) {
-        return true;
-    }
-    char* rest;
-    // try parsing as metric
-    double maxweight_metric = std::strtod(maxweight_value, &rest);
-    // check for too large values
-    if (maxweight_metric > 0 && *rest == 0 && maxweight_metric < 90) {
-        return true;
-    }
-    // try parsing as imperial
-    long int maxweight_read = std::strtol(maxweight_value, &rest, 10);
-    if (*rest) { // something behind the number
-        if (*rest == ' ' && maxweight_read > 0) {
-            ++rest; // move one character to the right
-            if (!strcmp(rest, "t") && maxweight_read < 90) { // metric tonne
-                return true;
-            }
-            if (!strcmp(rest, "st") && maxweight_read < 90 * 0.9071847) {
-                return true;
-            }
-            if (!strcmp(rest, "lt") && maxweight_read < 90 * 1.016047) {
-                return true;
-            }
-            if (!strcmp(rest, "kg") && maxweight_read < 90000) {
-                return true;
-            }
-        }
-    }
-    // This shouldn't happen and we consider this as an error.
-    // If th integer is not followed by a ', it is no imperical unit.
-    return false;
-}
-
-
 bool HighwayViewHandler::name_missing_major(const osmium::TagList& tags) {
     const char* name = tags.get_value_by_key("name");
     const char* ref = tags.get_value_by_key("ref");
@@ -616,81 +418,122 @@ bool HighwayViewHandler::highway_road(const osmium::TagList& tags) {
     return true;
 }
 
-void HighwayViewHandler::highway_unknown_node(const osmium::Node& node) {
-    const char* highway = node.get_value_by_key("highway");
-    if (!highway) {
-        return;
+void HighwayViewHandler::check_them_all(const osmium::Way& way) {
+    m_failed_rules.clear();
+    m_way_rules.evaluate(way.tags(), way.is_closed(), m_failed_rules);
+    bool nodes_checked = false;
+    for (size_t i = 0; i < m_layers.size(); ++i) {
+        if (!m_checks.at(i)(way.tags())) {
+            if (!nodes_checked && !all_nodes_valid(way.nodes())) {
+                return;
+            }
+            nodes_checked = true;
+            const std::string& tags_str = tags_string(way.tags(), m_keys.at(i).c_str());
+            const char* value = way.get_value_by_key(m_keys.at(i).c_str());
+            set_fields(m_layers.at(i), way, m_keys.at(i).c_str(), value, tags_str);
+        }
     }
-    if (!strcmp(highway, "bus_stop") || !strcmp(highway, "motorway_junction")
-            || !strcmp(highway, "services") || !strcmp(highway, "checkpoint")
-            || !strcmp(highway, "construction") || !strcmp(highway, "turning_circle")
-            || !strcmp(highway, "rest_area") || !strcmp(highway, "crossing")
-            || !strcmp(highway, "traffic_signals") || !strcmp(highway, "street_lamp")
-            || !strcmp(highway, "stop") || !strcmp(highway, "give_way")
-            || !strcmp(highway, "milestone") || !strcmp(highway, "turning_loop")
-            || !strcmp(highway, "mini_roundabout") || !strcmp(highway, "speed_camera")
-            || !strcmp(highway, "emergency_access_point") || !strcmp(highway, "elevator")
-            || !strcmp(highway, "passing_place") || !strcmp(highway, "traffic_mirror")
-            || !strcmp(highway, "emergency_bay") || !strcmp(highway, "ford")
-            || !strcmp(highway, "speed_display") || !strcmp(highway, "proposed")
-	    || !strcmp(highway, "platform") || !strcmp(highway, "toll_gantry")) {
-        return;
+    for (const CheckRule* rule : m_failed_rules) {
+        if (!nodes_checked && !all_nodes_valid(way.nodes())) {
+            return;
+        }
+        nodes_checked = true;
+        const std::string& tags_str = tags_string(way.tags(), rule->key.c_str());
+        const char* value = way.get_value_by_key(rule->key.c_str());
+        set_fields(m_rule_layers[rule->index], way, m_rule_fields[rule->index], value, tags_str);
     }
-    std::string tags_str = tags_string(node.tags(), "highway");
-    set_fields<osmium::Node>(m_highway_unknown_node.get(), node, "highway", highway, tags_str,
-            [](const osmium::Node& node, ogr_factory_type& factory) {return factory.create_point(node);},
-            node.id(), "node_id");
 }
 
-void HighwayViewHandler::highway_unknown_way(const osmium::Way& way) {
-    const char* highway = way.get_value_by_key("highway");
+namespace {
+
+    /// highway=* values of routable ways, followed by ferries (route=ferry)
+    const char* const ROAD_NETWORK_CLASSES[] = {
+        "motorway", "motorway_link", "trunk", "trunk_link", "primary", "primary_link", "secondary",
+        "secondary_link", "tertiary", "tertiary_link", "unclassified", "residential", "living_street",
+        "service", "ferry"
+    };
+
+    constexpr int ROAD_NETWORK_FERRY = sizeof(ROAD_NETWORK_CLASSES) / sizeof(ROAD_NETWORK_CLASSES[0]) - 1;
+
+} // anonymous namespace
+
+int HighwayViewHandler::road_network_class(const osmium::TagList& tags) {
+    const char* highway = tags.get_value_by_key("highway");
     if (!highway) {
-        return;
+        const char* route = tags.get_value_by_key("route");
+        return (route && !strcmp(route, "ferry")) ? ROAD_NETWORK_FERRY : -1;
     }
-    if (!strcmp(highway, "motorway") || !strcmp(highway, "motorway_link") || !strcmp(highway, "trunk")
-            || !strcmp(highway, "trunk_link") || !strcmp(highway, "primary") || !strcmp(highway, "primary_link")
-            || !strcmp(highway, "secondary") || !strcmp(highway, "secondary_link") || !strcmp(highway, "tertiary")
-            || !strcmp(highway, "tertiary_link") || !strcmp(highway, "residential")
-            || !strcmp(highway, "living_street") || !strcmp(highway, "pedestrian") || !strcmp(highway, "unclassified")
-            || !strcmp(highway, "service") || !strcmp(highway, "track") || !strcmp(highway, "path")
-            || !strcmp(highway, "footway") || !strcmp(highway, "cycleway") || !strcmp(highway, "bridleway")
-            || !strcmp(highway, "steps") || !strcmp(highway, "raceway") || !strcmp(highway, "bus_guideway")
-            || !strcmp(highway, "construction") || !strcmp(highway, "disused") || !strcmp(highway, "abandoned")
-            || !strcmp(highway, "proposed") || !strcmp(highway, "platform") || !strcmp(highway, "road")
-            || !strcmp(highway, "elevator") || !strcmp(highway, "corridor") || !strcmp(highway, "no")
-	    || !strcmp(highway, "emergency_bay") || !strcmp(highway, "razed")) {
-        return;
+    const char* area = tags.get_value_by_key("area");
+    if (area && !strcmp(area, "yes")) {
+        return -1;
+    }
+    for (int i = 0; i < ROAD_NETWORK_FERRY; ++i) {
+        if (!strcmp(highway, ROAD_NETWORK_CLASSES[i])) {
+            return i;
+        }
     }
-    if (way.is_closed() && (!strcmp(highway, "services") || !strcmp(highway, "rest_area") || !strcmp(highway, "traffic_island"))) {
+    return -1;
+}
+
+void HighwayViewHandler::add_to_road_network(const osmium::Way& way) {
+    const int cls = road_network_class(way.tags());
+    if (cls < 0 || way.nodes().size() < 2 || !all_nodes_valid(way.nodes())) {
         return;
     }
-    std::string tags_str = tags_string(way.tags(), "highway");
-    set_fields<osmium::Way>(m_highway_unknown_way.get(), way, "highway", highway, tags_str,
-            [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
-            way.id(), "way_id");
+    m_road_network.add_way(way.id(), way.nodes(), osmium::geom::haversine::distance(way.nodes()),
+            static_cast<uint8_t>(cls));
 }
 
-void HighwayViewHandler::check_them_all(const osmium::Way& way) {
-    for (size_t i = 0; i < m_layers.size(); ++i) {
-        if (!m_checks.at(i)(way.tags())) {
-            if (!all_nodes_valid(way.nodes())) {
-                return;
+void HighwayViewHandler::write_islands() {
+    m_options.verbose_output << "Searching islands in a road network of " << m_road_network.size() << " ways ...\n";
+    const std::vector<RoadNetworkIslands::Island> islands = m_road_network.find_islands(
+            m_options.island_max_ways, m_options.island_max_length);
+    m_options.verbose_output << "Found " << islands.size() << " islands in the road network\n";
+    char idbuffer[20];
+    char island_id[20];
+    std::vector<osmium::NodeRef> nodes;
+    for (const RoadNetworkIslands::Island& island : islands) {
+        sprintf(island_id, "%ld", m_road_network.id(island.ways.front()));
+        for (const size_t way : island.ways) {
+            nodes.clear();
+            for (const osmium::Location& location : m_road_network.locations(way)) {
+                nodes.emplace_back(0, location);
             }
-            std::string tags_str = tags_string(way.tags(), m_keys.at(i).c_str());
-            const char* value = way.get_value_by_key(m_keys.at(i).c_str());
-            set_fields(m_layers.at(i), way, m_keys.at(i).c_str(), value, tags_str);
+            m_factory.linestring_start();
+            const size_t linestring_length = m_factory.fill_linestring(nodes.begin(), nodes.end());
+            gdalcpp::Feature feature(*m_highway_islands, m_factory.linestring_finish(linestring_length));
+            sprintf(idbuffer, "%ld", m_road_network.id(way));
+            feature.set_field("way_id", idbuffer);
+            feature.set_field("highway", ROAD_NETWORK_CLASSES[m_road_network.cls(way)]);
+            feature.set_field("island_id", island_id);
+            feature.set_field("island_ways", static_cast<int>(island.ways.size()));
+            feature.set_field("island_length", static_cast<int>(island.length));
+            write_feature(feature, *m_highway_islands);
         }
     }
+    m_road_network.clear();
 }
 
 void HighwayViewHandler::way(const osmium::Way& way) {
     if (way.get_value_by_key("highway")) {
         check_them_all(way);
-        highway_unknown_way(way);
         check_lanes_tags(way);
     }
+    add_to_road_network(way);
 }
 
 void HighwayViewHandler::node(const osmium::Node& node) {
-    highway_unknown_node(node);
+    m_failed_rules.clear();
+    m_node_rules.evaluate(node.tags(), false, m_failed_rules);
+    for (const CheckRule* rule : m_failed_rules) {
+        const std::string& tags_str = tags_string(node.tags(), rule->key.c_str());
+        const char* value = node.get_value_by_key(rule->key.c_str());
+        set_fields<osmium::Node>(m_rule_layers[rule->index], node, m_rule_fields[rule->index], value, tags_str,
+                [](const osmium::Node& node, ogr_factory_type& factory) {return factory.create_point(node);},
+                node.id(), "node_id");
+    }
+}
+
+size_t HighwayViewHandler::road_network_memory() const noexcept {
+    return m_road_network.used_memory();
 }
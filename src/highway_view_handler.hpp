@@ -27,6 +27,8 @@
 #include <vector>
 
 #include "abstract_view_handler.hpp"
+#include "check_rules.hpp"
+#include "road_network_islands.hpp"
 
 struct charptr_comp {
     bool operator()(const char* const a, const char* const b) const {
@@ -49,6 +51,11 @@ class HighwayViewHandler : public AbstractViewHandler {
     std::unique_ptr<gdalcpp::Layer> m_highway_road;
     std::unique_ptr<gdalcpp::Layer> m_highway_unknown_node;
     std::unique_ptr<gdalcpp::Layer> m_highway_unknown_way;
+    /// layer for ways of small parts of the road network which are not connected to the rest
+    std::unique_ptr<gdalcpp::Layer> m_highway_islands;
+
+    /// routable ways (motorway to service and ferries) for the search of islands
+    RoadNetworkIslands m_road_network;
 
 
     /// param vector of functions returning false if a tag is malformed.
@@ -63,11 +70,30 @@ class HighwayViewHandler : public AbstractViewHandler {
     /// output layer for errorenous objects if the check fails
     std::vector<gdalcpp::Layer*> m_layers;
 
+    /// checks of ways loaded from the rules file
+    CheckTable m_way_rules;
+
+    /// checks of nodes loaded from the rules file
+    CheckTable m_node_rules;
+
+    /// output layers of the checks loaded from the rules file, indexed by CheckRule::index
+    std::vector<gdalcpp::Layer*> m_rule_layers;
+
+    /**
+     * Name of the field the value is written to for each check loaded from the rules file,
+     * indexed by CheckRule::index (nullptr if the layer has no field named like the key)
+     */
+    std::vector<const char*> m_rule_fields;
+
+    /// failed checks of the current object, kept to avoid reallocations
+    std::vector<const CheckRule*> m_failed_rules;
+
     /**
-     * Check if the value of the maxspeed tag matches one of the common
-     * values like RO:urban.
+     * Get the output layers for the checks loaded from the rules file.
+     *
+     * \throws CheckRulesError if a check refers to an unknown layer
      */
-    static bool is_valid_const_speed(const char* maxspeed_value);
+    void assign_rule_layers();
 
     /**
      * Create a feature, set its field and add it to its layer.
@@ -89,7 +115,7 @@ class HighwayViewHandler : public AbstractViewHandler {
      */
     template <typename TOsm>
     void set_fields(gdalcpp::Layer* layer, const TOsm& object, const char* third_field_name,
-            const char* third_field_value, std::string& other_tags,
+            const char* third_field_value, const std::string& other_tags,
             std::function<std::unique_ptr<OGRGeometry>(const TOsm&, ogr_factory_type&)> geom_func,
             const osmium::object_id_type id, const char* id_field_name, const char* key4 = nullptr,
             const char* field4 = nullptr) {
@@ -100,19 +126,19 @@ class HighwayViewHandler : public AbstractViewHandler {
             feature.set_field(id_field_name, idbuffer);
             feature.set_field("tags", other_tags.c_str());
             if (third_field_name && third_field_value) {
-                feature.set_field(third_field_name, third_field_value);
+                set_text_field(feature, third_field_name, third_field_value);
             }
             if (key4 && field4) {
-                feature.set_field(key4, field4);
+                set_text_field(feature, key4, field4);
             }
-            feature.add_to_layer();
+            write_feature(feature, *layer);
         } catch (osmium::geometry_error& err) {
             m_options.verbose_output << err.what() << "\n";
         }
     }
 
     void set_fields(gdalcpp::Layer* layer, const osmium::Way& way, const char* third_field_name,
-            const char* third_field_value, std::string& other_tags);
+            const char* third_field_value, const std::string& other_tags);
 
     /**
      * Check if a name is not a fixme placeholder, e.g. "fixme" or "unknown".
@@ -125,31 +151,16 @@ class HighwayViewHandler : public AbstractViewHandler {
 
     void check_lanes_tags(const osmium::Way& way);
 
-    static bool oneway_ok(const osmium::TagList& tags);
-
-    static bool maxspeed_ok(const osmium::TagList& tags);
-
-    static bool check_length_value(const char* value);
-
-    static bool maxheight_ok(const osmium::TagList& tags);
-
-    static bool maxweight_ok(const osmium::TagList& tags);
-
-    static bool maxlength_ok(const osmium::TagList& tags);
-
     static bool name_missing_major(const osmium::TagList& tags);
 
     static bool name_missing_minor(const osmium::TagList& tags);
 
     static bool highway_road(const osmium::TagList& tags);
 
-    void highway_unknown_node(const osmium::Node& node);
-
-    void highway_unknown_way(const osmium::Way& way);
-
 
     /**
-     * Run all checks on an OSM object.
+     * Run all checks on an OSM object. The checks loaded from the rules file are evaluated
+     * in a single pass over the tags.
      *
      * \param way reference to the OSM way to be checked
      */
@@ -168,10 +179,23 @@ class HighwayViewHandler : public AbstractViewHandler {
 
     bool all_oneway(const osmium::TagList& tags);
 
-    int pipe_separated_items_count(const char* value);
+    /**
+     * Class of a way in the road network (index in ROAD_NETWORK_CLASSES), -1 if it is not routable.
+     */
+    static int road_network_class(const osmium::TagList& tags);
+
+    /**
+     * Add a way to the road network if it is routable.
+     */
+    void add_to_road_network(const osmium::Way& way);
+
+    /**
+     * Find the islands of the road network and write their ways to the output layer.
+     */
+    void write_islands();
 
 public:
-    HighwayViewHandler(Options& options);
+    HighwayViewHandler(Options& options, gdalcpp::Dataset* shared_dataset = nullptr);
 
     void give_correct_name();
 
@@ -186,7 +210,10 @@ public:
 
     std::string name();
 
-    static bool check_valid_turns(const char* turns);
+    /**
+     * Memory in bytes used by the road network kept for the search for islands
+     */
+    size_t road_network_memory() const noexcept;
 };
 
 
@@ -0,0 +1,188 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "key_scan.hpp"
+
+#include <cstdint>
+
+#if defined(__AVX2__)
+# include <immintrin.h>
+#elif defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
+key_scan::KeyClass key_scan::scan_scalar(const char* key) noexcept {
+    KeyClass result;
+    const char* c = key;
+    for (; *c; ++c) {
+        if (!is_usual_character(*c)) {
+            result.unusual = true;
+            if (is_whitespace(*c)) {
+                result.whitespace = true;
+            }
+        }
+    }
+    result.length = static_cast<size_t>(c - key);
+    return result;
+}
+
+#if defined(__AVX2__) || defined(__SSE2__)
+
+namespace {
+
+#if defined(__AVX2__)
+    using vector_type = __m256i;
+    using mask_type = uint32_t;
+    constexpr size_t BLOCK_SIZE = 32;
+
+    inline vector_type load(const char* block) noexcept {
+        return _mm256_load_si256(reinterpret_cast<const vector_type*>(block));
+    }
+
+    inline vector_type set1(const char c) noexcept {
+        return _mm256_set1_epi8(c);
+    }
+
+    inline vector_type eq(const vector_type a, const vector_type b) noexcept {
+        return _mm256_cmpeq_epi8(a, b);
+    }
+
+    inline vector_type gt(const vector_type a, const vector_type b) noexcept {
+        return _mm256_cmpgt_epi8(a, b);
+    }
+
+    inline vector_type bit_or(const vector_type a, const vector_type b) noexcept {
+        return _mm256_or_si256(a, b);
+    }
+
+    inline vector_type and_not(const vector_type a, const vector_type b) noexcept {
+        return _mm256_andnot_si256(a, b);
+    }
+
+    inline mask_type movemask(const vector_type a) noexcept {
+        return static_cast<mask_type>(_mm256_movemask_epi8(a));
+    }
+#else
+    using vector_type = __m128i;
+    using mask_type = uint32_t;
+    constexpr size_t BLOCK_SIZE = 16;
+
+    inline vector_type load(const char* block) noexcept {
+        return _mm_load_si128(reinterpret_cast<const vector_type*>(block));
+    }
+
+    inline vector_type set1(const char c) noexcept {
+        return _mm_set1_epi8(c);
+    }
+
+    inline vector_type eq(const vector_type a, const vector_type b) noexcept {
+        return _mm_cmpeq_epi8(a, b);
+    }
+
+    inline vector_type gt(const vector_type a, const vector_type b) noexcept {
+        return _mm_cmpgt_epi8(a, b);
+    }
+
+    inline vector_type bit_or(const vector_type a, const vector_type b) noexcept {
+        return _mm_or_si128(a, b);
+    }
+
+    inline vector_type and_not(const vector_type a, const vector_type b) noexcept {
+        return _mm_andnot_si128(a, b);
+    }
+
+    inline mask_type movemask(const vector_type a) noexcept {
+        return static_cast<mask_type>(_mm_movemask_epi8(a));
+    }
+#endif
+
+    /**
+     * Bytes in the range [low, high]. The comparisons are signed, bytes >= 0x80 are never in a
+     * range of ASCII characters.
+     */
+    inline vector_type in_range(const vector_type v, const char low, const char high) noexcept {
+        return and_not(bit_or(gt(set1(low), v), gt(v, set1(high))), set1(-1));
+    }
+
+    /**
+     * Masks of the bytes which are not usual key characters, which are whitespace and which are
+     * the terminating null byte.
+     */
+    inline void classify(const char* block, mask_type& unusual, mask_type& whitespace, mask_type& zero) noexcept {
+        const vector_type v = load(block);
+        // Setting bit 5 maps upper case letters to lower case ones and no other character to a letter.
+        const vector_type letter = in_range(bit_or(v, set1(0x20)), 'a', 'z');
+        const vector_type usual = bit_or(bit_or(letter, in_range(v, '0', '9')),
+                bit_or(eq(v, set1(':')), bit_or(eq(v, set1('_')), eq(v, set1('-')))));
+        const vector_type space = bit_or(eq(v, set1(' ')), in_range(v, '\t', '\r'));
+        unusual = ~movemask(usual);
+        whitespace = movemask(space);
+        zero = movemask(eq(v, set1('\0')));
+    }
+
+    constexpr mask_type FULL_MASK = BLOCK_SIZE == 32 ? ~mask_type{0} : ((mask_type{1} << BLOCK_SIZE) - 1);
+
+} // anonymous namespace
+
+key_scan::KeyClass key_scan::scan(const char* key) noexcept {
+    KeyClass result;
+    // Start at the aligned block containing the first byte and ignore the bytes before the key.
+    const size_t offset = reinterpret_cast<uintptr_t>(key) % BLOCK_SIZE;
+    const char* block = key - offset;
+    mask_type valid = (FULL_MASK << offset) & FULL_MASK;
+    while (true) {
+        mask_type unusual, whitespace, zero;
+        classify(block, unusual, whitespace, zero);
+        zero &= valid;
+        if (zero) {
+            // only bytes before the terminating null byte
+            valid &= (zero & (~zero + 1)) - 1;
+        }
+        if ((unusual & valid) != 0) {
+            result.unusual = true;
+        }
+        if ((whitespace & valid) != 0) {
+            result.whitespace = true;
+        }
+        if (zero) {
+            result.length = static_cast<size_t>(block + __builtin_ctz(zero) - key);
+            return result;
+        }
+        block += BLOCK_SIZE;
+        valid = FULL_MASK;
+    }
+}
+
+#else
+
+key_scan::KeyClass key_scan::scan(const char* key) noexcept {
+    return scan_scalar(key);
+}
+
+#endif
+
+const char* key_scan::implementation() noexcept {
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
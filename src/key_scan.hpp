@@ -0,0 +1,80 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_KEY_SCAN_HPP_
+#define SRC_KEY_SCAN_HPP_
+
+#include <cstddef>
+
+/**
+ * Classification of the characters of a key in one pass.
+ *
+ * The usual characters of keys are [A-Za-z0-9:_-]. Whitespace are the characters accepted by
+ * isspace() in the C locale. Bytes of multi-byte UTF-8 characters are unusual.
+ *
+ * Keys are scanned in blocks of 32 bytes (AVX2) or 16 bytes (SSE2) if the compiler targets these
+ * instruction sets, byte by byte otherwise.
+ */
+namespace key_scan {
+
+    struct KeyClass {
+        /// length of the key in bytes
+        size_t length = 0;
+
+        /// true if the key contains a character outside [A-Za-z0-9:_-]
+        bool unusual = false;
+
+        /// true if the key contains whitespace
+        bool whitespace = false;
+    };
+
+    /**
+     * Check if a character is an accepted character for keys.
+     */
+    inline bool is_usual_character(const char character) noexcept {
+        return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z')
+            || (character >= '0' && character <= '9') || character == ':' || character == '_'
+            || character == '-';
+    }
+
+    inline bool is_whitespace(const char character) noexcept {
+        return character == ' ' || (character >= '\t' && character <= '\r');
+    }
+
+    /**
+     * Classify a key byte by byte.
+     */
+    KeyClass scan_scalar(const char* key) noexcept;
+
+    /**
+     * Classify a key using the widest vector instructions available.
+     *
+     * The blocks are read from aligned addresses. Therefore, bytes before the start and after the
+     * end of the string may be read, but never outside the memory pages the string is located in.
+     */
+    KeyClass scan(const char* key) noexcept;
+
+    /**
+     * Name of the implementation used by scan() ("avx2", "sse2" or "scalar")
+     */
+    const char* implementation() noexcept;
+
+} // namespace key_scan
+
+#endif /* SRC_KEY_SCAN_HPP_ */
@@ -0,0 +1,222 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "member_id_store.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <functional>
+#include <queue>
+#include <system_error>
+#include <utility>
+
+namespace {
+
+    FILE* open_temporary_file() {
+        FILE* file = std::tmpfile();
+        if (!file) {
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary file"};
+        }
+        return file;
+    }
+
+    void write_ids(FILE* file, const int64_t* ids, const size_t count) {
+        if (count && std::fwrite(ids, sizeof(int64_t), count, file) != count) {
+            throw std::system_error{errno, std::system_category(), "Failed to write to temporary file"};
+        }
+    }
+
+    /**
+     * Buffered reader of a sorted run.
+     */
+    class RunReader {
+        FILE* m_file;
+        std::vector<int64_t> m_buffer;
+        size_t m_pos = 0;
+        size_t m_count = 0;
+
+    public:
+        RunReader(FILE* file, const size_t buffer_size) :
+            m_file(file),
+            m_buffer(buffer_size) {
+            std::rewind(m_file);
+        }
+
+        /**
+         * Get the next ID of the run.
+         *
+         * \returns false if the run is exhausted
+         */
+        bool next(int64_t& id) {
+            if (m_pos == m_count) {
+                m_count = std::fread(m_buffer.data(), sizeof(int64_t), m_buffer.size(), m_file);
+                m_pos = 0;
+                if (m_count == 0) {
+                    return false;
+                }
+            }
+            id = m_buffer[m_pos++];
+            return true;
+        }
+    };
+
+} // namespace
+
+constexpr size_t MemberIdStore::IO_BLOCK_SIZE;
+
+MemberIdStore::MemberIdStore(const size_t max_memory) :
+    m_max_ids_in_memory(max_memory / sizeof(id_type)) {
+}
+
+MemberIdStore::~MemberIdStore() {
+    for (FILE* run : m_runs) {
+        std::fclose(run);
+    }
+    if (m_merged) {
+        std::fclose(m_merged);
+    }
+}
+
+void MemberIdStore::add(const id_type id) {
+    m_ids.push_back(id);
+    if (m_max_ids_in_memory && m_ids.size() >= m_max_ids_in_memory) {
+        spill();
+    }
+}
+
+void MemberIdStore::spill() {
+    std::sort(m_ids.begin(), m_ids.end());
+    m_ids.erase(std::unique(m_ids.begin(), m_ids.end()), m_ids.end());
+    FILE* run = open_temporary_file();
+    m_runs.push_back(run);
+    write_ids(run, m_ids.data(), m_ids.size());
+    m_ids.clear();
+}
+
+void MemberIdStore::merge_runs() {
+    // Every run gets a share of the memory budget as its read buffer.
+    const size_t buffer_size = std::max(IO_BLOCK_SIZE / 8,
+            std::min(IO_BLOCK_SIZE, m_max_ids_in_memory / (m_runs.size() + 1)));
+    std::vector<RunReader> readers;
+    readers.reserve(m_runs.size());
+    using entry_type = std::pair<id_type, size_t>;
+    std::priority_queue<entry_type, std::vector<entry_type>, std::greater<entry_type>> queue;
+    for (size_t i = 0; i < m_runs.size(); ++i) {
+        readers.emplace_back(m_runs[i], buffer_size);
+        id_type id;
+        if (readers.back().next(id)) {
+            queue.emplace(id, i);
+        }
+    }
+
+    m_merged = open_temporary_file();
+    std::vector<id_type> out;
+    out.reserve(buffer_size);
+    bool first = true;
+    id_type previous = 0;
+    while (!queue.empty()) {
+        const entry_type top = queue.top();
+        queue.pop();
+        if (first || top.first != previous) {
+            out.push_back(top.first);
+            previous = top.first;
+            first = false;
+            ++m_size;
+            if (out.size() == buffer_size) {
+                write_ids(m_merged, out.data(), out.size());
+                out.clear();
+            }
+        }
+        id_type id;
+        if (readers[top.second].next(id)) {
+            queue.emplace(id, top.second);
+        }
+    }
+    write_ids(m_merged, out.data(), out.size());
+    if (std::fflush(m_merged) != 0) {
+        throw std::system_error{errno, std::system_category(), "Failed to write to temporary file"};
+    }
+
+    // The runs are not needed any more.
+    for (FILE* run : m_runs) {
+        std::fclose(run);
+    }
+    m_runs.clear();
+}
+
+void MemberIdStore::prepare() {
+    if (m_prepared) {
+        return;
+    }
+    m_prepared = true;
+    if (m_runs.empty()) {
+        std::sort(m_ids.begin(), m_ids.end());
+        m_ids.erase(std::unique(m_ids.begin(), m_ids.end()), m_ids.end());
+        m_ids.shrink_to_fit();
+        m_size = m_ids.size();
+        return;
+    }
+    if (!m_ids.empty()) {
+        spill();
+    }
+    std::vector<id_type>().swap(m_ids);
+    merge_runs();
+    m_block.reserve(IO_BLOCK_SIZE);
+    rewind();
+}
+
+void MemberIdStore::rewind() {
+    std::rewind(m_merged);
+    m_block.clear();
+    m_block_pos = 0;
+    read_block();
+}
+
+bool MemberIdStore::read_block() {
+    m_block.resize(IO_BLOCK_SIZE);
+    const size_t count = std::fread(m_block.data(), sizeof(id_type), IO_BLOCK_SIZE, m_merged);
+    m_block.resize(count);
+    m_block_pos = 0;
+    return count > 0;
+}
+
+bool MemberIdStore::contains(const id_type id) {
+    if (!m_merged) {
+        return std::binary_search(m_ids.begin(), m_ids.end(), id);
+    }
+    if (id < m_last_query) {
+        rewind();
+    }
+    m_last_query = id;
+    while (true) {
+        if (m_block_pos == m_block.size()) {
+            if (!read_block()) {
+                return false;
+            }
+        }
+        // Skip whole blocks if possible.
+        if (m_block.back() < id) {
+            m_block_pos = m_block.size();
+            continue;
+        }
+        auto it = std::lower_bound(m_block.begin() + m_block_pos, m_block.end(), id);
+        m_block_pos = it - m_block.begin();
+        return *it == id;
+    }
+}
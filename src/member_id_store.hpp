@@ -0,0 +1,136 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_MEMBER_ID_STORE_HPP_
+#define SRC_MEMBER_ID_STORE_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/**
+ * Set of member IDs of relations with a memory budget.
+ *
+ * IDs are added during the relation pass. If the IDs in memory exceed the budget, they are sorted
+ * and written as a sorted run to a temporary file. prepare() merges all runs into a single sorted
+ * file which is streamed back during the way pass.
+ *
+ * Lookups are cheapest if the IDs are queried in ascending order (as ways are sorted by ID in OSM
+ * files). A lookup with an ID smaller than the previous one rewinds the stream.
+ */
+class MemberIdStore {
+
+    using id_type = int64_t;
+
+    /// number of IDs read from or written to a temporary file at once
+    static constexpr size_t IO_BLOCK_SIZE = 64 * 1024;
+
+    /// maximum number of IDs kept in memory before they are spilled to disk, 0 = unlimited
+    size_t m_max_ids_in_memory;
+
+    /// IDs added since the last spill, sorted and unique after prepare() if nothing was spilled
+    std::vector<id_type> m_ids;
+
+    /// sorted runs written to disk
+    std::vector<FILE*> m_runs;
+
+    /// all IDs sorted and without duplicates (only used if IDs were spilled)
+    FILE* m_merged = nullptr;
+
+    /// number of unique IDs after prepare()
+    size_t m_size = 0;
+
+    /// read buffer of m_merged
+    std::vector<id_type> m_block;
+    size_t m_block_pos = 0;
+
+    /// last ID queried
+    id_type m_last_query = 0;
+
+    bool m_prepared = false;
+
+    /**
+     * Sort IDs in memory and write them to a new temporary file.
+     */
+    void spill();
+
+    /**
+     * Merge all sorted runs into a single file without duplicates.
+     */
+    void merge_runs();
+
+    /**
+     * Start reading the merged file from its beginning.
+     */
+    void rewind();
+
+    /**
+     * Read the next block of the merged file into m_block.
+     *
+     * \returns false if the end of the file is reached
+     */
+    bool read_block();
+
+public:
+
+    /**
+     * \param max_memory memory budget in bytes, 0 = no limit
+     */
+    explicit MemberIdStore(const size_t max_memory = 0);
+
+    MemberIdStore(const MemberIdStore&) = delete;
+    MemberIdStore& operator=(const MemberIdStore&) = delete;
+
+    ~MemberIdStore();
+
+    void add(const id_type id);
+
+    /**
+     * Finish adding IDs and prepare the store for lookups. add() must not be called afterwards.
+     */
+    void prepare();
+
+    /**
+     * Check if an ID was added. prepare() must have been called before.
+     */
+    bool contains(const id_type id);
+
+    /**
+     * Number of unique IDs in the store (only valid after prepare()).
+     */
+    size_t size() const noexcept {
+        return m_size;
+    }
+
+    /**
+     * Check if IDs were spilled to disk.
+     */
+    bool spilled() const noexcept {
+        return m_merged || !m_runs.empty();
+    }
+
+    /**
+     * Memory in bytes used for IDs.
+     */
+    size_t used_memory() const noexcept {
+        return (m_ids.capacity() + m_block.capacity()) * sizeof(id_type);
+    }
+};
+
+#endif /* SRC_MEMBER_ID_STORE_HPP_ */
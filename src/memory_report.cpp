@@ -0,0 +1,100 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "memory_report.hpp"
+
+#include <sys/resource.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+    /**
+     * Read a value (in kB) from /proc/self/status.
+     *
+     * \returns value in bytes or 0 if it is not available
+     */
+    uint64_t read_proc_status(const char* key) {
+        FILE* file = fopen("/proc/self/status", "r");
+        if (!file) {
+            return 0;
+        }
+        const size_t key_length = strlen(key);
+        char line[256];
+        uint64_t value = 0;
+        while (fgets(line, sizeof(line), file)) {
+            if (!strncmp(line, key, key_length) && line[key_length] == ':') {
+                value = strtoull(line + key_length + 1, nullptr, 10) * 1024;
+                break;
+            }
+        }
+        fclose(file);
+        return value;
+    }
+
+    std::string format_megabytes(const uint64_t bytes) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%10.1f MB", bytes / (1024.0 * 1024.0));
+        return buffer;
+    }
+
+} // namespace
+
+MemoryReport::MemoryReport(const std::string& title) :
+    m_title(title),
+    m_entries() {
+}
+
+void MemoryReport::add(const std::string& name, const uint64_t bytes) {
+    m_entries.emplace_back(name, bytes);
+}
+
+uint64_t MemoryReport::current_rss() {
+    return read_proc_status("VmRSS");
+}
+
+uint64_t MemoryReport::peak_rss() {
+    uint64_t peak = read_proc_status("VmHWM");
+    if (peak == 0) {
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+            peak = static_cast<uint64_t>(usage.ru_maxrss);
+#else
+            peak = static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+        }
+    }
+    return peak;
+}
+
+void MemoryReport::print() const {
+    std::cerr << "Memory usage after " << m_title << ":\n";
+    const uint64_t current = current_rss();
+    const uint64_t peak = std::max(peak_rss(), current);
+    std::cerr << "  " << std::left << std::setw(40) << "peak RSS" << format_megabytes(peak) << '\n';
+    std::cerr << "  " << std::left << std::setw(40) << "current RSS" << format_megabytes(current) << '\n';
+    for (const auto& entry : m_entries) {
+        std::cerr << "  " << std::left << std::setw(40) << entry.first << format_megabytes(entry.second) << '\n';
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_MEMORY_REPORT_HPP_
+#define SRC_MEMORY_REPORT_HPP_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Report of the memory usage of the process and of its major data structures.
+ *
+ * Usage: Add the sizes of all structures of interest using add() and print the report with print().
+ */
+class MemoryReport {
+
+    std::string m_title;
+
+    std::vector<std::pair<std::string, uint64_t>> m_entries;
+
+public:
+    /**
+     * \param title title of the report, e.g. the name of the pass
+     */
+    explicit MemoryReport(const std::string& title);
+
+    /**
+     * Add the size of a data structure.
+     *
+     * \param name name of the data structure
+     * \param bytes size in bytes
+     */
+    void add(const std::string& name, const uint64_t bytes);
+
+    /**
+     * Print the report to stderr.
+     */
+    void print() const;
+
+    /**
+     * Current resident set size of the process in bytes (0 if unknown)
+     */
+    static uint64_t current_rss();
+
+    /**
+     * Peak resident set size of the process in bytes (0 if unknown)
+     */
+    static uint64_t peak_rss();
+};
+
+#endif /* SRC_MEMORY_REPORT_HPP_ */
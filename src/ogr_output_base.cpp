@@ -20,37 +20,51 @@
 
 #include "ogr_output_base.hpp"
 
+#include <cstring>
+#include <limits>
+
+#include "utf8.hpp"
+
 OGROutputBase::OGROutputBase(Options& options) :
 #ifndef ONLYMERCATOROUTPUT
         m_factory(osmium::geom::Projection(options.srs)),
 #endif
         m_options(options) { }
 
-std::vector<std::string> OGROutputBase::get_gdal_default_dataset_options() {
-    std::vector<std::string> default_options;
-    // default layer creation options
-    if (m_options.output_format == "SQlite") {
-        CPLSetConfigOption("OGR_SQLITE_PRAGMA", "journal_mode=OFF,TEMP_STORE=MEMORY,temp_store=memory,LOCKING_MODE=EXCLUSIVE");
-        CPLSetConfigOption("OGR_SQLITE_CACHE", "600");
-        CPLSetConfigOption("OGR_SQLITE_JOURNAL", "OFF");
-        CPLSetConfigOption("OGR_SQLITE_SYNCHRONOUS", "OFF");
-        default_options.emplace_back("SPATIALITE=YES");
-    } else if (m_options.output_format == "ESRI Shapefile") {
-        default_options.emplace_back("SHAPE_ENCODING=UTF8");
+/*static*/ void OGROutputBase::set_text_field(gdalcpp::Feature& feature, const char* field_name,
+        const char* value, const size_t max_length /*= NO_LENGTH_LIMIT*/) {
+    const size_t length = std::strlen(value);
+    if (length <= max_length && utf8::is_valid(value, length)) {
+        feature.set_field(field_name, value);
+        return;
     }
+    feature.set_field(field_name, utf8::sanitize(value, length, max_length).c_str());
+}
+
+constexpr uint64_t OGROutputBase::TRANSACTION_SIZE;
 
-    return default_options;
+void enable_transactions(gdalcpp::Dataset& dataset) {
+    // gdalcpp never reaches this number of edits, i.e. it starts transactions but does not commit them.
+    dataset.enable_auto_transactions(std::numeric_limits<uint64_t>::max());
 }
 
-std::vector<std::string> OGROutputBase::get_gdal_default_layer_options() {
-    std::vector<std::string> default_options;
-    // default layer creation options
-    if (m_options.output_format == "SQlite") {
-        default_options.emplace_back("SPATIAL_INDEX=NO");
-        default_options.emplace_back("COMPRESS_GEOM=NO");
-    } else if (m_options.output_format == "ESRI Shapefile") {
-        default_options.emplace_back("SHAPE_ENCODING=UTF8");
+void OGROutputBase::write_feature(gdalcpp::Feature& feature, gdalcpp::Layer& layer) {
+    feature.add_to_layer();
+    gdalcpp::Dataset& dataset = layer.dataset();
+    uint64_t& count = m_uncommitted_features[&dataset];
+    if (++count < TRANSACTION_SIZE) {
+        return;
     }
+    // The feature has just been added, i.e. a transaction is open.
+    TraceScope scope{m_options.tracer, "commit " + dataset.dataset_name(), "output"};
+    dataset.commit_transaction();
+    count = 0;
+}
 
-    return default_options;
+std::vector<std::string> OGROutputBase::get_gdal_default_dataset_options() {
+    return gdal_default_dataset_options(m_options);
+}
+
+std::vector<std::string> OGROutputBase::get_gdal_default_layer_options() {
+    return gdal_default_layer_options(m_options);
 }
@@ -21,6 +21,10 @@
 #ifndef SRC_OGR_OUTPUT_BASE_HPP_
 #define SRC_OGR_OUTPUT_BASE_HPP_
 
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
 #include <gdalcpp.hpp>
 
 #include <osmium/geom/ogr.hpp>
@@ -46,43 +50,65 @@
     using ogr_factory_type = osmium::geom::OGRFactory<osmium::geom::Projection>;
 #endif
 
+/**
+ * Let gdalcpp start a transaction before the first feature is written to the dataset and after
+ * every commit. The transactions are committed by OGROutputBase::write_feature() (or when the
+ * dataset is closed), not by gdalcpp, to have the commits traced.
+ */
+void enable_transactions(gdalcpp::Dataset& dataset);
+
 /**
  * Provide commont things for working with GDAL. This class does not care for the dataset
  * because the dataset is shared.
  */
 class OGROutputBase {
+public:
+    /// maximum length of a string field
+    static constexpr size_t MAX_FIELD_LENGTH = 254;
+
 protected:
     ogr_factory_type m_factory;
 
     Options& m_options;
 
-    /// maximum length of a string field
-    static constexpr size_t MAX_FIELD_LENGTH = 254;
+    /// max_length of set_text_field() for fields of unlimited width
+    static constexpr size_t NO_LENGTH_LIMIT = std::numeric_limits<size_t>::max();
+
+    /// number of features added by this object to a dataset after which its transaction is committed
+    static constexpr uint64_t TRANSACTION_SIZE = 10000;
+
+    /// features added by this object to each dataset since the last commit
+    std::unordered_map<const gdalcpp::Dataset*, uint64_t> m_uncommitted_features;
 
     /**
-     * \brief Add default options for the to the back of a vector of options.
-     *
-     * Default dataset creation options are added at the *back* of the vector. If you read the vector in a later step
-     * to set them via the functions provided by the GDAL library, do it in reverse order. Otherwise
-     * the defaults will overwrite your explicitly set options.
+     * Add a feature to its layer and commit the transaction of the dataset after every
+     * TRANSACTION_SIZE features.
      *
-     * \param output_format output format
-     * \param gdal_options vector where to add the default options.
+     * \param feature feature to be added
+     * \param layer layer the feature was created for
+     */
+    void write_feature(gdalcpp::Feature& feature, gdalcpp::Layer& layer);
+
+    /**
+     * Default dataset creation options of the output format (see gdal_default_dataset_options())
      */
     std::vector<std::string> get_gdal_default_dataset_options();
 
     /**
-     * \brief Add default options for the to the back of a vector of options.
-     *
-     * Default layer creation options are added at the *back* of the vector. If you read the vector in a later step
-     * to set them via the functions provided by the GDAL library, do it in reverse order. Otherwise
-     * the defaults will overwrite your explicitly set options.
-     *
-     * \param output_format output format
-     * \param gdal_options vector where to add the default options.
+     * Default layer creation options of the output format (see gdal_default_layer_options())
      */
     std::vector<std::string> get_gdal_default_layer_options();
 
+    /**
+     * \brief Set a string field of a feature to a value taken from OSM data.
+     *
+     * Bytes which are not valid UTF-8 are replaced by '?'. Values are not cut by default. Pass the
+     * width of the field as max_length if it is limited, longer values are cut without splitting a
+     * multi-byte character then.
+     */
+    static void set_text_field(gdalcpp::Feature& feature, const char* field_name, const char* value,
+            const size_t max_length = NO_LENGTH_LIMIT);
+
 public:
     OGROutputBase() = delete;
 
@@ -8,6 +8,12 @@
 #ifndef SRC_OPTIONS_HPP_
 #define SRC_OPTIONS_HPP_
 
+#include "check_rules.hpp"
+#include "output_options.hpp"
+#include "shard.hpp"
+#include "tracer.hpp"
+#include "verbose_output.hpp"
+
 /**
  * Available views
  */
@@ -16,19 +22,52 @@ enum class ViewType : char {
     places= 1,
     geometry= 2,
     highways= 3,
-    tagging= 4
+    tagging= 4,
+    topology= 5
 };
 
 /**
- * options for program execution
+ * options for program execution (the options of the output datasets are inherited)
  */
-struct Options {
+struct Options : public OutputOptions {
     std::vector<ViewType> views;
     std::string location_index_type = "sparse_mem_array";
-    std::string output_format = "SQlite";
-    std::string output_directory = "";
     int srs = 3857;
-    osmium::util::VerboseOutput verbose_output {false};
+    /// spatial shard to be processed (whole planet by default)
+    Shard shard;
+    /**
+     * memory budget in bytes, 0 = unlimited. Each of the following structures is limited on its
+     * own: member IDs of relations (tagging view), ways kept in single-pass mode and place
+     * relations with their member ways are spilled to disk, place areas being assembled block the
+     * collector and the segments of the crossing index are processed in batches. The location
+     * index and the output are not covered.
+     */
+    size_t max_memory = 0;
+    /**
+     * read the input only once (required for stdin), ways depending on relations are kept until
+     * the relations have been read
+     */
+    bool single_pass = false;
+    /// print the progress of each pass to stderr
+    bool progress = false;
+    /// file the progress of each pass is written to (empty = none)
+    std::string progress_file = "";
+    /// interval of progress reports in seconds
+    int progress_interval = 10;
+    /// print a memory report after every pass
+    bool memory_report = false;
+    /// parts of the road network with less ways are reported as islands by the highways view
+    size_t island_max_ways = 5;
+    /// parts of the road network shorter than this (metres) are reported as islands by the highways view
+    double island_max_length = 1000;
+    /// memory budget in bytes of the hash table of the duplicate ways check of the geometry view
+    size_t duplicate_ways_max_memory = 4096UL * 1024 * 1024;
+    /// checks of allowed tag values, loaded from the rules file or the built-in rules
+    CheckRules rules;
+    /// timeline of the pipeline stages (disabled unless --trace is given)
+    Tracer tracer;
+    /// progress messages (-v), may be written by several threads
+    VerboseOutput verbose_output {false};
 };
 
 
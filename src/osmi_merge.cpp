@@ -0,0 +1,208 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * osmi_merge concatenates the output datasets of the shards of a sharded run
+ * (osmi_simple_views --shard=I/N) layer by layer into a single dataset.
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <getopt.h>
+
+#include <gdal_priv.h>
+#include <ogrsf_frmts.h>
+
+#include <osmium/util/verbose_output.hpp>
+
+#include "output_options.hpp"
+
+/**
+ * Options of osmi_merge. The output dataset is created with the same GDAL options
+ * osmi_simple_views uses for its own output.
+ */
+struct MergeOptions : public OutputOptions {
+    osmium::util::VerboseOutput verbose_output {false};
+};
+
+/**
+ * Close a dataset opened or created by GDAL.
+ */
+struct GDALDatasetCloser {
+    void operator()(GDALDataset* dataset) const {
+        GDALClose(dataset);
+    }
+};
+
+using dataset_ptr_type = std::unique_ptr<GDALDataset, GDALDatasetCloser>;
+
+/**
+ * Convert a vector of strings into a NULL-terminated list of C strings as expected by GDAL.
+ */
+std::vector<char*> to_gdal_options(std::vector<std::string>& options) {
+    std::vector<char*> result;
+    for (auto& o : options) {
+        result.push_back(&o[0]);
+    }
+    result.push_back(nullptr);
+    return result;
+}
+
+void print_help(char* arg0) {
+    std::cerr << "Usage: " << arg0 << " [OPTIONS] OUTPUT_DATASET INPUT_DATASET...\n" \
+              << "Merge the output datasets of the shards of a sharded run layer by layer.\n" \
+              << "Options:\n" \
+              << "  -h, --help           This help message.\n" \
+              << "  -f, --format         Output format (default: SQlite)\n" \
+              << "  -v, --verbose        Verbose output\n";
+}
+
+/**
+ * Get the layer of the output dataset with the same name as the input layer or create it with the
+ * same geometry type, SRS and fields.
+ *
+ * \param layer_options NULL-terminated layer creation options (the same osmi_simple_views uses)
+ */
+OGRLayer* get_or_create_layer(GDALDataset& output, OGRLayer& input_layer, char** layer_options) {
+    OGRLayer* layer = output.GetLayerByName(input_layer.GetName());
+    if (layer) {
+        return layer;
+    }
+    OGRFeatureDefn* input_defn = input_layer.GetLayerDefn();
+    layer = output.CreateLayer(input_layer.GetName(), input_layer.GetSpatialRef(), input_layer.GetGeomType(), layer_options);
+    if (!layer) {
+        throw std::runtime_error{std::string{"Failed to create layer "} + input_layer.GetName()};
+    }
+    for (int i = 0; i < input_defn->GetFieldCount(); ++i) {
+        if (layer->CreateField(input_defn->GetFieldDefn(i)) != OGRERR_NONE) {
+            throw std::runtime_error{std::string{"Failed to create field "} + input_defn->GetFieldDefn(i)->GetNameRef()};
+        }
+    }
+    return layer;
+}
+
+/**
+ * Append all features of the input layer to the output layer.
+ *
+ * \returns number of features copied
+ */
+uint64_t copy_features(GDALDataset& output, OGRLayer& input_layer, OGRLayer& output_layer) {
+    uint64_t count = 0;
+    input_layer.ResetReading();
+    output.StartTransaction();
+    std::unique_ptr<OGRFeature> input_feature;
+    while ((input_feature = std::unique_ptr<OGRFeature>(input_layer.GetNextFeature()))) {
+        std::unique_ptr<OGRFeature> feature {OGRFeature::CreateFeature(output_layer.GetLayerDefn())};
+        // fields are matched by name because the field order of the shards may differ
+        feature->SetFrom(input_feature.get(), TRUE);
+        if (output_layer.CreateFeature(feature.get()) != OGRERR_NONE) {
+            throw std::runtime_error{std::string{"Failed to write feature to layer "} + output_layer.GetName()};
+        }
+        ++count;
+        if (count % 10000 == 0) {
+            output.CommitTransaction();
+            output.StartTransaction();
+        }
+    }
+    output.CommitTransaction();
+    return count;
+}
+
+int main(int argc, char* argv[]) {
+    static struct option long_options[] = {
+        {"help",   no_argument, 0, 'h'},
+        {"format", required_argument, 0, 'f'},
+        {"verbose",   no_argument, 0, 'v'},
+        {0, 0, 0, 0}
+    };
+
+    MergeOptions options;
+
+    while (true) {
+        int c = getopt_long(argc, argv, "hf:v", long_options, 0);
+        if (c == -1) {
+            break;
+        }
+
+        switch (c) {
+            case 'h':
+                print_help(argv[0]);
+                exit(1);
+            case 'f':
+                options.output_format = optarg;
+                break;
+            case 'v':
+                options.verbose_output.verbose(true);
+                break;
+            default:
+                print_help(argv[0]);
+                exit(1);
+        }
+    }
+
+    if (argc - optind < 2) {
+        print_help(argv[0]);
+        exit(1);
+    }
+    const std::string output_filename = argv[optind];
+
+    GDALAllRegister();
+    GDALDriver* driver = GetGDALDriverManager()->GetDriverByName(options.output_format.c_str());
+    if (!driver) {
+        std::cerr << "ERROR: Unknown output format " << options.output_format << '\n';
+        exit(1);
+    }
+    std::vector<std::string> dataset_options = gdal_default_dataset_options(options);
+    std::vector<char*> gdal_dataset_options = to_gdal_options(dataset_options);
+    dataset_ptr_type output {driver->Create(output_filename.c_str(), 0, 0, 0, GDT_Unknown,
+            gdal_dataset_options.data())};
+    std::vector<std::string> layer_options = gdal_default_layer_options(options);
+    std::vector<char*> gdal_layer_options = to_gdal_options(layer_options);
+    if (!output) {
+        std::cerr << "ERROR: Failed to create " << output_filename << '\n';
+        exit(1);
+    }
+
+    try {
+        for (int i = optind + 1; i < argc; ++i) {
+            options.verbose_output << "Merging " << argv[i] << " ...\n";
+            dataset_ptr_type input {static_cast<GDALDataset*>(GDALOpenEx(argv[i],
+                    GDAL_OF_VECTOR | GDAL_OF_READONLY, nullptr, nullptr, nullptr))};
+            if (!input) {
+                std::cerr << "ERROR: Failed to open " << argv[i] << '\n';
+                exit(1);
+            }
+            for (int l = 0; l < input->GetLayerCount(); ++l) {
+                OGRLayer* input_layer = input->GetLayer(l);
+                OGRLayer* output_layer = get_or_create_layer(*output, *input_layer, gdal_layer_options.data());
+                uint64_t count = copy_features(*output, *input_layer, *output_layer);
+                options.verbose_output << "  " << input_layer->GetName() << ": " << count << " features\n";
+            }
+        }
+    } catch (std::runtime_error& err) {
+        std::cerr << "ERROR: " << err.what() << '\n';
+        exit(1);
+    }
+    output.reset();
+    options.verbose_output << "done\n";
+}
@@ -17,12 +17,13 @@
  *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <string>
 #include <iostream>
+#include <stdexcept>
 #include <getopt.h>
 
 #include <osmium/area/assembler.hpp>
-#include <osmium/area/multipolygon_collector.hpp>
 // the indexes themselves have to be included first
 #include <osmium/index/map/dense_mmap_array.hpp>
 #include <osmium/index/map/sparse_mmap_array.hpp>
@@ -30,27 +31,155 @@
 #include <osmium/index/map/sparse_mem_array.hpp>
 #include <osmium/handler/node_locations_for_ways.hpp>
 #include <osmium/io/any_input.hpp>
+#include <osmium/memory/buffer.hpp>
 #include <osmium/visitor.hpp>
 
 #include "any_relation_collector.hpp"
 #include "handler_collection.hpp"
+#include "memory_report.hpp"
+#include "places_area_collector.hpp"
+#include "progress_reporter.hpp"
+#include "shard.hpp"
 
 using index_type = osmium::index::map::Map<osmium::unsigned_object_id_type, osmium::Location>;
 using location_handler_type = osmium::handler::NodeLocationsForWays<index_type>;
+using shard_location_handler_type = ShardLocationsForWays<location_handler_type>;
+
+/**
+ * Apply a handler to a run of nodes without tags.
+ */
+template <typename THandler>
+int apply_untagged_nodes(osmium::memory::Buffer::iterator begin, osmium::memory::Buffer::iterator end,
+        THandler& handler) {
+    for (auto it = begin; it != end; ++it) {
+        handler.node(static_cast<const osmium::Node&>(*it));
+    }
+    return 0;
+}
+
+/**
+ * None of the views writes nodes without tags. They are not handed to the handler collection.
+ */
+int apply_untagged_nodes(osmium::memory::Buffer::iterator, osmium::memory::Buffer::iterator,
+        HandlerCollection&) {
+    return 0;
+}
+
+inline bool is_untagged_node(const osmium::memory::Item& item) {
+    return item.type() == osmium::item_type::node && static_cast<const osmium::Node&>(item).tags().empty();
+}
+
+/**
+ * Only the handler collection records the time spent in its handlers.
+ */
+template <typename THandler>
+int trace_handler(THandler&, const int64_t) {
+    return 0;
+}
+
+int trace_handler(HandlerCollection& handlers, const int64_t start) {
+    handlers.trace_handlers(start);
+    return 0;
+}
+
+template <typename THandler>
+int flush_handler(THandler& handler) {
+    handler.flush();
+    return 0;
+}
+
+/**
+ * Read the input buffer by buffer and apply the handlers to it (like osmium::apply).
+ *
+ * If tracing is enabled, the time spent waiting for the reader and for processing each buffer is
+ * recorded, together with the time spent in each view. The buffer is processed the same way with
+ * and without tracing.
+ */
+template <typename... THandlers>
+void apply_buffers(Tracer& tracer, osmium::io::Reader& reader, THandlers&... handlers) {
+    while (true) {
+        osmium::memory::Buffer buffer;
+        {
+            TraceScope scope{tracer, "read", "io"};
+            buffer = reader.read();
+        }
+        if (!buffer) {
+            break;
+        }
+        TraceScope scope{tracer, "buffer", "pass"};
+        auto it = buffer.begin();
+        while (it != buffer.end()) {
+            if (is_untagged_node(*it)) {
+                // Most nodes have no tags. They are only needed for the location index and
+                // are handed over run by run instead of object by object.
+                auto run_end = it;
+                do {
+                    ++run_end;
+                } while (run_end != buffer.end() && is_untagged_node(*run_end));
+                int dummy[] = {apply_untagged_nodes(it, run_end, handlers)...};
+                (void)dummy;
+                it = run_end;
+            } else {
+                osmium::apply_item(*it, handlers...);
+                ++it;
+            }
+        }
+        int dummy[] = {trace_handler(handlers, scope.start())...};
+        (void)dummy;
+    }
+    TraceScope scope{tracer, "flush", "pass"};
+    int dummy[] = {flush_handler(handlers)...};
+    (void)dummy;
+}
 
 void print_help(char* arg0) {
     std::cerr << "Usage: " << arg0 << " [OPTIONS] INPUT_FILE OUTPUT_DIRECTORY\n" \
               << "Options:\n" \
               << "  -h, --help           This help message.\n" \
               << "  -f, --format         Output format (default: SQlite)\n" \
+              << "                       Use PMTiles or MVT to write vector tiles of all layers of all\n" \
+              << "                       views into a single tile set.\n" \
               << "  -i, --index          Set index type for location index (default: sparse_mem_array)\n";
 #ifndef ONLYMERCATOROUTPUT
     std::cerr << "  -s EPSG, --srs=ESPG  Output projection (EPSG code) (default: 3857)\n";
 #endif
-    std::cerr << "  -t TYPE, --type=TYPE View to be produced (tagging, highways, places, geometry).\n" \
+    std::cerr << "  -t TYPE, --type=TYPE View to be produced (tagging, highways, places, geometry,\n" \
+              << "                       topology).\n" \
               << "                       Use `-t view1 -t view2` if you want to produce files of\n" \
               << "                       multiple views.\n" \
-              << "  -v, --verbose        Verbose output\n";
+              << "  -p, --progress       Print progress, throughput and ETA of each pass to stderr\n" \
+              << "  --progress-file=FILE Write progress, throughput and ETA of each pass to FILE\n" \
+              << "  --progress-interval=SEC Interval of progress reports in seconds (default: 10)\n" \
+              << "  -v, --verbose        Verbose output\n" \
+              << "  --memory-report      Print the memory usage of the process and its major data\n" \
+              << "                       structures after every pass\n" \
+              << "  --sqlite-cache=MB    SQLite page cache per output dataset (default: 600)\n" \
+              << "  --rules=FILE         Read the checks of allowed tag values from FILE\n" \
+              << "  --print-default-rules Print the built-in checks of allowed tag values in the\n" \
+              << "                       format of the rules file and exit\n" \
+              << "  --max-memory=MB      Memory budget of each of: relation member IDs, ways\n" \
+              << "                       kept in single-pass mode and place relations with their\n" \
+              << "                       member ways (spilled to temporary files), place areas\n" \
+              << "                       being assembled and the crossing index of the topology\n" \
+              << "                       view (processed in batches). The location index is not\n" \
+              << "                       covered (default: unlimited)\n" \
+              << "  --single-pass        Read the input only once (always enabled if the input is\n" \
+              << "                       read from stdin)\n" \
+              << "  --island-max-ways=N  Parts of the road network with less than N ways are\n" \
+              << "                       reported as islands by the highways view (default: 5)\n" \
+              << "  --island-max-length=KM Parts of the road network shorter than KM kilometres are\n" \
+              << "                       reported as islands by the highways view (default: 1)\n" \
+              << "  --duplicate-ways-memory=MB Memory budget of the duplicate ways check of the\n" \
+              << "                       geometry view (default: 4096)\n" \
+              << "  --shard=I/N          Process the I-th (counted from 0) of N shards only. The planet\n" \
+              << "                       is split into N stripes of equal width along the longitude\n" \
+              << "                       axis. Use osmi_merge to merge the output of all shards.\n" \
+              << "  --shard-overlap=DEG  Width of the zone around the shard whose node locations\n" \
+              << "                       are kept for ways crossing the shard border (default: 0.5)\n" \
+              << "  -x, --spatial-index  Build spatial indexes of all layers after all data has been\n" \
+              << "                       written (SQlite, GPKG and ESRI Shapefile only).\n" \
+              << "  -z, --min-zoom=ZOOM  Lowest zoom level of vector tile output (default: 0)\n" \
+              << "  -Z, --max-zoom=ZOOM  Highest zoom level of vector tile output (default: 14)\n";
 }
 
 int main(int argc, char* argv[]) {
@@ -62,13 +191,34 @@ int main(int argc, char* argv[]) {
         {"srs", required_argument, 0, 's'},
         {"type",   required_argument, 0, 't'},
         {"verbose",   no_argument, 0, 'v'},
+        {"spatial-index", no_argument, 0, 'x'},
+        {"shard", required_argument, 0, 200},
+        {"shard-overlap", required_argument, 0, 201},
+        {"max-memory", required_argument, 0, 202},
+        {"progress", no_argument, 0, 'p'},
+        {"progress-file", required_argument, 0, 203},
+        {"progress-interval", required_argument, 0, 204},
+        {"trace", required_argument, 0, 205},
+        {"memory-report", no_argument, 0, 206},
+        {"sqlite-cache", required_argument, 0, 207},
+        {"rules", required_argument, 0, 208},
+        {"print-default-rules", no_argument, 0, 209},
+        {"single-pass", no_argument, 0, 210},
+        {"island-max-ways", required_argument, 0, 211},
+        {"island-max-length", required_argument, 0, 212},
+        {"duplicate-ways-memory", required_argument, 0, 213},
+        {"min-zoom", required_argument, 0, 'z'},
+        {"max-zoom", required_argument, 0, 'Z'},
         {0, 0, 0, 0}
     };
 
     Options options;
+    const char* shard_spec = nullptr;
+    const char* rules_file = nullptr;
+    double shard_overlap = 0.5;
 
     while (true) {
-        int c = getopt_long(argc, argv, "hf:i:s:t:v", long_options, 0);
+        int c = getopt_long(argc, argv, "hf:i:ps:t:vxz:Z:", long_options, 0);
         if (c == -1) {
             break;
         }
@@ -117,8 +267,10 @@ int main(int argc, char* argv[]) {
                     options.views.push_back(ViewType::highways);
                 } else if (!strcmp(optarg, "places")) {
                     options.views.push_back(ViewType::places);
+                } else if (!strcmp(optarg, "topology")) {
+                    options.views.push_back(ViewType::topology);
                 } else {
-                    std::cerr << "ERROR: -t must be one of tagging, geometry, highways, places\n";
+                    std::cerr << "ERROR: -t must be one of tagging, geometry, highways, places, topology\n";
                     print_help(argv[0]);
                     exit(1);
                 }
@@ -126,6 +278,63 @@ int main(int argc, char* argv[]) {
             case 'v':
                 options.verbose_output.verbose(true);
                 break;
+            case 'x':
+                options.spatial_index = true;
+                break;
+            case 200:
+                shard_spec = optarg;
+                break;
+            case 201:
+                shard_overlap = atof(optarg);
+                break;
+            case 202:
+                options.max_memory = static_cast<size_t>(atol(optarg)) * 1024 * 1024;
+                break;
+            case 'p':
+                options.progress = true;
+                break;
+            case 203:
+                options.progress_file = optarg;
+                break;
+            case 204:
+                options.progress_interval = std::max(atoi(optarg), 1);
+                break;
+            case 205:
+                if (!options.tracer.open(optarg)) {
+                    std::cerr << "ERROR: Failed to open trace file " << optarg << '\n';
+                    exit(1);
+                }
+                break;
+            case 206:
+                options.memory_report = true;
+                break;
+            case 207:
+                options.sqlite_cache = std::max(atoi(optarg), 1);
+                break;
+            case 208:
+                rules_file = optarg;
+                break;
+            case 209:
+                std::cout << CheckRules::default_rules();
+                exit(0);
+            case 210:
+                options.single_pass = true;
+                break;
+            case 211:
+                options.island_max_ways = static_cast<size_t>(std::max(atol(optarg), 0L));
+                break;
+            case 212:
+                options.island_max_length = std::max(atof(optarg), 0.0) * 1000;
+                break;
+            case 213:
+                options.duplicate_ways_max_memory = static_cast<size_t>(std::max(atol(optarg), 1L)) * 1024 * 1024;
+                break;
+            case 'z':
+                options.min_zoom = atoi(optarg);
+                break;
+            case 'Z':
+                options.max_zoom = atoi(optarg);
+                break;
             default:
                 print_help(argv[0]);
                 exit(1);
@@ -149,13 +358,53 @@ int main(int argc, char* argv[]) {
         exit(1);
     }
 
+    // Standard input cannot be read twice.
+    if (input_filename == "-") {
+        options.single_pass = true;
+    }
+
+    if (shard_spec && !options.shard.parse(shard_spec, shard_overlap)) {
+        std::cerr << "ERROR: --shard must be I/N with 0 <= I < N, --shard-overlap must be between 0 and 180.\n";
+        print_help(argv[0]);
+        exit(1);
+    }
+
+    try {
+        if (rules_file) {
+            options.rules.load_file(rules_file);
+        } else {
+            options.rules.load_string(CheckRules::default_rules());
+        }
+    } catch (CheckRulesError& err) {
+        std::cerr << "ERROR: " << err.what() << '\n';
+        exit(1);
+    }
+    if (std::find(options.views.begin(), options.views.end(), ViewType::places) != options.views.end()
+            && !options.rules.find("place_type")) {
+        std::cerr << "ERROR: The places view requires the check place_type in the rules file.\n";
+        exit(1);
+    }
+
+    if (options.vector_tile_output()) {
+        if (options.srs != 3857) {
+            std::cerr << "ERROR: Vector tile output requires output projection EPSG:3857.\n";
+            exit(1);
+        }
+        if (options.min_zoom < 0 || options.max_zoom > 22 || options.min_zoom > options.max_zoom) {
+            std::cerr << "ERROR: Zoom levels of vector tile output must satisfy 0 <= min-zoom <= max-zoom <= 22.\n";
+            exit(1);
+        }
+    }
+
     const auto& map_factory = osmium::index::MapFactory<osmium::unsigned_object_id_type, osmium::Location>::instance();
     auto location_index = map_factory.create_map(options.location_index_type);
     location_handler_type location_handler(*location_index);
     location_handler.ignore_errors();
+    // only keeps locations inside the shard and its overlap zone if the planet is processed in shards
+    shard_location_handler_type shard_location_handler(location_handler, options.shard);
 
     osmium::area::Assembler::config_type assembler_config;
-    osmium::area::MultipolygonCollector<osmium::area::Assembler> collector(assembler_config);
+    PlacesAreaCollector places_collector(options, assembler_config);
     HandlerCollection handlers {options};
     {
         // This section enclosed by curly braces ensures that any_collector is destroyed and does
@@ -163,42 +412,113 @@ int main(int argc, char* argv[]) {
         // TaggingViewHandler::close is called.
         int pass_count = 1;
         AnyRelationCollector any_collector(options);
+        ProgressReporter progress(options);
+
+        auto print_memory_report = [&](const int pass) {
+            if (!options.memory_report) {
+                return;
+            }
+            MemoryReport report("pass " + std::to_string(pass));
+            report.add("location index (" + options.location_index_type + ")", location_index->used_memory());
+            report.add("relation members (tagging)", any_collector.used_memory());
+            report.add("place area collector", places_collector.used_memory());
+            report.add("place areas for the join (places)", handlers.places_join_memory());
+            report.add("road network islands (highways)", handlers.road_network_memory());
+            // The table is allocated with the size of its budget, only the pages written to are resident.
+            report.add("duplicate ways table (geometry, maximum)", handlers.duplicate_ways_memory());
+            report.add("crossing index (topology)", handlers.crossing_index_memory());
+            if (options.output_format == "SQlite") {
+                // upper bound, SQLite allocates its page cache on demand
+                const size_t datasets = handlers.dataset_count();
+                report.add("SQLite cache (" + std::to_string(datasets) + " datasets x "
+                        + std::to_string(options.sqlite_cache) + " MB, maximum)",
+                        static_cast<uint64_t>(datasets) * options.sqlite_cache * 1024 * 1024);
+            }
+            report.print();
+        };
 
         // additional passes for views which use relations
         for (auto vt : options.views) {
+            if (options.single_pass) {
+                // The relations are read together with the nodes and ways.
+                break;
+            }
             if (vt == ViewType::places) {
                 options.verbose_output << "Pass " << pass_count << " (Multipolygons) ...\n";
                 osmium::io::Reader reader1(input_filename, osmium::osm_entity_bits::relation);
+                // The collector reads the file on its own, progress is reported based on the file offset only.
+                progress.start_pass("Pass " + std::to_string(pass_count), reader1);
+                {
+                    TraceScope scope{options.tracer, "pass " + std::to_string(pass_count) + " (multipolygons)", "pass"};
+                    places_collector.read_relations(reader1);
+                }
+                progress.end_pass();
                 reader1.close();
                 options.verbose_output << "Pass " << pass_count << " done\n";
+                print_memory_report(pass_count);
                 ++pass_count;
             } else if (vt == ViewType::tagging) {
                 options.verbose_output << "Pass " << pass_count << " (Relations) ...\n";
                 osmium::io::Reader reader1(input_filename, osmium::osm_entity_bits::relation);
-                any_collector.read_relations(reader1);
+                progress.start_pass("Pass " + std::to_string(pass_count), reader1);
+                {
+                    TraceScope scope{options.tracer, "pass " + std::to_string(pass_count) + " (relations)", "pass"};
+                    apply_buffers(options.tracer, reader1, progress, any_collector);
+                }
+                progress.end_pass();
                 reader1.close();
+                any_collector.prepare();
                 options.verbose_output << "Pass " << pass_count << " done\n";
+                print_memory_report(pass_count);
                 ++pass_count;
             }
         }
         options.verbose_output << "Pass " << pass_count << " ...\n";
 
-        osmium::io::Reader reader2(input_filename, osmium::osm_entity_bits::node | osmium::osm_entity_bits::way);
+        osmium::osm_entity_bits::type entities = osmium::osm_entity_bits::node | osmium::osm_entity_bits::way;
+        if (options.single_pass) {
+            // Ways which depend on relations are kept until the relations have been read.
+            entities |= osmium::osm_entity_bits::relation;
+        }
+        osmium::io::Reader reader2(input_filename, entities);
         for (auto vt : options.views) {
-            if (vt == ViewType::tagging) {
-                any_collector.create_layer(handlers.add_handler(vt, "tagging_ways_without_tags"));
-            } else {
-                handlers.add_handler(vt, nullptr);
+            try {
+                if (vt == ViewType::tagging) {
+                    any_collector.create_layer(handlers.add_handler(vt, "tagging_ways_without_tags"));
+                } else {
+                    handlers.add_handler(vt, nullptr);
+                }
+            } catch (CheckRulesError& err) {
+                std::cerr << "ERROR: Invalid check rules: " << err.what() << '\n';
+                exit(1);
+            } catch (std::runtime_error& err) {
+                // output datasets or layers which cannot be created
+                std::cerr << "ERROR: " << err.what() << '\n';
+                exit(1);
             }
             if (vt == ViewType::places) {
-                handlers.add_multipolygon_collector(collector);
+                handlers.add_places_area_collector(places_collector);
             }
         }
 
-        osmium::apply(reader2, location_handler, handlers, any_collector.handler());
+        progress.start_pass("Pass " + std::to_string(pass_count), reader2);
+        {
+            TraceScope scope{options.tracer, "pass " + std::to_string(pass_count), "pass"};
+            apply_buffers(options.tracer, reader2, progress, shard_location_handler, handlers, any_collector);
+        }
+        progress.end_pass();
         reader2.close();
         options.verbose_output << "Pass " << pass_count << " done\n";
+        if (options.shard.enabled()) {
+            options.verbose_output << shard_location_handler.incomplete_ways()
+                << " ways of this shard lack node locations (reaching beyond the overlap zone or"
+                << " missing nodes), their geometries are incomplete or missing\n";
+        }
+        print_memory_report(pass_count);
     }
-    handlers.give_correct_name();
-
+    {
+        TraceScope scope{options.tracer, "close and rename", "output"};
+        handlers.give_correct_name();
+    }
+    options.tracer.close();
 }
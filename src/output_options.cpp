@@ -0,0 +1,84 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "output_options.hpp"
+
+#include <cpl_conv.h>
+
+std::vector<std::string> gdal_default_dataset_options(const OutputOptions& options) {
+    std::vector<std::string> default_options;
+    // default layer creation options
+    if (options.output_format == "SQlite") {
+        CPLSetConfigOption("OGR_SQLITE_PRAGMA", "journal_mode=OFF,TEMP_STORE=MEMORY,temp_store=memory,LOCKING_MODE=EXCLUSIVE");
+        CPLSetConfigOption("OGR_SQLITE_CACHE", std::to_string(options.sqlite_cache).c_str());
+        CPLSetConfigOption("OGR_SQLITE_JOURNAL", "OFF");
+        CPLSetConfigOption("OGR_SQLITE_SYNCHRONOUS", "OFF");
+        default_options.emplace_back("SPATIALITE=YES");
+    } else if (options.output_format == "ESRI Shapefile") {
+        default_options.emplace_back("SHAPE_ENCODING=UTF8");
+    } else if (options.vector_tile_output()) {
+        // Tiles are clipped, simplified and encoded by GDAL when the dataset is closed. Use all CPUs
+        // for the encoding unless the user has chosen otherwise.
+        if (!CPLGetConfigOption("GDAL_NUM_THREADS", nullptr)) {
+            CPLSetConfigOption("GDAL_NUM_THREADS", "ALL_CPUS");
+        }
+        default_options.emplace_back("MINZOOM=" + std::to_string(options.min_zoom));
+        default_options.emplace_back("MAXZOOM=" + std::to_string(options.max_zoom));
+        // simplify below the highest zoom level only, errors should be shown at their exact location
+        default_options.emplace_back("SIMPLIFICATION=1");
+        default_options.emplace_back("SIMPLIFICATION_MAX_ZOOM=0");
+        default_options.emplace_back("NAME=osmi_simple_views");
+        if (options.output_format == "MVT") {
+            default_options.emplace_back("FORMAT=DIRECTORY");
+        }
+    }
+
+    return default_options;
+}
+
+std::vector<std::string> gdal_default_layer_options(const OutputOptions& options) {
+    std::vector<std::string> default_options;
+    // default layer creation options
+    if (options.output_format == "SQlite") {
+        default_options.emplace_back("SPATIAL_INDEX=NO");
+        default_options.emplace_back("COMPRESS_GEOM=NO");
+    } else if (options.output_format == "ESRI Shapefile") {
+        default_options.emplace_back("SHAPE_ENCODING=UTF8");
+    } else if (options.output_format == "GPKG" && options.spatial_index) {
+        // the index is built after all data has been written
+        default_options.emplace_back("SPATIAL_INDEX=NO");
+    } else if (options.output_format == "FlatGeobuf") {
+        // Features are streamed to a temporary file and the packed Hilbert R-tree is built when the
+        // layer is closed.
+        default_options.emplace_back("SPATIAL_INDEX=YES");
+        if (!options.output_directory.empty()) {
+            default_options.emplace_back("TEMPORARY_DIR=" + options.output_directory);
+        }
+    } else if (options.output_format == "Parquet") {
+        // GeoParquet: large row groups, compressed columns and a bbox covering column which
+        // allows readers to skip row groups without decoding any geometry.
+        default_options.emplace_back("GEOMETRY_ENCODING=WKB");
+        default_options.emplace_back("COMPRESSION=ZSTD");
+        default_options.emplace_back("ROW_GROUP_SIZE=65536");
+        default_options.emplace_back("WRITE_COVERING_BBOX=YES");
+        default_options.emplace_back("SORT_BY_BBOX=YES");
+    }
+
+    return default_options;
+}
@@ -0,0 +1,67 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_OUTPUT_OPTIONS_HPP_
+#define SRC_OUTPUT_OPTIONS_HPP_
+
+#include <string>
+#include <vector>
+
+/**
+ * Options of the output datasets, shared by osmi_simple_views and osmi_merge.
+ */
+struct OutputOptions {
+    std::string output_format = "SQlite";
+    std::string output_directory = "";
+    /// lowest zoom level of vector tile output
+    int min_zoom = 0;
+    /// highest zoom level of vector tile output
+    int max_zoom = 14;
+    /// build spatial indexes after all data has been written
+    bool spatial_index = false;
+    /// SQLite page cache per dataset in MB (OGR_SQLITE_CACHE)
+    int sqlite_cache = 600;
+
+    /**
+     * Check if the output format is a vector tile format. All views write their layers into one
+     * dataset shared by all handlers in this case.
+     */
+    bool vector_tile_output() const {
+        return output_format == "PMTiles" || output_format == "MVT";
+    }
+};
+
+/**
+ * \brief Get the default dataset creation options of the output format.
+ *
+ * Configuration options of GDAL required by the output format are set, too. If you add the
+ * returned options to a vector of your own and read it in a later step to set them via the
+ * functions provided by the GDAL library, do it in reverse order. Otherwise the defaults will
+ * overwrite your explicitly set options.
+ */
+std::vector<std::string> gdal_default_dataset_options(const OutputOptions& options);
+
+/**
+ * \brief Get the default layer creation options of the output format.
+ *
+ * See gdal_default_dataset_options() for the order of the options.
+ */
+std::vector<std::string> gdal_default_layer_options(const OutputOptions& options);
+
+#endif /* SRC_OUTPUT_OPTIONS_HPP_ */
@@ -0,0 +1,214 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "place_area_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+constexpr size_t PlaceAreaIndex::NODE_CAPACITY;
+
+namespace {
+
+    /// average number of edges per band of a polygon
+    constexpr size_t EDGES_PER_BAND = 8;
+
+    constexpr size_t MAX_BANDS = 1024;
+
+    constexpr uint64_t MAX_INDEX = std::numeric_limits<uint32_t>::max();
+
+    inline int64_t center_x(const PlaceAreaIndex::Box& box) noexcept {
+        return static_cast<int64_t>(box.min_x) + box.max_x;
+    }
+
+    inline int64_t center_y(const PlaceAreaIndex::Box& box) noexcept {
+        return static_cast<int64_t>(box.min_y) + box.max_y;
+    }
+
+} // anonymous namespace
+
+void PlaceAreaIndex::Box::extend(const Box& other) noexcept {
+    min_x = std::min(min_x, other.min_x);
+    min_y = std::min(min_y, other.min_y);
+    max_x = std::max(max_x, other.max_x);
+    max_y = std::max(max_y, other.max_y);
+}
+
+size_t PlaceAreaIndex::finish_polygon() {
+    if (m_edges.size() > MAX_INDEX || m_polygons.size() >= MAX_INDEX) {
+        throw std::length_error{"Too many edges in place area index"};
+    }
+    const uint32_t first_edge = m_current_first_edge;
+    const uint32_t edge_count = static_cast<uint32_t>(m_edges.size()) - first_edge;
+    Box box{std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max(),
+        std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::min()};
+    for (auto it = m_edges.begin() + first_edge; it != m_edges.end(); ++it) {
+        box.extend(Box{std::min(it->x1, it->x2), std::min(it->y1, it->y2),
+            std::max(it->x1, it->x2), std::max(it->y1, it->y2)});
+    }
+    const uint32_t band_count = static_cast<uint32_t>(std::max(std::min(edge_count / EDGES_PER_BAND, MAX_BANDS),
+            static_cast<size_t>(1)));
+    const int64_t height = edge_count ? static_cast<int64_t>(box.max_y) - box.min_y + 1 : 1;
+    const int32_t band_height = static_cast<int32_t>((height + band_count - 1) / band_count);
+
+    // Count the edges of each band, then fill them in (counting sort).
+    const size_t first_band = m_band_offsets.size();
+    m_band_offsets.resize(first_band + band_count + 1, 0);
+    uint32_t* const offsets = m_band_offsets.data() + first_band;
+    for (uint32_t i = 0; i < edge_count; ++i) {
+        const Edge& edge = m_edges[first_edge + i];
+        const int32_t first = (std::min(edge.y1, edge.y2) - box.min_y) / band_height;
+        const int32_t last = (std::max(edge.y1, edge.y2) - box.min_y) / band_height;
+        for (int32_t band = first; band <= last; ++band) {
+            ++offsets[band + 1];
+        }
+    }
+    const uint64_t base = m_band_edges.size();
+    offsets[0] = static_cast<uint32_t>(base);
+    for (uint32_t band = 1; band <= band_count; ++band) {
+        if (offsets[band - 1] + static_cast<uint64_t>(offsets[band]) > MAX_INDEX) {
+            throw std::length_error{"Too many edges in place area index"};
+        }
+        offsets[band] += offsets[band - 1];
+    }
+    m_band_edges.resize(offsets[band_count]);
+    std::vector<uint32_t> next(offsets, offsets + band_count);
+    for (uint32_t i = 0; i < edge_count; ++i) {
+        const Edge& edge = m_edges[first_edge + i];
+        const int32_t first = (std::min(edge.y1, edge.y2) - box.min_y) / band_height;
+        const int32_t last = (std::max(edge.y1, edge.y2) - box.min_y) / band_height;
+        for (int32_t band = first; band <= last; ++band) {
+            m_band_edges[next[band]++] = i;
+        }
+    }
+
+    m_polygons.push_back(Polygon{box, first_edge, static_cast<uint32_t>(first_band), band_count, band_height});
+    m_current_first_edge = static_cast<uint32_t>(m_edges.size());
+    return m_polygons.size() - 1;
+}
+
+bool PlaceAreaIndex::contains(const size_t polygon, const osmium::Location location) const noexcept {
+    const Polygon& p = m_polygons[polygon];
+    const int32_t x = location.x();
+    const int32_t y = location.y();
+    if (x < p.box.min_x || x > p.box.max_x || y < p.box.min_y || y > p.box.max_y) {
+        return false;
+    }
+    const uint32_t band = p.first_band + static_cast<uint32_t>((y - p.box.min_y) / p.band_height);
+    bool inside = false;
+    for (uint32_t i = m_band_offsets[band]; i < m_band_offsets[band + 1]; ++i) {
+        const Edge& edge = m_edges[p.first_edge + m_band_edges[i]];
+        if ((edge.y1 > y) == (edge.y2 > y)) {
+            continue;
+        }
+        // Does the edge cross the ray from the location to the east? The products are compared
+        // instead of dividing. A difference of x coordinates times a difference of y coordinates
+        // always fits into 63 bits.
+        const int64_t dy = static_cast<int64_t>(edge.y2) - edge.y1;
+        const int64_t lhs = (static_cast<int64_t>(x) - edge.x1) * dy;
+        const int64_t rhs = (static_cast<int64_t>(edge.x2) - edge.x1) * (static_cast<int64_t>(y) - edge.y1);
+        if (dy > 0 ? lhs < rhs : lhs > rhs) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+template <typename TBoxFunction>
+std::vector<std::vector<uint32_t>> PlaceAreaIndex::pack(std::vector<uint32_t> items, TBoxFunction box) {
+    const size_t node_count = (items.size() + NODE_CAPACITY - 1) / NODE_CAPACITY;
+    const size_t slice_count = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(node_count))));
+    const size_t slice_size = slice_count * NODE_CAPACITY;
+    std::sort(items.begin(), items.end(), [&box](const uint32_t a, const uint32_t b) {
+            return center_x(box(a)) < center_x(box(b));
+        });
+    std::vector<std::vector<uint32_t>> groups;
+    for (size_t slice = 0; slice < items.size(); slice += slice_size) {
+        const auto slice_end = items.begin() + std::min(slice + slice_size, items.size());
+        std::sort(items.begin() + slice, slice_end, [&box](const uint32_t a, const uint32_t b) {
+                return center_y(box(a)) < center_y(box(b));
+            });
+        for (auto it = items.begin() + slice; it != slice_end; ) {
+            const auto group_end = (slice_end - it > static_cast<ptrdiff_t>(NODE_CAPACITY)) ? it + NODE_CAPACITY : slice_end;
+            groups.emplace_back(it, group_end);
+            it = group_end;
+        }
+    }
+    return groups;
+}
+
+void PlaceAreaIndex::prepare() {
+    m_nodes.clear();
+    m_order.clear();
+    if (m_polygons.empty()) {
+        return;
+    }
+    std::vector<uint32_t> items(m_polygons.size());
+    for (uint32_t i = 0; i < items.size(); ++i) {
+        items[i] = i;
+    }
+    // nodes of the current level which are not in m_nodes yet (their children are)
+    std::vector<Node> level;
+    const std::vector<Polygon>& polygons = m_polygons;
+    for (const auto& group : pack(std::move(items), [&polygons](const uint32_t i) {return polygons[i].box;})) {
+        Node node{m_polygons[group.front()].box, static_cast<uint32_t>(m_order.size()),
+            static_cast<uint32_t>(group.size()), true};
+        for (const uint32_t polygon : group) {
+            node.box.extend(m_polygons[polygon].box);
+            m_order.push_back(polygon);
+        }
+        level.push_back(node);
+    }
+    while (level.size() > 1) {
+        std::vector<uint32_t> indexes(level.size());
+        for (uint32_t i = 0; i < indexes.size(); ++i) {
+            indexes[i] = i;
+        }
+        std::vector<Node> parents;
+        for (const auto& group : pack(std::move(indexes), [&level](const uint32_t i) {return level[i].box;})) {
+            Node parent{level[group.front()].box, static_cast<uint32_t>(m_nodes.size()),
+                static_cast<uint32_t>(group.size()), false};
+            for (const uint32_t child : group) {
+                parent.box.extend(level[child].box);
+                m_nodes.push_back(level[child]);
+            }
+            parents.push_back(parent);
+        }
+        level.swap(parents);
+    }
+    m_nodes.push_back(level.front());
+}
+
+size_t PlaceAreaIndex::used_memory() const noexcept {
+    return m_edges.capacity() * sizeof(Edge) + m_polygons.capacity() * sizeof(Polygon)
+        + (m_band_offsets.capacity() + m_band_edges.capacity() + m_order.capacity()) * sizeof(uint32_t)
+        + m_nodes.capacity() * sizeof(Node);
+}
+
+void PlaceAreaIndex::clear() {
+    std::vector<Edge>{}.swap(m_edges);
+    std::vector<Polygon>{}.swap(m_polygons);
+    std::vector<uint32_t>{}.swap(m_band_offsets);
+    std::vector<uint32_t>{}.swap(m_band_edges);
+    std::vector<uint32_t>{}.swap(m_order);
+    std::vector<Node>{}.swap(m_nodes);
+    m_current_first_edge = 0;
+}
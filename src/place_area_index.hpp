@@ -0,0 +1,207 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_PLACE_AREA_INDEX_HPP_
+#define SRC_PLACE_AREA_INDEX_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <osmium/osm/location.hpp>
+
+/**
+ * Spatial index of many (multi)polygons to find the polygons containing a point.
+ *
+ * The bounding boxes of the polygons are bulk-loaded into an R-tree using Sort-Tile-Recursive
+ * packing: the boxes are sorted by their centre into vertical slices, each slice by the centre in
+ * y direction, and every NODE_CAPACITY consecutive boxes become a node. The upper levels are built
+ * from the nodes in the same way.
+ *
+ * Each polygon is prepared for point-in-polygon tests when it is added: its edges (of all rings,
+ * holes included) are sorted into horizontal bands of equal height. A point is tested against the
+ * edges of its band only (crossing number, exact integer arithmetic on the coordinates of
+ * osmium::Location).
+ *
+ * The index can hold up to 2^32 edges.
+ */
+class PlaceAreaIndex {
+
+public:
+    struct Box {
+        int32_t min_x;
+        int32_t min_y;
+        int32_t max_x;
+        int32_t max_y;
+
+        bool intersects(const Box& other) const noexcept {
+            return min_x <= other.max_x && other.min_x <= max_x && min_y <= other.max_y && other.min_y <= max_y;
+        }
+
+        /**
+         * Grow the box to include another box.
+         */
+        void extend(const Box& other) noexcept;
+    };
+
+    /// maximum number of children of a node of the R-tree
+    static constexpr size_t NODE_CAPACITY = 16;
+
+private:
+    struct Edge {
+        int32_t x1;
+        int32_t y1;
+        int32_t x2;
+        int32_t y2;
+    };
+
+    struct Polygon {
+        Box box;
+        /// index of the first edge in m_edges
+        uint32_t first_edge;
+        /// index of the first band in m_band_offsets
+        uint32_t first_band;
+        uint32_t band_count;
+        /// height of a band
+        int32_t band_height;
+    };
+
+    struct Node {
+        Box box;
+        /// index of the first child in m_nodes (inner nodes) or m_order (leaves)
+        uint32_t first_child;
+        uint32_t child_count;
+        bool leaf;
+    };
+
+    std::vector<Edge> m_edges;
+
+    std::vector<Polygon> m_polygons;
+
+    /// offsets of the bands of all polygons in m_band_edges (one more than the number of bands per polygon)
+    std::vector<uint32_t> m_band_offsets;
+
+    /// edges of each band relative to the first edge of the polygon
+    std::vector<uint32_t> m_band_edges;
+
+    /// index of the first edge of the polygon being added
+    uint32_t m_current_first_edge = 0;
+
+    /// polygons in the order of the leaves of the R-tree
+    std::vector<uint32_t> m_order;
+
+    /// nodes of the R-tree, the root is the last one
+    std::vector<Node> m_nodes;
+
+    /**
+     * Sort-Tile-Recursive packing of one level of the tree.
+     *
+     * \param items indexes of the boxes of the level
+     * \param box function returning the box of an index
+     *
+     * \returns groups of at most NODE_CAPACITY items
+     */
+    template <typename TBoxFunction>
+    static std::vector<std::vector<uint32_t>> pack(std::vector<uint32_t> items, TBoxFunction box);
+
+public:
+    /**
+     * Add a ring to the polygon being added. The ring has to be closed.
+     */
+    template <typename TIterator>
+    void add_ring(TIterator begin, TIterator end) {
+        if (begin == end) {
+            return;
+        }
+        osmium::Location previous = begin->location();
+        for (++begin; begin != end; ++begin) {
+            const osmium::Location location = begin->location();
+            if (location.y() != previous.y()) {
+                // horizontal edges never cross the ray of a point
+                m_edges.push_back(Edge{previous.x(), previous.y(), location.x(), location.y()});
+            }
+            previous = location;
+        }
+    }
+
+    /**
+     * Finish the polygon made up by the rings added since the last call and prepare it for
+     * point-in-polygon tests.
+     *
+     * \returns index of the polygon
+     *
+     * \throws std::length_error if the index is full
+     */
+    size_t finish_polygon();
+
+    /**
+     * Build the R-tree. Has to be called after the last polygon has been added and before the
+     * index is searched.
+     */
+    void prepare();
+
+    /**
+     * Call a function with the index of every polygon whose bounding box intersects a box.
+     */
+    template <typename TFunction>
+    void search(const Box& box, TFunction&& function) const {
+        if (m_nodes.empty()) {
+            return;
+        }
+        std::vector<uint32_t> stack;
+        stack.push_back(static_cast<uint32_t>(m_nodes.size() - 1));
+        while (!stack.empty()) {
+            const Node& node = m_nodes[stack.back()];
+            stack.pop_back();
+            if (!node.box.intersects(box)) {
+                continue;
+            }
+            for (uint32_t i = node.first_child; i < node.first_child + node.child_count; ++i) {
+                if (!node.leaf) {
+                    stack.push_back(i);
+                } else if (m_polygons[m_order[i]].box.intersects(box)) {
+                    function(static_cast<size_t>(m_order[i]));
+                }
+            }
+        }
+    }
+
+    /**
+     * Check if a polygon contains a location. Locations on the boundary may be inside or
+     * outside.
+     */
+    bool contains(const size_t polygon, const osmium::Location location) const noexcept;
+
+    size_t size() const noexcept {
+        return m_polygons.size();
+    }
+
+    const Box& box(const size_t polygon) const {
+        return m_polygons[polygon].box;
+    }
+
+    size_t used_memory() const noexcept;
+
+    /**
+     * Remove all polygons and free the memory.
+     */
+    void clear();
+};
+
+#endif /* SRC_PLACE_AREA_INDEX_HPP_ */
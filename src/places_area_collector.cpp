@@ -0,0 +1,385 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "places_area_collector.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <osmium/osm/relation.hpp>
+#include <osmium/osm/way.hpp>
+
+constexpr size_t PlacesAreaCollector::WAYS_PER_TASK;
+
+PlacesAreaCollector::PlacesAreaCollector(Options& options,
+        const osmium::area::Assembler::config_type& assembler_config) :
+    m_options(options),
+    m_callback(),
+    m_assemble(),
+    m_tasks(),
+    m_mutex(),
+    m_work_available(),
+    m_work_done(),
+    m_workers(),
+    m_max_tasks(2 * std::max(std::thread::hardware_concurrency(), 1u)),
+    m_pending_ways(1024 * 1024, osmium::memory::Buffer::auto_grow::yes),
+    m_member_refs(),
+    m_member_counts(),
+    m_members(options.max_memory),
+    m_relation_buffer(64 * 1024, osmium::memory::Buffer::auto_grow::yes),
+    m_deferred_ways(options.max_memory) {
+    Tracer* tracer = &options.tracer;
+    m_assemble = [assembler_config, tracer](osmium::memory::Buffer input) {
+        return assemble(assembler_config, std::move(input), tracer);
+    };
+}
+
+PlacesAreaCollector::~PlacesAreaCollector() {
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop = true;
+    }
+    m_work_available.notify_all();
+    for (auto& thread : m_workers) {
+        thread.join();
+    }
+}
+
+void PlacesAreaCollector::set_callback(area_callback_type callback) {
+    m_callback = callback;
+}
+
+void PlacesAreaCollector::set_assemble_function(assemble_function_type assemble) {
+    m_assemble = assemble;
+}
+
+bool PlacesAreaCollector::keep_relation(const osmium::Relation& relation) {
+    const char* type = relation.tags().get_value_by_key("type");
+    // Administrative boundaries are only used for the join with the place nodes by name.
+    return type && (!strcmp(type, "multipolygon") || !strcmp(type, "boundary"))
+            && (relation.tags().has_key("place") || (relation.tags().has_tag("boundary", "administrative")
+                && relation.tags().has_key("name")));
+}
+
+void PlacesAreaCollector::add_relation(const osmium::Relation& relation) {
+    if (!keep_relation(relation)) {
+        return;
+    }
+    const uint32_t index = static_cast<uint32_t>(m_member_counts.size());
+    // Keep a copy without references to members other than ways as osmium::relations::Collector does.
+    m_relation_buffer.clear();
+    m_relation_buffer.add_item(relation);
+    m_relation_buffer.commit();
+    osmium::Relation& copy = m_relation_buffer.get<osmium::Relation>(0);
+    for (auto& member : copy.members()) {
+        if (member.type() != osmium::item_type::way) {
+            member.set_ref(0);
+        } else if (member.ref() != 0) {
+            m_member_refs.push_back(MemberRef{member.ref(), index});
+        }
+    }
+    m_member_counts.push_back(0);
+    m_members.add(2 * static_cast<uint64_t>(index), copy);
+}
+
+void PlacesAreaCollector::finish_relations() {
+    std::sort(m_member_refs.begin(), m_member_refs.end(), [](const MemberRef& a, const MemberRef& b) {
+        return a.way_id < b.way_id || (a.way_id == b.way_id && a.relation < b.relation);
+    });
+    // A way which is referenced by a relation more than once is kept once only.
+    m_member_refs.erase(std::unique(m_member_refs.begin(), m_member_refs.end(),
+            [](const MemberRef& a, const MemberRef& b) {
+                return a.way_id == b.way_id && a.relation == b.relation;
+            }), m_member_refs.end());
+    m_member_refs.shrink_to_fit();
+    for (const MemberRef& ref : m_member_refs) {
+        ++m_member_counts[ref.relation];
+    }
+    m_relation_buffer = osmium::memory::Buffer{};
+}
+
+osmium::memory::Buffer PlacesAreaCollector::assemble(const osmium::area::Assembler::config_type config,
+        osmium::memory::Buffer input, Tracer* tracer) {
+    TraceScope scope{*tracer, "assemble place areas", "areas"};
+    osmium::memory::Buffer output {input.committed() + 1024, osmium::memory::Buffer::auto_grow::yes};
+    auto it = input.begin<osmium::OSMObject>();
+    const auto end = input.end<osmium::OSMObject>();
+    if (it == end) {
+        return output;
+    }
+    if (it->type() == osmium::item_type::relation) {
+        const osmium::Relation& relation = static_cast<const osmium::Relation&>(*it);
+        std::vector<const osmium::Way*> ways;
+        for (++it; it != end; ++it) {
+            ways.push_back(static_cast<const osmium::Way*>(&*it));
+        }
+        std::sort(ways.begin(), ways.end(), [](const osmium::Way* a, const osmium::Way* b) {
+            return a->id() < b->id();
+        });
+        // The assembler expects the member ways in the order of the members of the relation.
+        std::vector<const osmium::Way*> members;
+        for (const auto& member : relation.members()) {
+            if (member.ref() == 0) {
+                continue;
+            }
+            const auto way = std::lower_bound(ways.begin(), ways.end(), member.ref(),
+                    [](const osmium::Way* w, const osmium::object_id_type id) {
+                        return w->id() < id;
+                    });
+            if (way == ways.end() || (*way)->id() != member.ref()) {
+                return output;
+            }
+            members.push_back(*way);
+        }
+        try {
+            osmium::area::Assembler assembler{config};
+            assembler(relation, members, output);
+        } catch (const osmium::invalid_location&) {
+            // ignore relations with member ways without locations
+        }
+        return output;
+    }
+    for (; it != end; ++it) {
+        try {
+            osmium::area::Assembler assembler{config};
+            assembler(static_cast<const osmium::Way&>(*it), output);
+        } catch (const osmium::invalid_location&) {
+            // ignore ways without locations
+        }
+    }
+    return output;
+}
+
+void PlacesAreaCollector::worker() {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    while (true) {
+        m_work_available.wait(lock, [this]() {
+            return m_stop || m_next_task < m_tasks.size();
+        });
+        if (m_stop) {
+            return;
+        }
+        Task& task = m_tasks[m_next_task++];
+        osmium::memory::Buffer input = std::move(task.input);
+        lock.unlock();
+        osmium::memory::Buffer result;
+        std::exception_ptr error;
+        try {
+            result = m_assemble(std::move(input));
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+        task.result = std::move(result);
+        task.error = error;
+        task.done = true;
+        m_work_done.notify_all();
+    }
+}
+
+bool PlacesAreaCollector::front_done() {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_tasks.front().done;
+}
+
+void PlacesAreaCollector::deliver_front() {
+    osmium::memory::Buffer areas;
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_work_done.wait(lock, [this]() {
+            return m_tasks.front().done;
+        });
+        areas = std::move(m_tasks.front().result);
+        error = m_tasks.front().error;
+        m_task_memory -= m_tasks.front().size;
+        m_tasks.pop_front();
+        --m_next_task;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if (m_callback && areas.committed() > 0) {
+        m_callback(areas);
+    }
+}
+
+void PlacesAreaCollector::submit(osmium::memory::Buffer&& buffer) {
+    if (m_workers.empty()) {
+        const unsigned int count = std::max(std::thread::hardware_concurrency(), 1u);
+        for (unsigned int i = 0; i < count; ++i) {
+            m_workers.emplace_back(&PlacesAreaCollector::worker, this);
+        }
+    }
+    // Results are delivered in order. Deliver finished tasks at the front of the queue early and
+    // block if too many tasks are in flight or their input buffers exceed the memory budget.
+    const size_t size = buffer.capacity();
+    while (!m_tasks.empty() && (m_tasks.size() >= m_max_tasks
+            || (m_options.max_memory > 0 && m_task_memory + size > m_options.max_memory)
+            || front_done())) {
+        deliver_front();
+    }
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_tasks.push_back(Task{std::move(buffer), osmium::memory::Buffer{}, nullptr, size, false});
+        m_task_memory += size;
+    }
+    m_work_available.notify_one();
+}
+
+void PlacesAreaCollector::submit_pending_ways() {
+    if (m_pending_way_count == 0) {
+        return;
+    }
+    osmium::memory::Buffer ways {1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+    using std::swap;
+    swap(ways, m_pending_ways);
+    m_pending_way_count = 0;
+    submit(std::move(ways));
+}
+
+void PlacesAreaCollector::way_not_in_any_relation(const osmium::Way& way) {
+    // You need at least four nodes to make up a polygon.
+    if (way.nodes().size() <= 3
+            || !(way.tags().has_key("place") || (way.tags().has_tag("boundary", "administrative")
+                && way.tags().has_key("name")))) {
+        return;
+    }
+    if (!way.nodes().front().location() || !way.nodes().back().location()
+            || !way.ends_have_same_location()) {
+        return;
+    }
+    m_pending_ways.add_item(way);
+    m_pending_ways.commit();
+    if (++m_pending_way_count == WAYS_PER_TASK) {
+        submit_pending_ways();
+    }
+}
+
+void PlacesAreaCollector::handle_way(const osmium::Way& way) {
+    auto range = std::equal_range(m_member_refs.begin(), m_member_refs.end(), MemberRef{way.id(), 0},
+            [](const MemberRef& a, const MemberRef& b) {
+                return a.way_id < b.way_id;
+            });
+    if (range.first == range.second) {
+        way_not_in_any_relation(way);
+        return;
+    }
+    for (; range.first != range.second; ++range.first) {
+        m_members.add(2 * static_cast<uint64_t>(range.first->relation) + 1, way);
+    }
+}
+
+bool PlacesAreaCollector::may_be_member(const osmium::Way& way) {
+    const osmium::TagList& tags = way.tags();
+    return tags.size() == 0 || tags.has_key("place") || tags.has_key("boundary")
+            || tags.has_tag("natural", "coastline");
+}
+
+void PlacesAreaCollector::process_way(const osmium::Way& way) {
+    if (!m_options.single_pass) {
+        handle_way(way);
+    } else if (may_be_member(way)) {
+        m_deferred_ways.add(way);
+    }
+}
+
+void PlacesAreaCollector::process_relation(const osmium::Relation& relation) {
+    if (m_options.single_pass) {
+        add_relation(relation);
+    }
+}
+
+void PlacesAreaCollector::process_deferred() {
+    TraceScope scope{m_options.tracer, "deferred place areas", "areas"};
+    finish_relations();
+    m_options.verbose_output << "Processing " << m_deferred_ways.size() << " deferred ways for place areas";
+    if (m_deferred_ways.spilled()) {
+        m_options.verbose_output << " (spilled to disk)";
+    }
+    m_options.verbose_output << '\n';
+    m_deferred_ways.for_each([this](const osmium::Way& way) {
+        handle_way(way);
+    });
+    m_deferred_ways.clear();
+}
+
+void PlacesAreaCollector::assemble_relations() {
+    TraceScope scope{m_options.tracer, "place area relations", "areas"};
+    m_options.verbose_output << "Assembling " << m_member_counts.size() << " relations with "
+        << m_members.size() - m_member_counts.size() << " member ways for place areas";
+    if (m_members.spilled()) {
+        m_options.verbose_output << " (spilled to disk)";
+    }
+    m_options.verbose_output << '\n';
+    m_member_refs = std::vector<MemberRef>{};
+    // The store hands back each relation followed by its member ways.
+    osmium::memory::Buffer task_buffer {1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+    uint64_t relation = 0;
+    uint32_t way_count = 0;
+    auto submit_relation = [&]() {
+        if (task_buffer.committed() == 0) {
+            return;
+        }
+        // Relations with missing member ways cannot be assembled.
+        if (way_count == m_member_counts[relation]) {
+            submit(std::move(task_buffer));
+        } else {
+            ++m_incomplete_relations;
+        }
+        task_buffer = osmium::memory::Buffer{1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+    };
+    m_members.for_each([&](uint64_t key, const osmium::memory::Item& item) {
+        if (key % 2 == 0) {
+            submit_relation();
+            relation = key / 2;
+            way_count = 0;
+        } else {
+            ++way_count;
+        }
+        task_buffer.add_item(item);
+        task_buffer.commit();
+    });
+    submit_relation();
+    m_members.clear();
+    m_member_counts = std::vector<uint32_t>{};
+    if (m_incomplete_relations > 0) {
+        m_options.verbose_output << m_incomplete_relations
+            << " relations for place areas not assembled because member ways are missing";
+        if (m_options.single_pass) {
+            m_options.verbose_output << " (single-pass mode keeps only untagged ways and ways tagged"
+                " with place, boundary or natural=coastline)";
+        }
+        m_options.verbose_output << '\n';
+    }
+}
+
+void PlacesAreaCollector::flush() {
+    if (m_options.single_pass) {
+        process_deferred();
+    }
+    assemble_relations();
+    TraceScope scope{m_options.tracer, "wait for place areas", "areas"};
+    submit_pending_ways();
+    while (!m_tasks.empty()) {
+        deliver_front();
+    }
+    m_options.verbose_output << "Assembly of place areas done\n";
+}
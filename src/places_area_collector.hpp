@@ -0,0 +1,289 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_PLACES_AREA_COLLECTOR_HPP_
+#define SRC_PLACES_AREA_COLLECTOR_HPP_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <osmium/area/assembler.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/relation.hpp>
+#include <osmium/osm/way.hpp>
+
+#include "deferred_ways.hpp"
+#include "options.hpp"
+#include "sorted_object_store.hpp"
+
+/**
+ * Collect the relations and closed ways with a place tag or with a name and
+ * boundary=administrative and assemble their areas in parallel.
+ *
+ * This replaces osmium::area::MultipolygonCollector which keeps all relations and member ways in
+ * memory and assembles the areas serially. The relations we are interested in and their member
+ * ways are copied into a SortedObjectStore with the index of the relation as key, i.e. they are
+ * spilled to disk if they exceed the memory budget (--max-memory). Only an index of the member
+ * way IDs (16 bytes per member) and the number of members of each relation are kept in memory.
+ * After the way pass, the store hands back each relation followed by its member ways. They are
+ * assembled as tasks by a fixed pool of worker threads (one per hardware thread), and so are
+ * batches of closed ways which are not members of any relation. The resulting area buffers are
+ * handed to the callback in the order the tasks were submitted, i.e. the output does not depend
+ * on the number of threads. The number of tasks in flight is limited, and so is the memory of
+ * their input buffers if a memory budget is set.
+ *
+ * In single-pass mode, the relations are read after the ways. All ways which may be members of
+ * the relations we are interested in are kept until flush() is called. Member ways are expected
+ * to be untagged or tagged with place, boundary or natural=coastline. Relations with other member
+ * ways cannot be assembled in this mode. The number of relations which were not assembled
+ * because member ways are missing is printed to the verbose output.
+ */
+class PlacesAreaCollector {
+
+public:
+    using area_callback_type = std::function<void(const osmium::memory::Buffer&)>;
+
+    /// function run by a task: gets the input buffer and returns the buffer of assembled areas
+    using assemble_function_type = std::function<osmium::memory::Buffer(osmium::memory::Buffer)>;
+
+private:
+    /// number of closed ways assembled by a single task
+    static constexpr size_t WAYS_PER_TASK = 1000;
+
+    /// member way of a relation we are interested in
+    struct MemberRef {
+        osmium::object_id_type way_id;
+        /// index of the relation
+        uint32_t relation;
+    };
+
+    Options& m_options;
+
+    area_callback_type m_callback;
+
+    /// function run by the tasks, assemble() by default
+    assemble_function_type m_assemble;
+
+    struct Task {
+        osmium::memory::Buffer input;
+        osmium::memory::Buffer result;
+        /// exception thrown by the assemble function
+        std::exception_ptr error;
+        /// capacity of the input buffer
+        size_t size;
+        bool done;
+    };
+
+    /**
+     * Tasks in the order they were submitted. Tasks are appended and removed from the front by the
+     * thread calling submit() only, this does not invalidate references to the other tasks held
+     * by the workers. All members of the tasks are guarded by m_mutex.
+     */
+    std::deque<Task> m_tasks;
+
+    /// index of the first task in m_tasks which has not been taken by a worker
+    size_t m_next_task = 0;
+
+    std::mutex m_mutex;
+
+    /// signalled when a task is submitted or the workers have to stop
+    std::condition_variable m_work_available;
+
+    /// signalled when a task is done
+    std::condition_variable m_work_done;
+
+    bool m_stop = false;
+
+    /// worker threads, started by the first call of submit()
+    std::vector<std::thread> m_workers;
+
+    /// sum of the sizes of the tasks in m_tasks
+    size_t m_task_memory = 0;
+
+    /// maximum number of tasks running or waiting for delivery
+    size_t m_max_tasks;
+
+    /// closed ways waiting to be handed to a task
+    osmium::memory::Buffer m_pending_ways;
+    size_t m_pending_way_count = 0;
+
+    /// member ways of all relations, sorted by way ID once all relations have been added
+    std::vector<MemberRef> m_member_refs;
+
+    /// number of distinct member ways of each relation
+    std::vector<uint32_t> m_member_counts;
+
+    /// relations (key: 2 * index) and their member ways (key: 2 * index + 1)
+    SortedObjectStore m_members;
+
+    /// number of relations which were not assembled because member ways are missing
+    size_t m_incomplete_relations = 0;
+
+    /// scratch buffer for the copy of a relation
+    osmium::memory::Buffer m_relation_buffer;
+
+    /// ways which may be members of relations we are interested in (single-pass mode only)
+    DeferredWays m_deferred_ways;
+
+    /**
+     * Check if a way may be the member of a relation we are interested in (single-pass mode).
+     */
+    static bool may_be_member(const osmium::Way& way);
+
+    /**
+     * Add a copy of a way to the relations it is a member of or, if it is not a member of any
+     * relation, to the closed ways to be assembled.
+     */
+    void handle_way(const osmium::Way& way);
+
+    /**
+     * Hand a way which is not a member of any relation we are interested in to a task if it is
+     * closed and tagged with place or boundary=administrative.
+     */
+    void way_not_in_any_relation(const osmium::Way& way);
+
+    /**
+     * Read the ways kept in single-pass mode.
+     */
+    void process_deferred();
+
+    /**
+     * Submit all relations with all of their member ways.
+     */
+    void assemble_relations();
+
+    /**
+     * Assemble all areas of a buffer.
+     *
+     * If the first item of the buffer is a relation, all ways following it are its members.
+     * Otherwise the buffer contains closed ways only.
+     */
+    static osmium::memory::Buffer assemble(const osmium::area::Assembler::config_type config,
+            osmium::memory::Buffer input, Tracer* tracer);
+
+    /**
+     * Run tasks until the collector is destroyed.
+     */
+    void worker();
+
+    /**
+     * Check if the oldest task is done.
+     */
+    bool front_done();
+
+    /**
+     * Queue a task assembling the areas of the buffer. Blocks while too many tasks are in flight
+     * or their input buffers would exceed the memory budget.
+     */
+    void submit(osmium::memory::Buffer&& buffer);
+
+    /**
+     * Wait for the oldest task and hand its result to the callback. Exceptions thrown by the task
+     * are rethrown.
+     */
+    void deliver_front();
+
+    void submit_pending_ways();
+
+public:
+    PlacesAreaCollector() = delete;
+
+    PlacesAreaCollector(Options& options, const osmium::area::Assembler::config_type& assembler_config);
+
+    PlacesAreaCollector(const PlacesAreaCollector&) = delete;
+    PlacesAreaCollector& operator=(const PlacesAreaCollector&) = delete;
+
+    ~PlacesAreaCollector();
+
+    /**
+     * Set the function called with the buffers of assembled areas.
+     */
+    void set_callback(area_callback_type callback);
+
+    /**
+     * Replace the function run by the tasks (for tests). It is called from several threads at the
+     * same time and must be set before the first task is submitted.
+     */
+    void set_assemble_function(assemble_function_type assemble);
+
+    /**
+     * We are interested in multipolygon and boundary relations with a place tag or with
+     * boundary=administrative and a name only.
+     */
+    static bool keep_relation(const osmium::Relation& relation);
+
+    /**
+     * Keep a relation if we are interested in it.
+     */
+    void add_relation(const osmium::Relation& relation);
+
+    /**
+     * Prepare the index of the member ways after all relations have been added.
+     */
+    void finish_relations();
+
+    /**
+     * Relation pass: Read all relations from a source (e.g. an osmium::io::Reader).
+     */
+    template <typename TSource>
+    void read_relations(TSource& source) {
+        while (osmium::memory::Buffer buffer = source.read()) {
+            for (auto it = buffer.template cbegin<osmium::Relation>(); it != buffer.template cend<osmium::Relation>(); ++it) {
+                add_relation(*it);
+            }
+        }
+        finish_relations();
+    }
+
+    /**
+     * Way pass: Hand a way to the collector (or keep it in single-pass mode).
+     */
+    void process_way(const osmium::Way& way);
+
+    /**
+     * Single-pass mode: Keep a relation until all ways have been read. Relations are read before
+     * the way pass otherwise.
+     */
+    void process_relation(const osmium::Relation& relation);
+
+    /**
+     * Memory in bytes used for relations and their member ways in memory, the index of the
+     * members, closed ways waiting to be assembled, input buffers of running tasks and ways kept
+     * in single-pass mode
+     */
+    uint64_t used_memory() const {
+        return m_members.used_memory() + m_member_refs.capacity() * sizeof(MemberRef)
+            + m_member_counts.capacity() * sizeof(uint32_t) + m_pending_ways.capacity()
+            + m_task_memory + m_deferred_ways.used_memory();
+    }
+
+    /**
+     * Assemble the relations, wait for all tasks and hand their results to the callback. In
+     * single-pass mode, the kept ways are processed first.
+     */
+    void flush();
+};
+
+#endif /* SRC_PLACES_AREA_COLLECTOR_HPP_ */
@@ -19,17 +19,33 @@
 
 
 #include "places_handler.hpp"
+#include <algorithm>
+#include <future>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <thread>
 #include <osmium/index/index.hpp>
 #include <osmium/osm/item_type.hpp>
 
-PlacesHandler::PlacesHandler(Options& options) :
-        AbstractViewHandler(options),
+#include "quantity.hpp"
+
+PlacesHandler::PlacesHandler(Options& options, gdalcpp::Dataset* shared_dataset /*= nullptr*/) :
+        AbstractViewHandler(options, shared_dataset),
         m_points(create_layer("points", wkbPoint)),
         m_polygons(create_layer("polygons", wkbMultiPolygon)),
         m_errors_points(create_layer("errors_points", wkbPoint)),
         m_errors_polygons(create_layer("errors_polygons", wkbMultiPolygon)),
-        m_cities(create_layer("cities", wkbPoint)) {
+        m_cities(create_layer("cities", wkbPoint)),
+        m_errors_place_areas(create_layer("errors_place_areas", wkbPoint)),
+        m_area_index(),
+        m_join_areas(),
+        m_join_nodes(),
+        m_failed_areas(),
+        m_place_types(options.rules.find("place_type")) {
+    if (!m_place_types) {
+        throw std::runtime_error{"The check rules do not contain the check place_type."};
+    }
     // add fields to layers
     m_points->add_field("node_id", OFTString, 10);
     m_points->add_field("place", OFTString, 20);
@@ -72,7 +88,14 @@ PlacesHandler::PlacesHandler(Options& options) :
     m_cities->add_field("admlvl", OFTInteger, 2);
     m_cities->add_field("name", OFTString, 100);
     m_cities->add_field("lastchange", OFTString, 21);
-
+    // place nodes not matching the areas
+    m_errors_place_areas->add_field("node_id", OFTString, 10);
+    m_errors_place_areas->add_field("place", OFTString, 20);
+    m_errors_place_areas->add_field("name", OFTString, 100);
+    m_errors_place_areas->add_field("error", OFTString, 60);
+    m_errors_place_areas->add_field("area_id", OFTString, 10);
+    m_errors_place_areas->add_field("area_type", OFTString, 1);
+    m_errors_place_areas->add_field("lastchange", OFTString, 21);
 }
 
 void PlacesHandler::give_correct_name() {
@@ -85,86 +108,20 @@ void PlacesHandler::close() {
     m_errors_points.reset();
     m_errors_polygons.reset();
     m_cities.reset();
+    m_errors_place_areas.reset();
     close_datasets();
 }
 
 bool PlacesHandler::place_value_ok(const char* value) {
-    if (!strcmp(value, "continent")) {
-        return true;
-    }
-    if (!strcmp(value, "country")) {
-        return true;
-    }
-    if (!strcmp(value, "state")) {
-        return true;
-    }
-    if (!strcmp(value, "region")) {
-        return true;
-    }
-    if (!strcmp(value, "county")) {
-        return true;
-    }
-    if (!strcmp(value, "city")) {
-        return true;
-    }
-    if (!strcmp(value, "town")) {
-        return true;
-    }
-    if (!strcmp(value, "village")) {
-        return true;
-    }
-    if (!strcmp(value, "hamlet")) {
-        return true;
-    }
-    if (!strcmp(value, "municipality")) {
-        return true;
-    }
-    if (!strcmp(value, "suburb")) {
-        return true;
-    }
-    if (!strcmp(value, "locality")) {
-        return true;
-    }
-    if (!strcmp(value, "island")) {
-        return true;
-    }
-    if (!strcmp(value, "islet")) {
-        return true;
-    }
-    if (!strcmp(value, "farm")) {
-        return true;
-    }
-    if (!strcmp(value, "subdivision")) {
-        return true;
-    }
-    if (!strcmp(value, "sea")) {
-        return true;
-    }
-    if (!strcmp(value, "ocean")) {
-        return true;
-    }
-    if (!strcmp(value, "neighbourhood")) {
-        return true;
-    }
-    if (!strcmp(value, "quarter")) {
-        return true;
-    }
-    if (!strcmp(value, "isolated_dwelling")) {
-        return true;
-    }
-    if (!strcmp(value, "square")) {
-        return true;
-    }
-    return false;
+    return m_place_types->accepts(value);
 }
 
-bool PlacesHandler::is_capital(const osmium::TagList& tags) {
+bool PlacesHandler::is_capital(const osmium::TagList& tags, const long admin_level) {
     const char* is_capital = tags.get_value_by_key("is_capital", "");
     if (!strcmp(is_capital, "country")) {
         return true;
     }
     const char* capital = tags.get_value_by_key("capital", "");
-    int admin_level = std::atoi(tags.get_value_by_key("admin_level", ""));
     if (!strcmp(capital, "yes") && (admin_level < 3) && (admin_level > 0)) {
         return true;
     } else if (!strcmp(capital, "2")) {
@@ -174,33 +131,34 @@ bool PlacesHandler::is_capital(const osmium::TagList& tags) {
 }
 
 void PlacesHandler::check_population(const osmium::OSMObject& osm_object, const osmium::object_id_type id,
-        const char* geomtype, const char* place_value, long int population) {
+        const char* geomtype, const char* place_value, long int population, const OGRGeometry* geometry) {
     if (!place_value || population == 0) {
         return;
     }
     if (!strcmp(place_value, "city") && population < 10000) {
-        add_error(osm_object, id, geomtype, "population too small for city", std::to_string(population));
+        add_error(osm_object, id, geomtype, "population too small for city", std::to_string(population), geometry);
     } else if (!strcmp(place_value, "town") && population > 200000) {
-        add_error(osm_object, id, geomtype, "population too large for town", std::to_string(population));
+        add_error(osm_object, id, geomtype, "population too large for town", std::to_string(population), geometry);
     } else if (!strcmp(place_value, "town") && population < 500) {
-        add_error(osm_object, id, geomtype, "population too small for town", std::to_string(population));
+        add_error(osm_object, id, geomtype, "population too small for town", std::to_string(population), geometry);
     } else if (!strcmp(place_value, "village") && population > 25000) {
-        add_error(osm_object, id, geomtype, "population too large for village", std::to_string(population));
+        add_error(osm_object, id, geomtype, "population too large for village", std::to_string(population), geometry);
     } else if (!strcmp(place_value, "hamlet") && population > 1000) {
-        add_error(osm_object, id, geomtype, "population too large for hamlet", std::to_string(population));
+        add_error(osm_object, id, geomtype, "population too large for hamlet", std::to_string(population), geometry);
     } else if (!strcmp(place_value, "suburb") && population > 1000000) {
-        add_error(osm_object, id, geomtype, "population too large for suburb", std::to_string(population));
+        add_error(osm_object, id, geomtype, "population too large for suburb", std::to_string(population), geometry);
     } else if (!strcmp(place_value, "isolated_dwelling") && population > 500) {
-        add_error(osm_object, id, geomtype, "population too large for isolated_dwelling", std::to_string(population));
+        add_error(osm_object, id, geomtype, "population too large for isolated_dwelling", std::to_string(population), geometry);
     } else if (!strcmp(place_value, "city") && population > 60000000) {
-        add_error(osm_object, id, geomtype, "population too large for city", std::to_string(population));
+        add_error(osm_object, id, geomtype, "population too large for city", std::to_string(population), geometry);
     } else if (population > 12000000000) {
-        add_error(osm_object, id, geomtype, "population too large for planet", std::to_string(population));
+        add_error(osm_object, id, geomtype, "population too large for planet", std::to_string(population), geometry);
     }
 }
 
 void PlacesHandler::add_feature(std::unique_ptr<OGRGeometry>&& geometry, const osmium::OSMObject& osm_object,
-        const char* geomtype, const osmium::object_id_type id, const char* place_value, bool city_layer /*= false*/) {
+        const char* geomtype, const osmium::object_id_type id, const char* place_value, bool city_layer /*= false*/,
+        const OGRGeometry* error_geometry /*= nullptr*/) {
     gdalcpp::Layer* current_layer = m_points.get();
     if (osm_object.type() == osmium::item_type::area) {
         current_layer = m_polygons.get();
@@ -208,54 +166,62 @@ void PlacesHandler::add_feature(std::unique_ptr<OGRGeometry>&& geometry, const o
     if (city_layer) {
         current_layer = m_cities.get();
     }
+    // Errors are written with a copy of the geometry of the feature (it stays alive until this
+    // method returns) unless the feature is the centroid of an area.
+    const OGRGeometry* geometry_ptr = error_geometry;
+    if (!geometry_ptr && (!city_layer || osm_object.type() != osmium::item_type::area)) {
+        geometry_ptr = geometry.get();
+    }
     gdalcpp::Feature feature(*current_layer, std::move(geometry));
     set_basic_fields(feature, osm_object, id);
 
     // place and type field
     if (!city_layer) {
-        feature.set_field("place", place_value);
+        set_text_field(feature, "place", place_value);
         if (place_value_ok(place_value)) {
-            feature.set_field("type", place_value);
+            set_text_field(feature, "type", place_value);
         } else {
-            add_error(osm_object, id, geomtype, "unknown place value");
+            add_error(osm_object, id, geomtype, "unknown place value", "", geometry_ptr);
         }
     }
 
     // population
     const char* popstr = osm_object.get_value_by_key("population");
     if (popstr) {
-        feature.set_field("popstr", popstr);
-        char* rest;
-        long int population = std::strtol(popstr, &rest, 10);
-        if (*rest) {
-            add_error(osm_object, id, geomtype, "characters after population number", popstr);
+        set_text_field(feature, "popstr", popstr);
+        const Quantity population_quantity = Quantity::parse(popstr);
+        const long int population = population_quantity.integer;
+        if (*population_quantity.integer_end) {
+            add_error(osm_object, id, geomtype, "characters after population number", popstr, geometry_ptr);
         } else if (population < 20000000000 && population > 0) {
             feature.set_field("population", static_cast<int>(population));
-            check_population(osm_object, id, geomtype, place_value, population);
+            check_population(osm_object, id, geomtype, place_value, population, geometry_ptr);
         } else {
             feature.set_field("population", 0);
-            add_error(osm_object, id, geomtype, "population number beyond usual range", popstr);
+            add_error(osm_object, id, geomtype, "population number beyond usual range", popstr, geometry_ptr);
         }
     } else {
         feature.set_field("population", 0);
     }
 
+    // admin_level is needed for the capital check, too
+    const char* admin_level = osm_object.get_value_by_key("admin_level", "");
+    const Quantity admin_level_quantity = Quantity::parse(admin_level);
+    const long int admlvl_int = admin_level_quantity.integer;
+
     // capital
     const char* capitalstr = osm_object.get_value_by_key("capital", "");
-    feature.set_field("capitalstr", capitalstr);
-    if (is_capital(osm_object.tags())) {
+    set_text_field(feature, "capitalstr", capitalstr);
+    if (is_capital(osm_object.tags(), admlvl_int)) {
         feature.set_field("capital", 1);
     } else {
         feature.set_field("capital", 0);
     }
 
-    const char* admin_level = osm_object.get_value_by_key("admin_level", "");
-    char* rest;
-    long int admlvl_int = std::strtol(admin_level, &rest, 10);
-    if (*rest) {
-        add_error(osm_object, id, geomtype, "characters after admin_level number");
+    if (*admin_level_quantity.integer_end) {
+        add_error(osm_object, id, geomtype, "characters after admin_level number", "", geometry_ptr);
     } else if (admlvl_int < 0 || admlvl_int > 11) {
-        add_error(osm_object, id, geomtype, "admin_level number beyond usual range");
+        add_error(osm_object, id, geomtype, "admin_level number beyond usual range", "", geometry_ptr);
     } else {
         feature.set_field("admlvl", static_cast<int>(admlvl_int));
     }
@@ -263,11 +229,11 @@ void PlacesHandler::add_feature(std::unique_ptr<OGRGeometry>&& geometry, const o
     // name
     const char* name = osm_object.get_value_by_key("name");
     if (name) {
-        feature.set_field("name", name);
+        set_text_field(feature, "name", name);
     } else {
-        add_error(osm_object, id, geomtype, "place_without_name");
+        add_error(osm_object, id, geomtype, "place_without_name", "", geometry_ptr);
     }
-    feature.add_to_layer();
+    write_feature(feature, *current_layer);
 }
 
 void PlacesHandler::set_basic_fields(gdalcpp::Feature& feature, const osmium::OSMObject& osm_object,
@@ -280,16 +246,25 @@ void PlacesHandler::set_basic_fields(gdalcpp::Feature& feature, const osmium::OS
 }
 
 void PlacesHandler::add_error(const osmium::OSMObject& osm_object, const osmium::object_id_type id,
-        const char* geomtype, std::string error, std::string different_value /*= ""*/) {
+        const char* geomtype, std::string error, std::string different_value /*= ""*/,
+        const OGRGeometry* geometry_source /*= nullptr*/) {
     std::unique_ptr<OGRGeometry> geometry;
     gdalcpp::Layer* error_layer;
     switch (osm_object.type()) {
     case osmium::item_type::node:
-        geometry = m_factory.create_point(static_cast<const osmium::Node&>(osm_object));
+        if (geometry_source) {
+            geometry.reset(geometry_source->clone());
+        } else {
+            geometry = m_factory.create_point(static_cast<const osmium::Node&>(osm_object));
+        }
         error_layer = m_errors_points.get();
         break;
     case osmium::item_type::area:
-        geometry = m_factory.create_multipolygon(static_cast<const osmium::Area&>(osm_object));
+        if (geometry_source) {
+            geometry.reset(geometry_source->clone());
+        } else {
+            geometry = m_factory.create_multipolygon(static_cast<const osmium::Area&>(osm_object));
+        }
         error_layer = m_errors_polygons.get();
         break;
     default:
@@ -299,12 +274,12 @@ void PlacesHandler::add_error(const osmium::OSMObject& osm_object, const osmium:
     set_basic_fields(the_feature, osm_object, id);
     the_feature.set_field("error", error.c_str());
     if (different_value == "") {
-        the_feature.set_field("value", osm_object.get_value_by_key("place", ""));
+        set_text_field(the_feature, "value", osm_object.get_value_by_key("place", ""));
     } else {
-        the_feature.set_field("value", different_value.c_str());
+        set_text_field(the_feature, "value", different_value.c_str());
     }
     the_feature.set_field("geomtype", geomtype);
-    the_feature.add_to_layer();
+    write_feature(the_feature, *error_layer);
 }
 
 void PlacesHandler::node(const osmium::Node& node) {
@@ -314,35 +289,216 @@ void PlacesHandler::node(const osmium::Node& node) {
         if (!strcmp(place, "city")) {
             add_feature(m_factory.create_point(node), node, "n", node.id(), place, true);
         }
+        const char* name = node.get_value_by_key("name");
+        if (name) {
+            m_join_nodes.push_back(JoinNode{node.id(), node.location(), node.timestamp(), place, name});
+        }
+    }
+}
+
+void PlacesHandler::add_join_area(const osmium::Area& area) {
+    const char* name = area.get_value_by_key("name");
+    if (!name) {
+        return;
+    }
+    const JoinArea join_area{area.orig_id(), area.from_way() ? 'w' : 'r', name};
+    if (area.num_rings().first == 0) {
+        // The assembler creates empty areas for broken multipolygons.
+        m_failed_areas.emplace(join_area.name, join_area);
+        return;
+    }
+    for (const auto& outer_ring : area.outer_rings()) {
+        m_area_index.add_ring(outer_ring.begin(), outer_ring.end());
+        for (const auto& inner_ring : area.inner_rings(outer_ring)) {
+            m_area_index.add_ring(inner_ring.begin(), inner_ring.end());
+        }
+    }
+    m_area_index.finish_polygon();
+    m_join_areas.push_back(join_area);
+}
+
+PlacesHandler::JoinResult PlacesHandler::join_node(const JoinNode& node, size_t& area) const {
+    // Areas with the same name are looked for within 0.05 degrees (about 5 km) of the node.
+    constexpr int32_t distance = 500000;
+    const PlaceAreaIndex::Box box{node.location.x() - distance, node.location.y() - distance,
+        node.location.x() + distance, node.location.y() + distance};
+    bool contained = false;
+    area = std::numeric_limits<size_t>::max();
+    m_area_index.search(box, [this, &node, &area, &contained](const size_t candidate) {
+        if (contained || m_join_areas[candidate].name != node.name) {
+            return;
+        }
+        if (m_area_index.contains(candidate, node.location)) {
+            contained = true;
+        } else {
+            area = std::min(area, candidate);
+        }
+    });
+    if (contained) {
+        return JoinResult::ok;
+    }
+    if (area != std::numeric_limits<size_t>::max()) {
+        return JoinResult::outside_area;
+    }
+    if (node.place != "city") {
+        return JoinResult::ok;
+    }
+    // Do not blame the node if the area it belongs to is broken.
+    return m_failed_areas.count(node.name) ? JoinResult::area_failed : JoinResult::no_area;
+}
+
+void PlacesHandler::join_places() {
+    m_options.verbose_output << "Joining " << m_join_nodes.size() << " place nodes with "
+            << m_join_areas.size() << " place and boundary areas (" << m_failed_areas.size()
+            << " areas could not be assembled) ...\n";
+    m_area_index.prepare();
+    // The nodes are tested in parallel, the errors are written afterwards.
+    const size_t thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<JoinResult> results(m_join_nodes.size());
+    std::vector<size_t> areas(m_join_nodes.size());
+    std::vector<std::future<void>> workers;
+    for (size_t t = 0; t < thread_count; ++t) {
+        const size_t begin = m_join_nodes.size() * t / thread_count;
+        const size_t end = m_join_nodes.size() * (t + 1) / thread_count;
+        workers.push_back(std::async(std::launch::async, [this, begin, end, &results, &areas]() {
+            for (size_t i = begin; i < end; ++i) {
+                results[i] = join_node(m_join_nodes[i], areas[i]);
+            }
+        }));
+    }
+    for (auto& worker : workers) {
+        worker.get();
+    }
+    size_t errors = 0;
+    static char idbuffer[20];
+    for (size_t i = 0; i < m_join_nodes.size(); ++i) {
+        if (results[i] == JoinResult::ok) {
+            continue;
+        }
+        ++errors;
+        const JoinNode& node = m_join_nodes[i];
+        gdalcpp::Feature feature(*m_errors_place_areas, m_factory.create_point(node.location));
+        sprintf(idbuffer, "%ld", node.id);
+        feature.set_field("node_id", idbuffer);
+        set_text_field(feature, "place", node.place.c_str());
+        set_text_field(feature, "name", node.name.c_str());
+        if (results[i] == JoinResult::outside_area || results[i] == JoinResult::area_failed) {
+            const JoinArea& area = results[i] == JoinResult::outside_area
+                ? m_join_areas[areas[i]] : m_failed_areas.find(node.name)->second;
+            feature.set_field("error", results[i] == JoinResult::outside_area
+                    ? "place node outside area with the same name" : "city area could not be assembled");
+            sprintf(idbuffer, "%ld", area.id);
+            feature.set_field("area_id", idbuffer);
+            const char area_type[2] = {area.geomtype, '\0'};
+            feature.set_field("area_type", area_type);
+        } else {
+            feature.set_field("error", "city without area");
+        }
+        std::string the_timestamp (node.timestamp.to_iso());
+        feature.set_field("lastchange", the_timestamp.c_str());
+        write_feature(feature, *m_errors_place_areas);
+    }
+    m_options.verbose_output << "Found " << errors << " place nodes not matching the areas\n";
+    m_area_index.clear();
+    std::vector<JoinArea>{}.swap(m_join_areas);
+    std::vector<JoinNode>{}.swap(m_join_nodes);
+    std::unordered_map<std::string, JoinArea>{}.swap(m_failed_areas);
+}
+
+size_t PlacesHandler::join_memory() const noexcept {
+    return m_area_index.used_memory() + m_join_areas.capacity() * sizeof(JoinArea)
+        + m_join_nodes.capacity() * sizeof(JoinNode)
+        + m_failed_areas.size() * (sizeof(std::string) + sizeof(JoinArea));
+}
+
+bool PlacesHandler::area_centroid(const OGRMultiPolygon& multipolygon, OGRPoint& centroid) {
+    // Area-weighted centroid (shoelace formula) of all rings, holes are subtracted. Coordinates
+    // are shifted to the first point to keep the products small.
+    double origin_x = 0.0;
+    double origin_y = 0.0;
+    bool origin_set = false;
+    double area_sum = 0.0;
+    double x_sum = 0.0;
+    double y_sum = 0.0;
+    for (int p = 0; p < multipolygon.getNumGeometries(); ++p) {
+        const OGRPolygon* polygon = static_cast<const OGRPolygon*>(multipolygon.getGeometryRef(p));
+        for (int r = -1; r < polygon->getNumInteriorRings(); ++r) {
+            const OGRLinearRing* ring = (r == -1) ? polygon->getExteriorRing() : polygon->getInteriorRing(r);
+            if (!ring || ring->getNumPoints() < 4) {
+                continue;
+            }
+            if (!origin_set) {
+                origin_x = ring->getX(0);
+                origin_y = ring->getY(0);
+                origin_set = true;
+            }
+            double ring_area = 0.0;
+            double ring_x = 0.0;
+            double ring_y = 0.0;
+            double x0 = ring->getX(0) - origin_x;
+            double y0 = ring->getY(0) - origin_y;
+            for (int i = 1; i < ring->getNumPoints(); ++i) {
+                const double x1 = ring->getX(i) - origin_x;
+                const double y1 = ring->getY(i) - origin_y;
+                const double cross = x0 * y1 - x1 * y0;
+                ring_area += cross;
+                ring_x += (x0 + x1) * cross;
+                ring_y += (y0 + y1) * cross;
+                x0 = x1;
+                y0 = y1;
+            }
+            // Outer rings count positive, inner rings negative, regardless of their orientation.
+            const bool reverse = (r == -1) ? (ring_area < 0) : (ring_area > 0);
+            if (reverse) {
+                ring_area = -ring_area;
+                ring_x = -ring_x;
+                ring_y = -ring_y;
+            }
+            area_sum += ring_area;
+            x_sum += ring_x;
+            y_sum += ring_y;
+        }
     }
+    if (area_sum <= 0.0) {
+        return false;
+    }
+    centroid.setX(x_sum / (3.0 * area_sum) + origin_x);
+    centroid.setY(y_sum / (3.0 * area_sum) + origin_y);
+    return true;
 }
 
 void PlacesHandler::area(const osmium::Area& area) {
     const char* place = area.get_value_by_key("place");
+    const bool boundary = area.tags().has_tag("boundary", "administrative");
+    if ((!place && !boundary) || !coordinates_valid(area)) {
+        return;
+    }
+    add_join_area(area);
+    if (!place) {
+        // administrative boundaries are used for the join with the place nodes only
+        return;
+    }
     try {
-        std::string geomtype;
-        if (place) {
-            if (!coordinates_valid(area)) {
-                return;
-            }
-            if (area.from_way()) {
-                geomtype = "w";
-                add_feature(m_factory.create_multipolygon(area), area, geomtype.c_str(), area.orig_id(), place);
+        const char* geomtype = area.from_way() ? "w" : "r";
+        // The multipolygon is built only once and used by the errors of both features.
+        std::unique_ptr<OGRMultiPolygon> multipolygon = m_factory.create_multipolygon(area);
+        std::unique_ptr<OGRPoint> centroid_point;
+        if (!strcmp(place, "city")) {
+            centroid_point.reset(new OGRPoint());
+            if (!area_centroid(*multipolygon, *centroid_point)) {
+                m_options.verbose_output << "Error creating centroid for area " << area.id() << "\n";
+                centroid_point.reset();
             } else {
-                geomtype = "r";
-                add_feature(m_factory.create_multipolygon(area), area, geomtype.c_str(), area.orig_id(), place);
+                centroid_point->assignSpatialReference(multipolygon->getSpatialReference());
             }
         }
-        if (place && !strcmp(place, "city")) {
-            std::unique_ptr<OGRMultiPolygon> multipolygon = m_factory.create_multipolygon(area);
-            auto centroid_point = std::unique_ptr<OGRPoint>(new OGRPoint());
-            OGRErr centroid_error = multipolygon->Centroid(centroid_point.get());
-            if (centroid_error == OGRERR_NONE) {
-                add_feature(std::unique_ptr<OGRPoint>(std::move(centroid_point)), area, geomtype.c_str(), area.orig_id(), place, true);
-            } else {
-                m_options.verbose_output << "Error creating centroid for area " << area.id() << ": " << centroid_error << "\n";
-            }
+        // The centroid feature is written first because its errors refer to the multipolygon
+        // which is moved into its own feature afterwards.
+        if (centroid_point) {
+            add_feature(std::move(centroid_point), area, geomtype, area.orig_id(), place, true,
+                    multipolygon.get());
         }
+        add_feature(std::move(multipolygon), area, geomtype, area.orig_id(), place);
     } catch (osmium::geometry_error& err) {
         m_options.verbose_output << err.what();
     } catch (osmium::not_found& err) {
@@ -22,19 +22,66 @@
 #define SRC_PLACES_HANDLER_HPP_
 
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <osmium/osm/location.hpp>
+#include <osmium/osm/timestamp.hpp>
 
 #include "abstract_view_handler.hpp"
+#include "place_area_index.hpp"
 
 class PlacesHandler : public AbstractViewHandler {
 
+    /// named place or administrative boundary area for the join with the place nodes
+    struct JoinArea {
+        osmium::object_id_type id;
+        /// w = way, r = relation
+        char geomtype;
+        std::string name;
+    };
+
+    /// named place node for the join with the areas
+    struct JoinNode {
+        osmium::object_id_type id;
+        osmium::Location location;
+        osmium::Timestamp timestamp;
+        std::string place;
+        std::string name;
+    };
+
+    /// result of the join of a place node
+    enum class JoinResult : uint8_t {
+        ok = 0,
+        /// only areas with the same name nearby which do not contain the node
+        outside_area = 1,
+        /// a city without an area with the same name
+        no_area = 2,
+        /// a city without an area, but an area with the same name could not be assembled
+        area_failed = 3
+    };
+
     std::unique_ptr<gdalcpp::Layer> m_points;
     std::unique_ptr<gdalcpp::Layer> m_polygons;
     std::unique_ptr<gdalcpp::Layer> m_errors_points;
     std::unique_ptr<gdalcpp::Layer> m_errors_polygons;
     std::unique_ptr<gdalcpp::Layer> m_cities;
+    /// layer for place nodes which do not match the place and boundary areas
+    std::unique_ptr<gdalcpp::Layer> m_errors_place_areas;
+
+    /// polygons of m_join_areas
+    PlaceAreaIndex m_area_index;
+    std::vector<JoinArea> m_join_areas;
+    std::vector<JoinNode> m_join_nodes;
+    /// named areas which could not be assembled (no rings), by name
+    std::unordered_map<std::string, JoinArea> m_failed_areas;
+
+    /// allowed values of the place key (check place_type of the rules file)
+    const CheckRule* m_place_types;
 
     /**
-     * Check if value of the place tag is well-known.
+     * Check if value of the place tag is well-known (check place_type of the rules file).
      *
      * \param value value of the place key
      */
@@ -42,8 +89,11 @@ class PlacesHandler : public AbstractViewHandler {
 
     /**
      * Check if the place node is a capital of an admin_level-2 country.
+     *
+     * \param tags tags of the object
+     * \param admin_level value of the admin_level tag read as an integer
      */
-    bool is_capital(const osmium::TagList& tags);
+    bool is_capital(const osmium::TagList& tags, const long admin_level);
 
     /**
      * Add a feature to the output layers.
@@ -56,10 +106,12 @@ class PlacesHandler : public AbstractViewHandler {
      * \param id ID of the OSM object
      * \param place_value value of the place key of the OSM object
      * \param should the object be added to the cities layer instead of a normal layer?
+     * \param error_geometry geometry to be used for errors (copies of `geometry` are used if it is nullptr,
+     * except for areas written to the cities layer)
      */
     void add_feature(std::unique_ptr<OGRGeometry>&& geometry, const osmium::OSMObject& osm_object,
             const char* geomtype, const osmium::object_id_type id, const char* place_value,
-            bool city_layer = false);
+            bool city_layer = false, const OGRGeometry* error_geometry = nullptr);
 
     /**
      * Set some basic fields needed by all layers
@@ -81,25 +133,70 @@ class PlacesHandler : public AbstractViewHandler {
      * \param id ID of the OSM object
      * \param error type of error
      * \param different_value string to be to the `value` column if it should not be the value of the place key
+     * \param geometry_source geometry of the OSM object if it has been built already. A copy of it is
+     * written instead of building the geometry again.
      */
     void add_error(const osmium::OSMObject& osm_object, const osmium::object_id_type id,
-            const char* geomtype, std::string error, std::string different_value = "");
+            const char* geomtype, std::string error, std::string different_value = "",
+            const OGRGeometry* geometry_source = nullptr);
 
     /**
      * Check if the population of a settlement is within resonable bounds.
      */
     void check_population(const osmium::OSMObject& osm_object, const osmium::object_id_type id,
-            const char* geomtype, const char* place_value, long int population);
+            const char* geomtype, const char* place_value, long int population,
+            const OGRGeometry* geometry = nullptr);
+
+    /**
+     * Calculate the area-weighted centroid of a multipolygon directly on its rings.
+     *
+     * Inner rings are subtracted. This gives the same result as OGRGeometry::Centroid but avoids
+     * the conversion to a GEOS geometry.
+     *
+     * \param multipolygon multipolygon (projected coordinates)
+     * \param centroid point to write the centroid to
+     *
+     * \returns false if the multipolygon has no area
+     */
+    static bool area_centroid(const OGRMultiPolygon& multipolygon, OGRPoint& centroid);
+
+    /**
+     * Add a named area to the areas joined with the place nodes. Areas which could not be
+     * assembled are remembered by their name.
+     */
+    void add_join_area(const osmium::Area& area);
+
+    /**
+     * Check a place node against the areas with the same name nearby.
+     *
+     * \param node place node
+     * \param area set to the index of an area with the same name not containing the node
+     */
+    JoinResult join_node(const JoinNode& node, size_t& area) const;
 
 public:
     PlacesHandler() = delete;
 
-    PlacesHandler(Options& options);
+    PlacesHandler(Options& options, gdalcpp::Dataset* shared_dataset = nullptr);
 
     void give_correct_name();
 
     void close();
 
+    /**
+     * Check all place nodes against the areas in parallel and write the mismatches to the output
+     * layer.
+     *
+     * This has to be called before close(). It is not part of close() because the handlers are
+     * closed in parallel while the join uses all cores.
+     */
+    void join_places();
+
+    /**
+     * Memory in bytes used by the areas and nodes kept for the join (without their names)
+     */
+    size_t join_memory() const noexcept;
+
     void node(const osmium::Node& node);
 
     void area(const osmium::Area& area);
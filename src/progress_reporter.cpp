@@ -0,0 +1,151 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "progress_reporter.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+constexpr uint64_t ProgressReporter::PUBLISH_INTERVAL;
+
+namespace {
+
+    /**
+     * Format a duration as HH:MM:SS.
+     */
+    std::string format_duration(const double seconds) {
+        const long int s = static_cast<long int>(seconds + 0.5);
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%02ld:%02ld:%02ld", s / 3600, (s / 60) % 60, s % 60);
+        return buffer;
+    }
+
+    /**
+     * Format a count and its rate per second.
+     */
+    std::string format_count(const char* name, const uint64_t count, const double seconds) {
+        char buffer[96];
+        snprintf(buffer, sizeof(buffer), " %s %llu (%.0f/s)", name, static_cast<unsigned long long>(count),
+                seconds > 0 ? count / seconds : 0.0);
+        return buffer;
+    }
+
+} // namespace
+
+ProgressReporter::ProgressReporter(Options& options) :
+    m_options(options),
+    m_enabled(options.progress || !options.progress_file.empty()) {
+}
+
+ProgressReporter::~ProgressReporter() {
+    end_pass();
+}
+
+void ProgressReporter::start_pass(const std::string& pass_name, const osmium::io::Reader& reader) {
+    end_pass();
+    m_pass_name = pass_name;
+    m_reader = &reader;
+    m_file_size = reader.file_size();
+    m_start = clock_type::now();
+    m_nodes = 0;
+    m_ways = 0;
+    m_relations = 0;
+    m_published_nodes.store(0, std::memory_order_relaxed);
+    m_published_ways.store(0, std::memory_order_relaxed);
+    m_published_relations.store(0, std::memory_order_relaxed);
+    if (!m_enabled) {
+        return;
+    }
+    m_stop = false;
+    m_thread = std::thread(&ProgressReporter::run, this);
+}
+
+void ProgressReporter::end_pass() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+    m_published_nodes.store(m_nodes, std::memory_order_relaxed);
+    m_published_ways.store(m_ways, std::memory_order_relaxed);
+    m_published_relations.store(m_relations, std::memory_order_relaxed);
+    report(true);
+    m_reader = nullptr;
+}
+
+void ProgressReporter::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_condition.wait_for(lock, std::chrono::seconds(m_options.progress_interval),
+            [this]() { return m_stop; })) {
+        report(false);
+    }
+}
+
+void ProgressReporter::report(const bool final) {
+    const double seconds = std::chrono::duration<double>(clock_type::now() - m_start).count();
+    std::string line = m_pass_name;
+    if (final) {
+        line += ": done";
+    } else if (m_file_size > 0) {
+        const size_t offset = m_reader->offset();
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), ": %.1f%%", 100.0 * offset / m_file_size);
+        line += buffer;
+    } else {
+        line += ":";
+    }
+    line += format_count("nodes", m_published_nodes.load(std::memory_order_relaxed), seconds);
+    line += format_count("ways", m_published_ways.load(std::memory_order_relaxed), seconds);
+    line += format_count("relations", m_published_relations.load(std::memory_order_relaxed), seconds);
+    line += " elapsed ";
+    line += format_duration(seconds);
+    if (!final && m_file_size > 0) {
+        // The ETA is based on the part of the file read so far. It is not available if reading from stdin.
+        const size_t offset = m_reader->offset();
+        line += " ETA ";
+        if (offset > 0) {
+            line += format_duration(seconds * (m_file_size - std::min(offset, m_file_size)) / offset);
+        } else {
+            line += "unknown";
+        }
+    }
+    write(line);
+}
+
+void ProgressReporter::write(const std::string& line) {
+    if (m_options.progress) {
+        std::cerr << line << '\n';
+    }
+    if (!m_options.progress_file.empty()) {
+        // Write to a temporary file and rename it to make the update atomic for readers.
+        const std::string temp_filename = m_options.progress_file + ".tmp";
+        FILE* file = fopen(temp_filename.c_str(), "w");
+        if (!file) {
+            return;
+        }
+        fprintf(file, "%s\n", line.c_str());
+        fclose(file);
+        rename(temp_filename.c_str(), m_options.progress_file.c_str());
+    }
+}
@@ -0,0 +1,129 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_PROGRESS_REPORTER_HPP_
+#define SRC_PROGRESS_REPORTER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <osmium/handler.hpp>
+#include <osmium/io/reader.hpp>
+
+#include "options.hpp"
+
+/**
+ * Report the progress of a pass over the input file.
+ *
+ * The handler counts the nodes, ways and relations it sees. A background thread prints the
+ * counts, the throughput and an estimated time of arrival (based on the offset of the reader in
+ * the input file) in regular intervals to stderr or to a status file.
+ *
+ * The counters are plain integers on the hot path. They are published to the background thread
+ * every few thousand objects only.
+ */
+class ProgressReporter : public osmium::handler::Handler {
+
+    using clock_type = std::chrono::steady_clock;
+
+    /// counters are published every PUBLISH_INTERVAL objects (has to be a power of two)
+    static constexpr uint64_t PUBLISH_INTERVAL = 4096;
+
+    Options& m_options;
+
+    bool m_enabled;
+
+    std::string m_pass_name;
+
+    const osmium::io::Reader* m_reader = nullptr;
+
+    size_t m_file_size = 0;
+
+    clock_type::time_point m_start;
+
+    uint64_t m_nodes = 0;
+    uint64_t m_ways = 0;
+    uint64_t m_relations = 0;
+
+    std::atomic<uint64_t> m_published_nodes {0};
+    std::atomic<uint64_t> m_published_ways {0};
+    std::atomic<uint64_t> m_published_relations {0};
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stop = false;
+
+    /**
+     * Body of the background thread
+     */
+    void run();
+
+    /**
+     * Print a status line.
+     *
+     * \param final true if the pass is finished
+     */
+    void report(const bool final);
+
+    void write(const std::string& line);
+
+public:
+    explicit ProgressReporter(Options& options);
+
+    ~ProgressReporter();
+
+    /**
+     * Start reporting the progress of a new pass.
+     *
+     * \param pass_name name of the pass used in the status lines
+     * \param reader reader of the pass (has to live until end_pass() is called)
+     */
+    void start_pass(const std::string& pass_name, const osmium::io::Reader& reader);
+
+    /**
+     * Stop reporting and print a summary of the pass.
+     */
+    void end_pass();
+
+    void node(const osmium::Node&) noexcept {
+        if ((++m_nodes & (PUBLISH_INTERVAL - 1)) == 0) {
+            m_published_nodes.store(m_nodes, std::memory_order_relaxed);
+        }
+    }
+
+    void way(const osmium::Way&) noexcept {
+        if ((++m_ways & (PUBLISH_INTERVAL - 1)) == 0) {
+            m_published_ways.store(m_ways, std::memory_order_relaxed);
+        }
+    }
+
+    void relation(const osmium::Relation&) noexcept {
+        if ((++m_relations & (PUBLISH_INTERVAL - 1)) == 0) {
+            m_published_relations.store(m_relations, std::memory_order_relaxed);
+        }
+    }
+};
+
+#endif /* SRC_PROGRESS_REPORTER_HPP_ */
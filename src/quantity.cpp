@@ -0,0 +1,124 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantity.hpp"
+
+#include <cstdint>
+#include <limits>
+
+namespace {
+
+    inline bool is_digit(const char c) noexcept {
+        return c >= '0' && c <= '9';
+    }
+
+    /// whitespace according to isspace() in the C locale
+    inline bool is_space(const char c) noexcept {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    constexpr double POWERS_OF_TEN[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+} // anonymous namespace
+
+Quantity Quantity::parse(const char* str) noexcept {
+    Quantity result;
+    result.str = str;
+    result.integer_end = str;
+    result.real_end = str;
+
+    const char* c = str;
+    while (is_space(*c)) {
+        ++c;
+    }
+    bool negative = false;
+    if (*c == '-' || *c == '+') {
+        negative = (*c == '-');
+        ++c;
+    }
+
+    // integer part, used for both readings
+    constexpr uint64_t max_mantissa = (uint64_t{1} << 53);
+    constexpr long max_long = std::numeric_limits<long>::max();
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    unsigned long integer = 0;
+    bool integer_overflow = false;
+    bool digits = false;
+    for (; is_digit(*c); ++c) {
+        digits = true;
+        const unsigned digit = static_cast<unsigned>(*c - '0');
+        if (!integer_overflow) {
+            if (integer > (static_cast<unsigned long>(max_long) - digit) / 10) {
+                integer_overflow = true;
+            } else {
+                integer = integer * 10 + digit;
+            }
+        }
+        if (mantissa < max_mantissa / 10) {
+            mantissa = mantissa * 10 + digit;
+        } else {
+            // digits beyond the precision of a double only scale the number
+            ++exponent;
+        }
+    }
+    if (digits) {
+        result.integer_end = c;
+        if (integer_overflow) {
+            result.integer = negative ? std::numeric_limits<long>::min() : max_long;
+        } else {
+            result.integer = negative ? -static_cast<long>(integer) : static_cast<long>(integer);
+        }
+    }
+
+    // fractional part, decimal number only
+    if (*c == '.') {
+        ++c;
+        for (; is_digit(*c); ++c) {
+            digits = true;
+            if (mantissa < max_mantissa / 10) {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*c - '0');
+                --exponent;
+            }
+        }
+    }
+    if (!digits) {
+        return result;
+    }
+    result.real_end = c;
+    // mantissa < 2^53 and powers of ten up to 1e22 are exact, i.e. the result is rounded
+    // correctly for up to 15 significant digits and up to 22 decimal places. Longer numbers may
+    // be off by a few units in the last place, which does not matter for tag values.
+    double value = static_cast<double>(mantissa);
+    while (exponent < 0) {
+        const int step = -exponent > 22 ? 22 : -exponent;
+        value /= POWERS_OF_TEN[step];
+        exponent += step;
+    }
+    while (exponent > 0) {
+        const int step = exponent > 22 ? 22 : exponent;
+        value *= POWERS_OF_TEN[step];
+        exponent -= step;
+    }
+    result.real = negative ? -value : value;
+    return result;
+}
@@ -0,0 +1,76 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_QUANTITY_HPP_
+#define SRC_QUANTITY_HPP_
+
+/**
+ * A number at the beginning of a tag value, e.g. "50", "30 mph", "7.5", "12 t" or "12'6\"".
+ *
+ * The value is scanned once and read both as an integer and as a decimal number. The unit is
+ * whatever follows the number ("" for "50", " mph" for "30 mph"). The syntax follows strtol()
+ * and strtod() in the C locale: optional leading whitespace and sign, digits and (for decimal
+ * numbers only) a decimal point. Exponents, hexadecimal numbers, "inf" and "nan" are not
+ * accepted. The result does not depend on the locale and nothing is allocated.
+ */
+struct Quantity {
+
+    /// value as an integer (digits up to the first non-digit), saturated at the limits of long
+    long integer = 0;
+
+    /// value as a decimal number
+    double real = 0;
+
+    /**
+     * First character after the integer, the beginning of the string if there is no integer
+     * (like the end pointer of strtol())
+     */
+    const char* integer_end = nullptr;
+
+    /**
+     * First character after the decimal number, the beginning of the string if there is no
+     * number (like the end pointer of strtod())
+     */
+    const char* real_end = nullptr;
+
+    /// the string the quantity was read from
+    const char* str = nullptr;
+
+    bool has_integer() const noexcept {
+        return integer_end != str;
+    }
+
+    bool has_real() const noexcept {
+        return real_end != str;
+    }
+
+    /**
+     * Check if the string is an integer without anything following it.
+     */
+    bool is_integer() const noexcept {
+        return has_integer() && *integer_end == '\0';
+    }
+
+    /**
+     * Read a quantity.
+     */
+    static Quantity parse(const char* str) noexcept;
+};
+
+#endif /* SRC_QUANTITY_HPP_ */
@@ -0,0 +1,296 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "road_network_islands.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+constexpr unsigned int DenseNodeIndex::BLOCK_SHIFT;
+constexpr size_t DenseNodeIndex::WORDS_PER_BLOCK;
+constexpr size_t DenseNodeIndex::GROUP_SIZE;
+constexpr uint32_t DenseNodeIndex::NO_BLOCK;
+
+namespace {
+
+    inline int popcount(const uint64_t word) noexcept {
+        return __builtin_popcountll(word);
+    }
+
+    inline void append_varint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    inline uint64_t read_varint(const uint8_t*& data) noexcept {
+        uint64_t value = 0;
+        unsigned int shift = 0;
+        while (*data & 0x80) {
+            value |= static_cast<uint64_t>(*data & 0x7f) << shift;
+            shift += 7;
+            ++data;
+        }
+        value |= static_cast<uint64_t>(*data) << shift;
+        ++data;
+        return value;
+    }
+
+    inline uint64_t zigzag(const int64_t value) noexcept {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    inline int64_t unzigzag(const uint64_t value) noexcept {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    /**
+     * Disjoint-set forest with union by rank and path halving
+     */
+    class DisjointSets {
+
+        std::vector<uint32_t> m_parents;
+        std::vector<uint8_t> m_ranks;
+
+    public:
+        explicit DisjointSets(const size_t size) :
+            m_parents(size),
+            m_ranks(size, 0) {
+            std::iota(m_parents.begin(), m_parents.end(), 0);
+        }
+
+        uint32_t find(uint32_t element) noexcept {
+            while (m_parents[element] != element) {
+                m_parents[element] = m_parents[m_parents[element]];
+                element = m_parents[element];
+            }
+            return element;
+        }
+
+        void unite(const uint32_t a, const uint32_t b) noexcept {
+            uint32_t root_a = find(a);
+            uint32_t root_b = find(b);
+            if (root_a == root_b) {
+                return;
+            }
+            if (m_ranks[root_a] < m_ranks[root_b]) {
+                std::swap(root_a, root_b);
+            }
+            m_parents[root_b] = root_a;
+            if (m_ranks[root_a] == m_ranks[root_b]) {
+                ++m_ranks[root_a];
+            }
+        }
+    };
+
+} // anonymous namespace
+
+void DenseNodeIndex::set(const osmium::unsigned_object_id_type id) {
+    const size_t block_number = static_cast<size_t>(id >> BLOCK_SHIFT);
+    if (block_number >= m_block_index.size()) {
+        m_block_index.resize(block_number + 1, NO_BLOCK);
+    }
+    if (m_block_index[block_number] == NO_BLOCK) {
+        m_block_index[block_number] = static_cast<uint32_t>(m_blocks.size());
+        m_blocks.emplace_back(); // zero-initialized
+    }
+    const size_t bit = static_cast<size_t>(id & ((1u << BLOCK_SHIFT) - 1));
+    m_blocks[m_block_index[block_number]].words[bit / 64] |= 1ULL << (bit % 64);
+}
+
+void DenseNodeIndex::prepare() {
+    // The blocks were allocated in the order the IDs were seen. The base has to follow the order
+    // of the IDs.
+    uint64_t count = 0;
+    for (const uint32_t index : m_block_index) {
+        if (index == NO_BLOCK) {
+            continue;
+        }
+        Block& block = m_blocks[index];
+        if (count > 0xffffffffULL) {
+            throw std::length_error{"Too many nodes for the dense node index"};
+        }
+        block.base = static_cast<uint32_t>(count);
+        uint16_t block_count = 0;
+        for (size_t group = 0; group < WORDS_PER_BLOCK / GROUP_SIZE; ++group) {
+            block.group_ranks[group] = block_count;
+            for (size_t w = group * GROUP_SIZE; w < (group + 1) * GROUP_SIZE; ++w) {
+                block_count += static_cast<uint16_t>(popcount(block.words[w]));
+            }
+        }
+        count += block_count;
+    }
+    m_count = static_cast<size_t>(count);
+}
+
+uint32_t DenseNodeIndex::rank(const osmium::unsigned_object_id_type id) const noexcept {
+    const Block& block = m_blocks[m_block_index[static_cast<size_t>(id >> BLOCK_SHIFT)]];
+    const size_t bit = static_cast<size_t>(id & ((1u << BLOCK_SHIFT) - 1));
+    const size_t word = bit / 64;
+    const size_t group = word / GROUP_SIZE;
+    uint32_t result = block.base + block.group_ranks[group];
+    for (size_t w = group * GROUP_SIZE; w < word; ++w) {
+        result += static_cast<uint32_t>(popcount(block.words[w]));
+    }
+    return result + static_cast<uint32_t>(popcount(block.words[word] & ((1ULL << (bit % 64)) - 1)));
+}
+
+size_t DenseNodeIndex::used_memory() const noexcept {
+    return m_block_index.capacity() * sizeof(uint32_t) + m_blocks.capacity() * sizeof(Block);
+}
+
+void DenseNodeIndex::clear() {
+    std::vector<uint32_t>{}.swap(m_block_index);
+    std::vector<Block>{}.swap(m_blocks);
+    m_count = 0;
+}
+
+void RoadNetworkIslands::add_way(const osmium::object_id_type id, const osmium::WayNodeList& nodes, const double length,
+        const uint8_t cls /*= 0*/) {
+    if (nodes.empty()) {
+        return;
+    }
+    for (const osmium::NodeRef& nd_ref : nodes) {
+        if (nd_ref.ref() < 0) {
+            return;
+        }
+    }
+    if (m_way_ids.size() == 0xffffffff) {
+        throw std::length_error{"Too many ways for the road network islands"};
+    }
+    m_offsets.push_back(m_encoded.size());
+    m_way_ids.push_back(id);
+    m_lengths.push_back(static_cast<float>(length));
+    m_classes.push_back(cls);
+    append_varint(m_encoded, nodes.size());
+    int64_t last_ref = 0;
+    int64_t last_x = 0;
+    int64_t last_y = 0;
+    for (const osmium::NodeRef& nd_ref : nodes) {
+        m_node_index.set(static_cast<osmium::unsigned_object_id_type>(nd_ref.ref()));
+        append_varint(m_encoded, zigzag(nd_ref.ref() - last_ref));
+        append_varint(m_encoded, zigzag(nd_ref.location().x() - last_x));
+        append_varint(m_encoded, zigzag(nd_ref.location().y() - last_y));
+        last_ref = nd_ref.ref();
+        last_x = nd_ref.location().x();
+        last_y = nd_ref.location().y();
+    }
+}
+
+void RoadNetworkIslands::decode(const size_t way, std::vector<osmium::unsigned_object_id_type>* ids,
+        std::vector<osmium::Location>* locations) const {
+    const uint8_t* data = m_encoded.data() + m_offsets[way];
+    const uint64_t count = read_varint(data);
+    int64_t ref = 0;
+    int64_t x = 0;
+    int64_t y = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        ref += unzigzag(read_varint(data));
+        x += unzigzag(read_varint(data));
+        y += unzigzag(read_varint(data));
+        if (ids) {
+            ids->push_back(static_cast<osmium::unsigned_object_id_type>(ref));
+        }
+        if (locations) {
+            locations->emplace_back(static_cast<int32_t>(x), static_cast<int32_t>(y));
+        }
+    }
+}
+
+std::vector<osmium::Location> RoadNetworkIslands::locations(const size_t way) const {
+    std::vector<osmium::Location> result;
+    decode(way, nullptr, &result);
+    return result;
+}
+
+std::vector<RoadNetworkIslands::Island> RoadNetworkIslands::find_islands(const size_t max_ways, const double max_length) {
+    std::vector<Island> islands;
+    if (m_way_ids.empty()) {
+        return islands;
+    }
+    m_node_index.prepare();
+    DisjointSets sets{m_node_index.count()};
+    // component of each way (upper 32 bits) and the way (lower 32 bits)
+    std::vector<uint64_t> components;
+    components.reserve(m_way_ids.size());
+    std::vector<osmium::unsigned_object_id_type> ids;
+    for (size_t way = 0; way < m_way_ids.size(); ++way) {
+        ids.clear();
+        decode(way, &ids, nullptr);
+        const uint32_t first = m_node_index.rank(ids.front());
+        for (auto it = ids.begin() + 1; it != ids.end(); ++it) {
+            sets.unite(first, m_node_index.rank(*it));
+        }
+    }
+    for (size_t way = 0; way < m_way_ids.size(); ++way) {
+        const uint8_t* data = m_encoded.data() + m_offsets[way];
+        read_varint(data);
+        const osmium::unsigned_object_id_type first_ref = static_cast<osmium::unsigned_object_id_type>(unzigzag(read_varint(data)));
+        components.push_back((static_cast<uint64_t>(sets.find(m_node_index.rank(first_ref))) << 32) | way);
+    }
+    std::sort(components.begin(), components.end());
+
+    // The largest component is the main network. It is not known until all components have been
+    // summed up.
+    double largest_length = -1;
+    size_t largest = 0;
+    for (auto begin = components.begin(); begin != components.end();) {
+        auto end = begin;
+        Island island{{}, 0};
+        for (; end != components.end() && (*end >> 32) == (*begin >> 32); ++end) {
+            const size_t way = static_cast<size_t>(*end & 0xffffffff);
+            island.ways.push_back(way);
+            island.length += m_lengths[way];
+        }
+        const bool small = island.ways.size() < max_ways || island.length < max_length;
+        if (island.length > largest_length) {
+            largest_length = island.length;
+            largest = small ? islands.size() : static_cast<size_t>(-1);
+        }
+        if (small) {
+            islands.push_back(std::move(island));
+        }
+        begin = end;
+    }
+    if (largest < islands.size()) {
+        islands.erase(islands.begin() + largest);
+    }
+    std::sort(islands.begin(), islands.end(), [](const Island& lhs, const Island& rhs) {
+        return lhs.ways.front() < rhs.ways.front();
+    });
+    return islands;
+}
+
+size_t RoadNetworkIslands::used_memory() const noexcept {
+    return m_encoded.capacity() + m_offsets.capacity() * sizeof(uint64_t)
+            + m_way_ids.capacity() * sizeof(osmium::object_id_type) + m_lengths.capacity() * sizeof(float)
+            + m_classes.capacity() + m_node_index.used_memory();
+}
+
+void RoadNetworkIslands::clear() {
+    std::vector<uint8_t>{}.swap(m_encoded);
+    std::vector<uint64_t>{}.swap(m_offsets);
+    std::vector<osmium::object_id_type>{}.swap(m_way_ids);
+    std::vector<float>{}.swap(m_lengths);
+    std::vector<uint8_t>{}.swap(m_classes);
+    m_node_index.clear();
+}
@@ -0,0 +1,183 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_ROAD_NETWORK_ISLANDS_HPP_
+#define SRC_ROAD_NETWORK_ISLANDS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <osmium/osm/location.hpp>
+#include <osmium/osm/types.hpp>
+#include <osmium/osm/way.hpp>
+
+/**
+ * Set of node IDs which maps each ID to a dense index (its rank among all IDs in the set).
+ *
+ * The IDs are kept in a bitmap split into blocks of 4096 IDs. Blocks are allocated for ranges of
+ * IDs which contain at least one ID of the set only. After prepare() has been called, the rank of
+ * an ID is the number of IDs in the blocks before plus a few popcounts within its block.
+ *
+ * The set can hold up to 2^32 IDs.
+ */
+class DenseNodeIndex {
+
+    static constexpr unsigned int BLOCK_SHIFT = 12;
+    static constexpr size_t WORDS_PER_BLOCK = (1u << BLOCK_SHIFT) / 64;
+    /// number of words of a rank group
+    static constexpr size_t GROUP_SIZE = 8;
+    static constexpr uint32_t NO_BLOCK = 0xffffffff;
+
+    struct Block {
+        uint64_t words[WORDS_PER_BLOCK];
+        /// number of IDs in the blocks before this one
+        uint32_t base;
+        /// number of IDs in the groups of the block before each group
+        uint16_t group_ranks[WORDS_PER_BLOCK / GROUP_SIZE];
+    };
+
+    /// index of the block of each range of IDs in m_blocks or NO_BLOCK
+    std::vector<uint32_t> m_block_index;
+
+    std::vector<Block> m_blocks;
+
+    size_t m_count = 0;
+
+public:
+    /**
+     * Add an ID to the set. This invalidates the ranks until prepare() is called.
+     */
+    void set(const osmium::unsigned_object_id_type id);
+
+    /**
+     * Compute the ranks.
+     */
+    void prepare();
+
+    /**
+     * Dense index of an ID of the set (between 0 and count() - 1). The ID has to be in the set.
+     */
+    uint32_t rank(const osmium::unsigned_object_id_type id) const noexcept;
+
+    /**
+     * Number of IDs in the set (valid after prepare())
+     */
+    size_t count() const noexcept {
+        return m_count;
+    }
+
+    size_t used_memory() const noexcept;
+
+    void clear();
+};
+
+/**
+ * Connected components of a road network which are not connected with the largest component
+ * ("islands").
+ *
+ * The ways are stored compactly: the IDs and the coordinates of their nodes are delta encoded as
+ * variable length integers. The components are found with a disjoint-set structure over the dense
+ * indexes of the node IDs (5 bytes per node).
+ *
+ * Ways with negative node IDs are ignored. Up to 2^32 - 1 ways and 2^32 nodes are supported.
+ */
+class RoadNetworkIslands {
+
+public:
+    struct Island {
+        /// indexes of the ways of the island (ascending)
+        std::vector<size_t> ways;
+        /// length of all ways in metres
+        double length;
+    };
+
+private:
+    /// number of nodes and deltas of the node IDs and coordinates of all ways
+    std::vector<uint8_t> m_encoded;
+
+    /// offset of each way in m_encoded
+    std::vector<uint64_t> m_offsets;
+
+    std::vector<osmium::object_id_type> m_way_ids;
+
+    /// length of each way in metres
+    std::vector<float> m_lengths;
+
+    /// user defined value of each way
+    std::vector<uint8_t> m_classes;
+
+    DenseNodeIndex m_node_index;
+
+    /**
+     * Decode the node IDs and locations of a way.
+     */
+    void decode(const size_t way, std::vector<osmium::unsigned_object_id_type>* ids,
+            std::vector<osmium::Location>* locations) const;
+
+public:
+    /**
+     * Add a way. The locations of all nodes have to be valid.
+     *
+     * \param id ID of the way
+     * \param nodes nodes of the way
+     * \param length length of the way in metres
+     * \param cls arbitrary value to be kept with the way (e.g. to look up its type later)
+     */
+    void add_way(const osmium::object_id_type id, const osmium::WayNodeList& nodes, const double length,
+            const uint8_t cls = 0);
+
+    /**
+     * Find the components which are not the largest one (by length) and have less than
+     * max_ways ways or are shorter than max_length.
+     *
+     * \returns islands ordered by their first way
+     */
+    std::vector<Island> find_islands(const size_t max_ways, const double max_length);
+
+    size_t size() const noexcept {
+        return m_way_ids.size();
+    }
+
+    osmium::object_id_type id(const size_t way) const {
+        return m_way_ids[way];
+    }
+
+    uint8_t cls(const size_t way) const {
+        return m_classes[way];
+    }
+
+    double length(const size_t way) const {
+        return m_lengths[way];
+    }
+
+    /**
+     * Get the locations of the nodes of a way.
+     */
+    std::vector<osmium::Location> locations(const size_t way) const;
+
+    size_t used_memory() const noexcept;
+
+    /**
+     * Remove all ways and free the memory.
+     */
+    void clear();
+};
+
+#endif /* SRC_ROAD_NETWORK_ISLANDS_HPP_ */
@@ -0,0 +1,43 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "shard.hpp"
+
+#include <cstdlib>
+
+bool Shard::parse(const char* spec, const double overlap_degrees) {
+    char* rest;
+    long int index = std::strtol(spec, &rest, 10);
+    if (rest == spec || *rest != '/') {
+        return false;
+    }
+    const char* count_str = rest + 1;
+    long int count = std::strtol(count_str, &rest, 10);
+    if (rest == count_str || *rest || count < 1 || index < 0 || index >= count
+            || overlap_degrees < 0 || overlap_degrees > 180) {
+        return false;
+    }
+    m_index = static_cast<int>(index);
+    m_count = static_cast<int>(count);
+    const int64_t planet_width = static_cast<int64_t>(osmium::Location::coordinate_precision) * 360;
+    m_min_x = static_cast<int32_t>(planet_width * m_index / m_count - planet_width / 2);
+    m_max_x = static_cast<int32_t>(planet_width * (m_index + 1) / m_count - planet_width / 2);
+    m_overlap = static_cast<int32_t>(overlap_degrees * osmium::Location::coordinate_precision);
+    return true;
+}
@@ -0,0 +1,173 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_SHARD_HPP_
+#define SRC_SHARD_HPP_
+
+#include <cstdint>
+
+#include <osmium/handler.hpp>
+#include <osmium/osm/area.hpp>
+#include <osmium/osm/location.hpp>
+#include <osmium/osm/node.hpp>
+#include <osmium/osm/way.hpp>
+
+/**
+ * A spatial shard of the planet.
+ *
+ * The planet is split into N stripes of equal width along the longitude axis. A run for shard i
+ * only writes objects owned by this shard:
+ *
+ * * Nodes are owned by the shard their location is in.
+ * * Ways are owned by the shard of their first node.
+ * * Areas are owned by the shard of the first node of their first outer ring.
+ *
+ * The location index of a shard only contains nodes inside the shard and inside an overlap zone
+ * around it. Ways which leave the overlap zone lack locations and cannot be processed.
+ *
+ * A default constructed shard covers the whole planet.
+ */
+class Shard {
+    int m_index = 0;
+    int m_count = 1;
+    int32_t m_min_x = osmium::Location::coordinate_precision * -180;
+    int32_t m_max_x = osmium::Location::coordinate_precision * 180;
+    int32_t m_overlap = 0;
+
+    inline bool in_range(const int64_t x, const int64_t min_x, const int64_t max_x) const {
+        // The last shard includes the antimeridian.
+        return x >= min_x && (x < max_x || (m_index == m_count - 1 && x <= max_x));
+    }
+
+public:
+    Shard() = default;
+
+    /**
+     * Set up the shard from a string like "2/8" (third of eight shards).
+     *
+     * \param spec shard index (counted from 0) and shard count separated by a slash
+     * \param overlap_degrees width of the overlap zone around the shard in degrees
+     *
+     * \returns false if the string is invalid
+     */
+    bool parse(const char* spec, const double overlap_degrees);
+
+    bool enabled() const noexcept {
+        return m_count > 1;
+    }
+
+    int index() const noexcept {
+        return m_index;
+    }
+
+    int count() const noexcept {
+        return m_count;
+    }
+
+    /**
+     * Check if a location is inside this shard.
+     */
+    inline bool owns(const osmium::Location location) const {
+        if (!enabled()) {
+            return true;
+        }
+        return location.valid() && in_range(location.x(), m_min_x, m_max_x);
+    }
+
+    /**
+     * Check if a location is inside this shard or its overlap zone, i.e. if the location has to be
+     * stored in the location index.
+     */
+    inline bool in_extended_area(const osmium::Location location) const {
+        if (!enabled()) {
+            return true;
+        }
+        return location.valid() && in_range(location.x(), static_cast<int64_t>(m_min_x) - m_overlap,
+                static_cast<int64_t>(m_max_x) + m_overlap);
+    }
+
+    inline bool owns(const osmium::Node& node) const {
+        return owns(node.location());
+    }
+
+    inline bool owns(const osmium::Way& way) const {
+        if (!enabled()) {
+            return true;
+        }
+        return !way.nodes().empty() && owns(way.nodes().front().location());
+    }
+
+    inline bool owns(const osmium::Area& area) const {
+        if (!enabled()) {
+            return true;
+        }
+        // reference node: first node of the first outer ring
+        const auto outer_rings = area.outer_rings();
+        const auto first_ring = outer_rings.begin();
+        return first_ring != outer_rings.end() && !first_ring->empty() && owns(first_ring->front().location());
+    }
+};
+
+/**
+ * Wrapper around a NodeLocationsForWays handler which only stores the locations of nodes inside
+ * the shard and its overlap zone.
+ *
+ * Ways of the shard which lack node locations afterwards (because they reach beyond the overlap
+ * zone) are counted.
+ */
+template <typename TLocationHandler>
+class ShardLocationsForWays : public osmium::handler::Handler {
+    TLocationHandler& m_location_handler;
+    const Shard& m_shard;
+    uint64_t m_incomplete_ways = 0;
+
+public:
+    ShardLocationsForWays(TLocationHandler& location_handler, const Shard& shard) :
+        m_location_handler(location_handler),
+        m_shard(shard) {
+    }
+
+    void node(const osmium::Node& node) {
+        if (m_shard.in_extended_area(node.location())) {
+            m_location_handler.node(node);
+        }
+    }
+
+    void way(osmium::Way& way) {
+        m_location_handler.way(way);
+        if (!m_shard.enabled() || !m_shard.owns(way)) {
+            return;
+        }
+        for (const osmium::NodeRef& nd_ref : way.nodes()) {
+            if (!nd_ref.location().valid()) {
+                ++m_incomplete_ways;
+                return;
+            }
+        }
+    }
+
+    /**
+     * Number of ways owned by the shard with nodes without location
+     */
+    uint64_t incomplete_ways() const noexcept {
+        return m_incomplete_ways;
+    }
+};
+
+#endif /* SRC_SHARD_HPP_ */
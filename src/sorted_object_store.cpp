@@ -0,0 +1,183 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sorted_object_store.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <memory>
+#include <queue>
+#include <system_error>
+#include <utility>
+
+namespace {
+
+    /**
+     * Reader of the objects of a sorted run one after another.
+     */
+    class RunReader {
+        FILE* m_file;
+        /// 8-byte aligned storage of the current object
+        std::vector<uint64_t> m_data;
+        uint64_t m_key = 0;
+
+    public:
+        explicit RunReader(FILE* file) :
+            m_file(file),
+            m_data() {
+            std::rewind(m_file);
+        }
+
+        /**
+         * Read the next object of the run.
+         *
+         * \returns false if the run is exhausted
+         */
+        bool next() {
+            uint64_t header[2];
+            if (std::fread(header, sizeof(uint64_t), 2, m_file) != 2) {
+                return false;
+            }
+            m_key = header[0];
+            const size_t size = static_cast<size_t>(header[1]);
+            m_data.resize((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+            if (std::fread(m_data.data(), 1, size, m_file) != size) {
+                throw std::system_error{errno, std::system_category(), "Failed to read from temporary file"};
+            }
+            return true;
+        }
+
+        uint64_t key() const noexcept {
+            return m_key;
+        }
+
+        const osmium::memory::Item& item() const noexcept {
+            return *reinterpret_cast<const osmium::memory::Item*>(m_data.data());
+        }
+    };
+
+} // namespace
+
+constexpr size_t SortedObjectStore::CHUNK_SIZE;
+
+SortedObjectStore::SortedObjectStore(const size_t max_memory /*= 0*/) :
+    m_max_memory(max_memory),
+    m_chunk_size(max_memory == 0 ? CHUNK_SIZE
+            : std::max(static_cast<size_t>(4096), std::min(CHUNK_SIZE, max_memory / 4 / 8 * 8))),
+    m_chunks(),
+    m_entries(),
+    m_runs() {
+}
+
+SortedObjectStore::~SortedObjectStore() {
+    for (FILE* run : m_runs) {
+        std::fclose(run);
+    }
+}
+
+void SortedObjectStore::add(const uint64_t key, const osmium::memory::Item& item) {
+    const size_t size = item.padded_size();
+    if (m_chunks.empty() || m_chunks.back().capacity() - m_chunks.back().committed() < size) {
+        if (m_max_memory > 0 && !m_chunks.empty() && used_memory() + m_chunk_size > m_max_memory) {
+            spill();
+        }
+        // Objects larger than a chunk get a buffer of their own.
+        m_chunks.emplace_back(std::max(m_chunk_size, size), osmium::memory::Buffer::auto_grow::no);
+    }
+    osmium::memory::Buffer& chunk = m_chunks.back();
+    const size_t offset = chunk.committed();
+    chunk.add_item(item);
+    chunk.commit();
+    m_entries.push_back(Entry{key, static_cast<uint32_t>(m_chunks.size() - 1), static_cast<uint32_t>(offset)});
+    ++m_count;
+}
+
+void SortedObjectStore::for_each_in_memory(const std::function<void(uint64_t, const osmium::memory::Item&)>& func) {
+    std::stable_sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) {
+        return a.key < b.key;
+    });
+    for (const Entry& entry : m_entries) {
+        func(entry.key, m_chunks[entry.chunk].get<osmium::memory::Item>(entry.offset));
+    }
+}
+
+void SortedObjectStore::spill() {
+    FILE* run = std::tmpfile();
+    if (!run) {
+        throw std::system_error{errno, std::system_category(), "Failed to create temporary file"};
+    }
+    m_runs.push_back(run);
+    for_each_in_memory([run](const uint64_t key, const osmium::memory::Item& item) {
+        const uint64_t header[2] = {key, item.padded_size()};
+        if (std::fwrite(header, sizeof(uint64_t), 2, run) != 2
+                || std::fwrite(&item, 1, item.padded_size(), run) != item.padded_size()) {
+            throw std::system_error{errno, std::system_category(), "Failed to write to temporary file"};
+        }
+    });
+    m_chunks.clear();
+    m_entries.clear();
+}
+
+void SortedObjectStore::for_each(const std::function<void(uint64_t, const osmium::memory::Item&)>& func) {
+    if (m_runs.empty()) {
+        for_each_in_memory(func);
+        return;
+    }
+    if (!m_entries.empty()) {
+        spill();
+    }
+    // Merge the runs. Runs written earlier win ties, so objects with the same key keep their order.
+    std::vector<RunReader> readers;
+    readers.reserve(m_runs.size());
+    using entry_type = std::pair<uint64_t, size_t>;
+    std::priority_queue<entry_type, std::vector<entry_type>, std::greater<entry_type>> queue;
+    for (size_t i = 0; i < m_runs.size(); ++i) {
+        readers.emplace_back(m_runs[i]);
+        if (readers.back().next()) {
+            queue.emplace(readers.back().key(), i);
+        }
+    }
+    while (!queue.empty()) {
+        const size_t run = queue.top().second;
+        queue.pop();
+        RunReader& reader = readers[run];
+        func(reader.key(), reader.item());
+        if (reader.next()) {
+            queue.emplace(reader.key(), run);
+        }
+    }
+}
+
+void SortedObjectStore::clear() {
+    for (FILE* run : m_runs) {
+        std::fclose(run);
+    }
+    m_runs.clear();
+    m_chunks.clear();
+    std::vector<Entry>{}.swap(m_entries);
+    m_count = 0;
+}
+
+size_t SortedObjectStore::used_memory() const noexcept {
+    size_t memory = m_entries.capacity() * sizeof(Entry);
+    for (const auto& chunk : m_chunks) {
+        memory += chunk.capacity();
+    }
+    return memory;
+}
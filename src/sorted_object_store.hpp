@@ -0,0 +1,115 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_SORTED_OBJECT_STORE_HPP_
+#define SRC_SORTED_OBJECT_STORE_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include <osmium/memory/buffer.hpp>
+#include <osmium/memory/item.hpp>
+
+/**
+ * Copies of OSM objects with a sort key which are handed back ordered by their key. Objects with
+ * the same key are handed back in the order they were added.
+ *
+ * The objects are kept in buffers of CHUNK_SIZE bytes together with an index of their keys (16
+ * bytes per object). If another buffer would exceed the memory budget, the index is sorted and the
+ * objects are written in this order as a sorted run to a temporary file. for_each() merges the
+ * runs.
+ */
+class SortedObjectStore {
+
+    /// maximum size of the buffers the objects are kept in
+    static constexpr size_t CHUNK_SIZE = 16 * 1024 * 1024;
+
+    struct Entry {
+        uint64_t key;
+        /// index of the buffer in m_chunks
+        uint32_t chunk;
+        /// offset of the object in the buffer
+        uint32_t offset;
+    };
+
+    /// memory budget in bytes, 0 = unlimited
+    size_t m_max_memory;
+
+    /// size of the buffers, a quarter of the memory budget at most
+    size_t m_chunk_size;
+
+    std::vector<osmium::memory::Buffer> m_chunks;
+
+    std::vector<Entry> m_entries;
+
+    /// sorted runs written to disk, each object as its key and size (uint64_t) followed by its content
+    std::vector<FILE*> m_runs;
+
+    size_t m_count = 0;
+
+    /**
+     * Sort the objects in memory by key and write them to a new temporary file.
+     */
+    void spill();
+
+    /**
+     * Hand all objects in memory to func (sorted by key).
+     */
+    void for_each_in_memory(const std::function<void(uint64_t, const osmium::memory::Item&)>& func);
+
+public:
+    /**
+     * \param max_memory memory budget in bytes, 0 = no limit
+     */
+    explicit SortedObjectStore(const size_t max_memory = 0);
+
+    SortedObjectStore(const SortedObjectStore&) = delete;
+    SortedObjectStore& operator=(const SortedObjectStore&) = delete;
+
+    ~SortedObjectStore();
+
+    void add(const uint64_t key, const osmium::memory::Item& item);
+
+    /**
+     * Call a function with the key and the object for all objects ordered by key.
+     */
+    void for_each(const std::function<void(uint64_t, const osmium::memory::Item&)>& func);
+
+    /**
+     * Remove all objects and free the memory.
+     */
+    void clear();
+
+    size_t size() const noexcept {
+        return m_count;
+    }
+
+    bool spilled() const noexcept {
+        return !m_runs.empty();
+    }
+
+    /**
+     * Memory in bytes used for objects kept in memory and their index
+     */
+    size_t used_memory() const noexcept;
+};
+
+#endif /* SRC_SORTED_OBJECT_STORE_HPP_ */
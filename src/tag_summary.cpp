@@ -0,0 +1,86 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tag_summary.hpp"
+
+#include <cstring>
+
+#include "utf8.hpp"
+
+TagSummary::TagSummary(const size_t max_length) :
+    m_max_length(max_length) {
+}
+
+void TagSummary::encode(const osmium::TagList& tags) {
+    m_tags = &tags;
+    m_result_valid = false;
+    m_encoded.clear();
+    m_segments.clear();
+    for (const osmium::Tag& t : tags) {
+        const size_t key_length = strlen(t.key());
+        const size_t value_length = strlen(t.value());
+        // only add tags to the tags string if their key and value are shorter than 50 characters
+        if (key_length + value_length + 2 >= 50) {
+            continue;
+        }
+        // tags which are not valid UTF-8 would corrupt the whole column
+        if (!utf8::is_valid(t.key(), key_length) || !utf8::is_valid(t.value(), value_length)) {
+            continue;
+        }
+        m_segments.push_back(Segment{t.key(), m_encoded.size(), key_length + value_length + 2});
+        m_encoded.append(t.key(), key_length);
+        m_encoded += '=';
+        m_encoded.append(t.value(), value_length);
+        m_encoded += '|';
+    }
+}
+
+const std::string& TagSummary::get(const osmium::TagList& tags, const char* not_include) {
+    if (m_tags != &tags) {
+        encode(tags);
+    }
+    if (m_result_valid && (not_include ? (m_result_has_exclusion && m_result_excluded == not_include)
+            : !m_result_has_exclusion)) {
+        return m_result;
+    }
+    m_result.clear();
+    if (!not_include && m_encoded.size() < m_max_length) {
+        // common case: all tags fit
+        m_result = m_encoded;
+    } else {
+        for (const Segment& segment : m_segments) {
+            if (not_include && !strcmp(segment.key, not_include)) {
+                continue;
+            }
+            if (m_result.size() + segment.length < m_max_length) {
+                m_result.append(m_encoded, segment.offset, segment.length);
+            }
+        }
+    }
+    // remove last | from the string
+    if (!m_result.empty()) {
+        m_result.pop_back();
+    }
+    m_result_has_exclusion = (not_include != nullptr);
+    if (not_include) {
+        m_result_excluded = not_include;
+    }
+    m_result_valid = true;
+    return m_result;
+}
@@ -0,0 +1,101 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_TAG_SUMMARY_HPP_
+#define SRC_TAG_SUMMARY_HPP_
+
+#include <string>
+#include <vector>
+
+#include <osmium/osm/tag.hpp>
+
+/**
+ * String of the tags of an OSM object written to the "tags" column of the output layers, e.g.
+ * "highway=primary|name=Main Street". Tags whose key and value are longer than 47 characters are
+ * omitted, so are tags which are not valid UTF-8. The string is shorter than the maximum field
+ * length; tags which do not fit are omitted.
+ *
+ * The tags of the current object are encoded once when the string is requested for the first
+ * time. Strings excluding one key are assembled from the encoded tags. The last string is cached,
+ * i.e. requesting the same string again (e.g. by another view) is free.
+ *
+ * The summary is shared by all views. It has to be reset before the next object is processed
+ * because a new object may be located at the address of an object processed earlier.
+ */
+class TagSummary {
+
+    struct Segment {
+        /// key of the tag (points into the tag list)
+        const char* key;
+        /// position of "key=value|" in m_encoded
+        size_t offset;
+        size_t length;
+    };
+
+    size_t m_max_length;
+
+    /// tag list of the current object, nullptr if nothing was encoded yet
+    const osmium::TagList* m_tags = nullptr;
+
+    /// "key=value|" of all tags which are short enough
+    std::string m_encoded;
+
+    std::vector<Segment> m_segments;
+
+    /// last string returned
+    std::string m_result;
+
+    /// key excluded from m_result (only valid if m_result_has_exclusion is true)
+    std::string m_result_excluded;
+
+    bool m_result_has_exclusion = false;
+
+    bool m_result_valid = false;
+
+    void encode(const osmium::TagList& tags);
+
+public:
+    /**
+     * \param max_length maximum length of the string (exclusive)
+     */
+    explicit TagSummary(const size_t max_length);
+
+    TagSummary(const TagSummary&) = delete;
+    TagSummary& operator=(const TagSummary&) = delete;
+
+    /**
+     * Forget the current object.
+     */
+    void reset() noexcept {
+        m_tags = nullptr;
+        m_result_valid = false;
+    }
+
+    /**
+     * Get the string of the tags.
+     *
+     * \param tags tag list of the object
+     * \param not_include key which should not be included in the string (nullptr to include all tags)
+     *
+     * \returns reference to the string, valid until the next call
+     */
+    const std::string& get(const osmium::TagList& tags, const char* not_include);
+};
+
+#endif /* SRC_TAG_SUMMARY_HPP_ */
@@ -18,9 +18,10 @@
  */
 
 #include "tagging_view_handler.hpp"
+#include "utf8.hpp"
 
-TaggingViewHandler::TaggingViewHandler(Options& options) :
-        AbstractViewHandler(options),
+TaggingViewHandler::TaggingViewHandler(Options& options, gdalcpp::Dataset* shared_dataset /*= nullptr*/) :
+        AbstractViewHandler(options, shared_dataset),
         m_tagging_fixmes_on_nodes(create_layer("tagging_fixmes_on_nodes", wkbPoint)),
         m_tagging_fixmes_on_ways(create_layer("tagging_fixmes_on_ways", wkbLineString)),
         m_tagging_nodes_with_empty_k(create_layer("tagging_nodes_with_empty_k", wkbPoint)),
@@ -34,7 +35,8 @@ TaggingViewHandler::TaggingViewHandler(Options& options) :
         m_tagging_no_feature_tag_nodes(create_layer("tagging_no_feature_tag_nodes", wkbPoint)),
         m_tagging_no_feature_tag_ways(create_layer("tagging_no_feature_tag_ways", wkbLineString)),
         m_tagging_long_text_nodes(create_layer("tagging_long_text_nodes", wkbPoint)),
-        m_tagging_long_text_ways(create_layer("tagging_long_text_ways", wkbLineString)) {
+        m_tagging_long_text_ways(create_layer("tagging_long_text_ways", wkbLineString)),
+        m_key_classes() {
     m_tagging_fixmes_on_nodes->add_field("node_id", OFTString, 10);
     m_tagging_fixmes_on_nodes->add_field("tag", OFTString, MAX_STRING_LENGTH);
     m_tagging_fixmes_on_nodes->add_field("lastchange", OFTString, 21);
@@ -125,9 +127,9 @@ void TaggingViewHandler::write_feature_to_simple_layer(gdalcpp::Layer* layer,
         gdalcpp::Feature feature(*layer, std::move(geometry));
         set_basic_fields(feature, object, field_name, value);
         if (other_field_name && other_value) {
-            feature.set_field(other_field_name, other_value);
+            set_text_field(feature, other_field_name, other_value);
         }
-        feature.add_to_layer();
+        write_feature(feature, *layer);
     } catch (osmium::geometry_error& err) {
         m_options.verbose_output << err.what() << "\n";
     }
@@ -144,25 +146,7 @@ void TaggingViewHandler::write_feature_to_simple_layer(gdalcpp::Layer* layer,
     }
     if (field_name && value) {
         // shorten value if too long
-        if (strlen(value) > MAX_STRING_LENGTH) {
-            char output_value[MAX_STRING_LENGTH + 5];
-            strncpy(output_value, value, MAX_STRING_LENGTH);
-            output_value[MAX_STRING_LENGTH] = '\0';
-	    // remove last byte(s) if they are multibyte characters but cut in-between
-            size_t i = MAX_STRING_LENGTH - 1;
-            if (output_value[i] & 128) {
-                if (output_value[i] & 64) {
-                    output_value[i] = '\0';
-                } else if ((output_value[i - 1] & 224) == 224) {
-                    output_value[i - 1] = '\0';
-                } else if ((output_value[i - 2] & 240) == 240) {
-                    output_value[i - 2] = '\0';
-                }
-            }
-            feature.set_field(field_name, output_value);
-        } else {
-            feature.set_field(field_name, value);
-        }
+        set_text_field(feature, field_name, value, MAX_STRING_LENGTH);
     }
     std::string timestamp = object.timestamp().to_iso();
     feature.set_field("lastchange", timestamp.c_str());
@@ -231,15 +215,20 @@ void TaggingViewHandler::empty_value(const osmium::OSMObject& object) {
     }
 }
 
+void TaggingViewHandler::scan_keys(const osmium::OSMObject& object) {
+    m_key_classes.clear();
+    for (const osmium::Tag& t : object.tags()) {
+        m_key_classes.push_back(key_scan::scan(t.key()));
+    }
+}
+
 void TaggingViewHandler::key_with_space(const osmium::OSMObject& object) {
+    auto key_class = m_key_classes.cbegin();
     for (const osmium::Tag& t : object.tags()) {
-        for (size_t i = 0; i < strlen(t.key()); ++i) {
-            if (isspace(t.key()[i])) {
-                char output_value[2 * 256 + 5];
-                sprintf(output_value, "'%s'='%s'", t.key(), t.value());
-                write_missspelled(object, output_value, "contains_whitespace", nullptr);
-                break;
-            }
+        if ((key_class++)->whitespace) {
+            char output_value[2 * 256 + 5];
+            sprintf(output_value, "'%s'='%s'", t.key(), t.value());
+            write_missspelled(object, output_value, "contains_whitespace", nullptr);
         }
     }
 }
@@ -262,7 +251,9 @@ void TaggingViewHandler::empty_key(const osmium::OSMObject& object) {
 }
 
 void TaggingViewHandler::unusual_character(const osmium::OSMObject& object) {
+    auto key_class = m_key_classes.cbegin();
     for (const osmium::Tag& t : object.tags()) {
+        const key_scan::KeyClass& current = *key_class++;
         if (is_a_x_key_key(t.key(), "name") || is_a_x_key_key(t.key(), "description")
                 || is_a_x_key_key(t.key(), "note") || is_a_x_key_key(t.key(), "comment")
                 || !strcmp(t.key(), "fixme") || !strcmp(t.key(), "FIXME")
@@ -271,26 +262,26 @@ void TaggingViewHandler::unusual_character(const osmium::OSMObject& object) {
                 || !strcmp(t.key(), "email")) {
             continue;
         }
-        for (size_t i = 0; i < strlen(t.key()); ++i) {
-            if (!is_good_character(t.key()[i])) {
-                if (object.type() == osmium::item_type::node) {
-                    write_missspelled(object, t.key(), "node_with_unusual_char", nullptr);
-                } else if (object.type() == osmium::item_type::way) {
-                    write_missspelled(object, t.key(), "way_with_unusual_char", nullptr);
-                }
-                return;
+        if (current.unusual) {
+            if (object.type() == osmium::item_type::node) {
+                write_missspelled(object, t.key(), "node_with_unusual_char", nullptr);
+            } else if (object.type() == osmium::item_type::way) {
+                write_missspelled(object, t.key(), "way_with_unusual_char", nullptr);
             }
+            return;
         }
     }
 }
 
 void TaggingViewHandler::check_key_length(const osmium::OSMObject& object) {
+    auto key_class = m_key_classes.cbegin();
     for (const osmium::Tag& t : object.tags()) {
-        if (strlen(t.key()) <= 2) {
+        const size_t length = (key_class++)->length;
+        if (length <= 2) {
             write_missspelled(object, t.key(), "short", nullptr);
             break;
         }
-        if (strlen(t.key()) > 50) {
+        if (length > 50) {
             write_missspelled(object, t.key(), "long", nullptr);
             break;
         }
@@ -319,9 +310,9 @@ void TaggingViewHandler::write_missspelled(const osmium::OSMObject& object,
         set_basic_fields(feature, object, "key", key);
         feature.set_field("error", error);
         if (otherkey) {
-            feature.set_field("otherkey", otherkey);
+            set_text_field(feature, "otherkey", otherkey);
         }
-        feature.add_to_layer();
+        write_feature(feature, *current_layer);
     } catch (osmium::geometry_error& err) {
         m_options.verbose_output << err.what() << "\n";
     }
@@ -341,19 +332,6 @@ void TaggingViewHandler::write_missspelled(const osmium::OSMObject& object,
     return false;
 }
 
-bool TaggingViewHandler::is_good_character(const char character) {
-    if (isalnum(character)) {
-        return true;
-    }
-    switch (character) {
-    case ':':
-    case '_':
-    case '-':
-        return true;
-    }
-    return false;
-}
-
 void TaggingViewHandler::hidden_nonop(const osmium::OSMObject& object) {
     gdalcpp::Layer* current_layer;
     if (object.type() == osmium::item_type::way) {
@@ -563,15 +541,7 @@ size_t TaggingViewHandler::char_length_utf8(const char* value) {
     if (!value) {
         return false;
     }
-    // We count char length with respect to UTF-8, so we need to count follow bytes (0b10xxxxxx).
-    int follow_bytes = 0;
-    size_t length = 0;
-    const char* ptr = value;
-    for (; *ptr != 0; ++ptr) {
-        ++length;
-        follow_bytes += static_cast<int>((((*ptr & 0xc0) ^ 0x70) == 0xf0));
-    }
-    return length - follow_bytes;
+    return utf8::count_code_points(value, strlen(value));
 }
 
 void TaggingViewHandler::long_text(const osmium::OSMObject& object) {
@@ -601,10 +571,22 @@ void TaggingViewHandler::long_text(const osmium::OSMObject& object) {
     }
 }
 
+void TaggingViewHandler::invalid_utf8(const osmium::OSMObject& object) {
+    for (const osmium::Tag& t : object.tags()) {
+        if (!utf8::is_valid(t.key()) || !utf8::is_valid(t.value())) {
+            // The key is written with the invalid bytes replaced.
+            write_missspelled(object, t.key(), "invalid_utf8", nullptr);
+            return;
+        }
+    }
+}
+
 void TaggingViewHandler::handle_object(const osmium::OSMObject& object) {
+    invalid_utf8(object);
     empty_value(object);
     check_fixme(object);
     empty_key(object);
+    scan_keys(object);
     unusual_character(object);
     check_key_length(object);
     hidden_nonop(object);
@@ -20,7 +20,10 @@
 #ifndef SRC_TAGGING_VIEW_HANDLER_HPP_
 #define SRC_TAGGING_VIEW_HANDLER_HPP_
 
+#include <vector>
+
 #include "abstract_view_handler.hpp"
+#include "key_scan.hpp"
 
 class TaggingViewHandler : public AbstractViewHandler {
 
@@ -41,6 +44,9 @@ class TaggingViewHandler : public AbstractViewHandler {
     std::unique_ptr<gdalcpp::Layer> m_tagging_long_text_nodes;
     std::unique_ptr<gdalcpp::Layer> m_tagging_long_text_ways;
 
+    /// classes of the keys of the current object, in the order of its tags (see scan_keys())
+    std::vector<key_scan::KeyClass> m_key_classes;
+
     /**
      * Write a feature to on of the layers which only have the fields
      * way_id/node_id, tag and lastchange.
@@ -73,11 +79,24 @@ class TaggingViewHandler : public AbstractViewHandler {
      */
     void check_fixme(const osmium::OSMObject& object);
 
+    /**
+     * Scan all keys of an object once and store their classes in m_key_classes. The key checks
+     * below use them instead of scanning the keys again.
+     */
+    void scan_keys(const osmium::OSMObject& object);
+
     /**
      * Check if an object has a key which contains whitespace.
+     *
+     * scan_keys() has to be called for the object before.
      */
     void key_with_space(const osmium::OSMObject& object);
 
+    /**
+     * Check if a key or value of an object is not valid UTF-8.
+     */
+    void invalid_utf8(const osmium::OSMObject& object);
+
     /**
      * Check if an object has an empty key
      */
@@ -90,19 +109,18 @@ class TaggingViewHandler : public AbstractViewHandler {
 
     /**
      * Check if an object has a tag with an unusual character
+     *
+     * scan_keys() has to be called for the object before.
      */
     void unusual_character(const osmium::OSMObject& object);
 
     /**
      * Check if the length of a key is larger than 2 and smaller or equal than 50.
+     *
+     * scan_keys() has to be called for the object before.
      */
     void check_key_length(const osmium::OSMObject& object);
 
-    /**
-     * Check if a character is an accepted character for keys and non-name values.
-     */
-    bool is_good_character(const char character);
-
     /**
      * Search for objects with a core tag but a disused/abandoned/razed/dismanted/construction/proposed=yes.
      */
@@ -159,7 +177,7 @@ class TaggingViewHandler : public AbstractViewHandler {
 public:
     TaggingViewHandler() = delete;
 
-    explicit TaggingViewHandler(Options& options);
+    explicit TaggingViewHandler(Options& options, gdalcpp::Dataset* shared_dataset = nullptr);
 
     void give_correct_name();
 
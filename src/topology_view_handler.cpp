@@ -0,0 +1,168 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "topology_view_handler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+TopologyViewHandler::TopologyViewHandler(Options& options, gdalcpp::Dataset* shared_dataset /*= nullptr*/) :
+        AbstractViewHandler(options, shared_dataset),
+        m_topology_crossing_highways_points(create_layer("topology_crossing_highways_points", wkbPoint, get_gdal_default_layer_options())),
+        m_topology_crossing_highways_ways(create_layer("topology_crossing_highways_ways", wkbLineString, get_gdal_default_layer_options())),
+        m_crossing_index(),
+        m_highway_values{"(other)"},
+        m_highway_value_index() {
+    // crossing points
+    m_topology_crossing_highways_points->add_field("way1_id", OFTString, 10);
+    m_topology_crossing_highways_points->add_field("way2_id", OFTString, 10);
+    m_topology_crossing_highways_points->add_field("highway1", OFTString, 40);
+    m_topology_crossing_highways_points->add_field("highway2", OFTString, 40);
+    // highways crossing other highways
+    m_topology_crossing_highways_ways->add_field("way_id", OFTString, 10);
+    m_topology_crossing_highways_ways->add_field("highway", OFTString, 40);
+    m_topology_crossing_highways_ways->add_field("crossings", OFTInteger, 10);
+}
+
+void TopologyViewHandler::give_correct_name() {
+    rename_output_files("topology");
+}
+
+bool TopologyViewHandler::is_crossing_candidate(const osmium::TagList& tags) {
+    const char* highway = tags.get_value_by_key("highway");
+    if (!highway) {
+        return false;
+    }
+    // highways which do not exist (yet or any more) and features which are no roads
+    static const char* const ignored_highways[] = {"proposed", "construction", "abandoned", "razed",
+        "platform", "elevator", "corridor", "bus_stop", "rest_area", "services"};
+    for (const char* ignored : ignored_highways) {
+        if (!strcmp(highway, ignored)) {
+            return false;
+        }
+    }
+    const char* area = tags.get_value_by_key("area");
+    if (area && !strcmp(area, "yes")) {
+        return false;
+    }
+    // bridges and tunnels cross other highways on purpose
+    for (const char* key : {"bridge", "tunnel"}) {
+        const char* value = tags.get_value_by_key(key);
+        if (value && strcmp(value, "no") != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int8_t TopologyViewHandler::layer(const osmium::TagList& tags) {
+    const char* value = tags.get_value_by_key("layer");
+    if (!value) {
+        return 0;
+    }
+    char* rest;
+    const long number = strtol(value, &rest, 10);
+    if (*rest || number < -5 || number > 5) {
+        return 0;
+    }
+    return static_cast<int8_t>(number);
+}
+
+uint16_t TopologyViewHandler::highway_value_index(const char* value) {
+    auto it = m_highway_value_index.find(value);
+    if (it != m_highway_value_index.end()) {
+        return it->second;
+    }
+    if (m_highway_values.size() > std::numeric_limits<uint16_t>::max()) {
+        // too many different values
+        return 0;
+    }
+    const uint16_t index = static_cast<uint16_t>(m_highway_values.size());
+    m_highway_values.emplace_back(value);
+    m_highway_value_index.emplace(m_highway_values.back().c_str(), index);
+    return index;
+}
+
+void TopologyViewHandler::way(const osmium::Way& way) {
+    if (way.nodes().size() < 2 || !is_crossing_candidate(way.tags()) || !all_nodes_valid(way.nodes())) {
+        return;
+    }
+    m_crossing_index.add_way(way.id(), way.nodes(), layer(way.tags()),
+            highway_value_index(way.tags().get_value_by_key("highway")));
+}
+
+std::unique_ptr<OGRGeometry> TopologyViewHandler::build_linestring(const size_t way) {
+    std::vector<osmium::NodeRef> nodes;
+    for (const osmium::Location* it = m_crossing_index.begin(way); it != m_crossing_index.end(way); ++it) {
+        nodes.emplace_back(0, *it);
+    }
+    m_factory.linestring_start();
+    const size_t linestring_length = m_factory.fill_linestring(nodes.begin(), nodes.end());
+    return m_factory.linestring_finish(linestring_length);
+}
+
+void TopologyViewHandler::write_crossings() {
+    const unsigned int threads = std::max(std::thread::hardware_concurrency(), 1u);
+    m_options.verbose_output << "Searching crossings of " << m_crossing_index.size() << " highways ("
+            << threads << " threads) ...\n";
+    const std::vector<CrossingIndex::Crossing> crossings = m_crossing_index.find_crossings(threads, m_options.max_memory);
+    m_options.verbose_output << "Found " << crossings.size() << " crossings of highways\n";
+
+    std::vector<size_t> crossing_count(m_crossing_index.size(), 0);
+    char idbuffer[20];
+    for (const CrossingIndex::Crossing& crossing : crossings) {
+        ++crossing_count[crossing.way1];
+        ++crossing_count[crossing.way2];
+        gdalcpp::Feature feature(*m_topology_crossing_highways_points, m_factory.create_point(crossing.location));
+        sprintf(idbuffer, "%ld", m_crossing_index.id(crossing.way1));
+        feature.set_field("way1_id", idbuffer);
+        sprintf(idbuffer, "%ld", m_crossing_index.id(crossing.way2));
+        feature.set_field("way2_id", idbuffer);
+        set_text_field(feature, "highway1", m_highway_values[m_crossing_index.cls(crossing.way1)].c_str(), 40);
+        set_text_field(feature, "highway2", m_highway_values[m_crossing_index.cls(crossing.way2)].c_str(), 40);
+        write_feature(feature, *m_topology_crossing_highways_points);
+    }
+    for (size_t way = 0; way < crossing_count.size(); ++way) {
+        if (crossing_count[way] == 0) {
+            continue;
+        }
+        gdalcpp::Feature feature(*m_topology_crossing_highways_ways, build_linestring(way));
+        sprintf(idbuffer, "%ld", m_crossing_index.id(way));
+        feature.set_field("way_id", idbuffer);
+        set_text_field(feature, "highway", m_highway_values[m_crossing_index.cls(way)].c_str(), 40);
+        feature.set_field("crossings", static_cast<int>(crossing_count[way]));
+        write_feature(feature, *m_topology_crossing_highways_ways);
+    }
+    m_crossing_index.clear();
+}
+
+void TopologyViewHandler::close() {
+    write_crossings();
+    m_topology_crossing_highways_points.reset();
+    m_topology_crossing_highways_ways.reset();
+    close_datasets();
+}
+
+size_t TopologyViewHandler::crossing_index_memory() const noexcept {
+    return m_crossing_index.used_memory();
+}
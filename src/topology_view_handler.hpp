@@ -0,0 +1,98 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_TOPOLOGY_VIEW_HANDLER_HPP_
+#define SRC_TOPOLOGY_VIEW_HANDLER_HPP_
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "abstract_view_handler.hpp"
+#include "check_rules.hpp"
+#include "crossing_index.hpp"
+
+/**
+ * View of problems between ways: highways crossing each other without a shared node.
+ *
+ * The highways are collected during the main pass. Crossings can only be searched when all of
+ * them are known, i.e. this happens in close() before the layers are closed.
+ *
+ * If the planet is processed in shards, crossings with ways of other shards are not detected.
+ */
+class TopologyViewHandler : public AbstractViewHandler {
+    /// layer for the locations of crossings
+    std::unique_ptr<gdalcpp::Layer> m_topology_crossing_highways_points;
+    /// layer for highways crossing other highways
+    std::unique_ptr<gdalcpp::Layer> m_topology_crossing_highways_ways;
+
+    /// geometries of all highways which can cross others
+    CrossingIndex m_crossing_index;
+
+    /**
+     * highway=* values of the collected ways, indexed by CrossingIndex::cls(). The first entry is
+     * used for all values if there are too many different ones. Its elements are never moved.
+     */
+    std::deque<std::string> m_highway_values;
+
+    /// index of each highway=* value in m_highway_values, can be queried without a temporary std::string
+    std::unordered_map<const char*, uint16_t, CStringHash, CStringEqual> m_highway_value_index;
+
+    /**
+     * Check if a way is a highway which must not cross other highways without a shared node.
+     */
+    static bool is_crossing_candidate(const osmium::TagList& tags);
+
+    /**
+     * Value of the layer tag limited to -5..5, 0 if it is missing or invalid.
+     */
+    static int8_t layer(const osmium::TagList& tags);
+
+    uint16_t highway_value_index(const char* value);
+
+    std::unique_ptr<OGRGeometry> build_linestring(const size_t way);
+
+    /**
+     * Search the crossings and write them to the output layers.
+     */
+    void write_crossings();
+
+public:
+    TopologyViewHandler() = delete;
+
+    TopologyViewHandler(Options& options, gdalcpp::Dataset* shared_dataset = nullptr);
+
+    void give_correct_name();
+
+    void way(const osmium::Way& way);
+
+    void node(const osmium::Node&) {};
+    void relation(const osmium::Relation&) {};
+    void area(const osmium::Area&) {};
+
+    void close();
+
+    /**
+     * Memory in bytes used by the ways collected for the search for crossings
+     */
+    size_t crossing_index_memory() const noexcept;
+};
+
+#endif /* SRC_TOPOLOGY_VIEW_HANDLER_HPP_ */
@@ -0,0 +1,118 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tracer.hpp"
+
+#include <cstdio>
+#include <iostream>
+
+namespace {
+
+    /**
+     * Write a string as JSON string literal.
+     */
+    void write_json_string(FILE* file, const std::string& str) {
+        fputc('"', file);
+        for (const char c : str) {
+            if (c == '"' || c == '\\') {
+                fputc('\\', file);
+                fputc(c, file);
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                fprintf(file, "\\u%04x", static_cast<unsigned int>(c));
+            } else {
+                fputc(c, file);
+            }
+        }
+        fputc('"', file);
+    }
+
+} // namespace
+
+constexpr size_t Tracer::MAX_BUFFERED_EVENTS;
+
+Tracer::~Tracer() {
+    close();
+}
+
+bool Tracer::open(const std::string& filename) {
+    m_file = fopen(filename.c_str(), "w");
+    if (!m_file) {
+        return false;
+    }
+    fputs("{\"traceEvents\":[\n", m_file);
+    m_events.reserve(MAX_BUFFERED_EVENTS);
+    m_start = clock_type::now();
+    // The thread enabling tracing is the main thread.
+    m_threads.emplace(std::this_thread::get_id(), 1);
+    m_enabled = true;
+    return true;
+}
+
+int Tracer::thread_number() {
+    auto it = m_threads.find(std::this_thread::get_id());
+    if (it != m_threads.end()) {
+        return it->second;
+    }
+    const int number = static_cast<int>(m_threads.size()) + 1;
+    m_threads.emplace(std::this_thread::get_id(), number);
+    return number;
+}
+
+void Tracer::write_events() {
+    for (const auto& event : m_events) {
+        fputs(m_first_event ? "{\"name\":" : ",\n{\"name\":", m_file);
+        m_first_event = false;
+        write_json_string(m_file, event.name);
+        fprintf(m_file, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%d}", event.category,
+                static_cast<long long>(event.start), static_cast<long long>(event.duration), event.thread);
+    }
+    m_events.clear();
+}
+
+void Tracer::add_event(const std::string& name, const char* category, const int64_t start) {
+    add_event(name, category, start, now() - start);
+}
+
+void Tracer::add_event(const std::string& name, const char* category, const int64_t start, const int64_t duration) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_events.push_back(Event{name, category, start, duration, thread_number()});
+    if (m_events.size() >= MAX_BUFFERED_EVENTS) {
+        write_events();
+    }
+}
+
+void Tracer::close() {
+    if (!m_enabled) {
+        return;
+    }
+    m_enabled = false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    write_events();
+    // The names of the threads are known at the end only. The order of the events does not matter.
+    for (const auto& thread : m_threads) {
+        fprintf(m_file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+                m_first_event ? "" : ",\n", thread.second, thread.second == 1 ? "main" : "worker", thread.second);
+        m_first_event = false;
+    }
+    fputs("\n],\"displayTimeUnit\":\"ms\"}\n", m_file);
+    if (fclose(m_file) != 0) {
+        std::cerr << "ERROR: Failed to write trace file\n";
+    }
+    m_file = nullptr;
+}
@@ -0,0 +1,214 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_TRACER_HPP_
+#define SRC_TRACER_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Record timed events of the pipeline stages and write them as a trace file in the Chrome trace
+ * event format (JSON). The file can be opened with chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Tracing is disabled unless open() was called. Recording an event is thread-safe. Events are
+ * collected in a buffer of limited size which is written to the file whenever it is full.
+ */
+class Tracer {
+
+public:
+    using clock_type = std::chrono::steady_clock;
+
+private:
+    /// number of events buffered before they are written to the file
+    static constexpr size_t MAX_BUFFERED_EVENTS = 4096;
+
+    struct Event {
+        std::string name;
+        const char* category;
+        int64_t start;
+        int64_t duration;
+        int thread;
+    };
+
+    bool m_enabled = false;
+
+    FILE* m_file = nullptr;
+
+    /// no event has been written to the file yet
+    bool m_first_event = true;
+
+    clock_type::time_point m_start;
+
+    std::mutex m_mutex;
+
+    std::vector<Event> m_events;
+
+    /// small numbers of the threads which recorded events
+    std::map<std::thread::id, int> m_threads;
+
+    int thread_number();
+
+    /**
+     * Write all buffered events to the file and clear the buffer. The mutex has to be locked.
+     */
+    void write_events();
+
+public:
+    Tracer() = default;
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    ~Tracer();
+
+    /**
+     * Open the trace file and enable tracing.
+     *
+     * \returns false if the file cannot be opened (tracing stays disabled)
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * Write the remaining events, complete and close the trace file.
+     */
+    void close();
+
+    bool enabled() const noexcept {
+        return m_enabled;
+    }
+
+    /**
+     * Current time in microseconds since tracing was enabled
+     */
+    int64_t now() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - m_start).count();
+    }
+
+    /**
+     * Record an event of the current thread.
+     *
+     * \param name name of the event
+     * \param category category of the event
+     * \param start start time (as returned by now())
+     */
+    void add_event(const std::string& name, const char* category, const int64_t start);
+
+    /**
+     * Record an event of the current thread with a given duration.
+     *
+     * \param name name of the event
+     * \param category category of the event
+     * \param start start time (as returned by now())
+     * \param duration duration in microseconds
+     */
+    void add_event(const std::string& name, const char* category, const int64_t start, const int64_t duration);
+};
+
+/**
+ * Record an event for the lifetime of this object.
+ */
+class TraceScope {
+
+    Tracer& m_tracer;
+    const char* m_name;
+    std::string m_name_string;
+    const char* m_category;
+    int64_t m_start = 0;
+
+public:
+    /**
+     * \param tracer tracer to record the event to
+     * \param name name of the event (has to live until this object is destroyed)
+     * \param category category of the event
+     */
+    TraceScope(Tracer& tracer, const char* name, const char* category) :
+        m_tracer(tracer),
+        m_name(name),
+        m_category(category) {
+        if (m_tracer.enabled()) {
+            m_start = m_tracer.now();
+        }
+    }
+
+    TraceScope(Tracer& tracer, const std::string& name, const char* category) :
+        m_tracer(tracer),
+        m_name(nullptr),
+        m_category(category) {
+        if (m_tracer.enabled()) {
+            m_name_string = name;
+            m_start = m_tracer.now();
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    /**
+     * Start time of the event (0 if tracing is disabled)
+     */
+    int64_t start() const noexcept {
+        return m_start;
+    }
+
+    ~TraceScope() {
+        if (m_tracer.enabled()) {
+            m_tracer.add_event(m_name ? std::string{m_name} : m_name_string, m_category, m_start);
+        }
+    }
+};
+
+/**
+ * Add the time between construction and destruction of this object to a total. This is used for
+ * calls which are too short and too many to be recorded as events of their own.
+ */
+class TraceTimer {
+
+    Tracer::clock_type::duration* m_total = nullptr;
+    Tracer::clock_type::time_point m_start;
+
+public:
+    /**
+     * \param tracer nothing is measured unless tracing is enabled
+     * \param total duration to add the time to
+     */
+    TraceTimer(const Tracer& tracer, Tracer::clock_type::duration& total) {
+        if (tracer.enabled()) {
+            m_total = &total;
+            m_start = Tracer::clock_type::now();
+        }
+    }
+
+    TraceTimer(const TraceTimer&) = delete;
+    TraceTimer& operator=(const TraceTimer&) = delete;
+
+    ~TraceTimer() {
+        if (m_total) {
+            *m_total += Tracer::clock_type::now() - m_start;
+        }
+    }
+};
+
+#endif /* SRC_TRACER_HPP_ */
@@ -0,0 +1,183 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "turn_lanes.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+    const char* const DIRECTIONS[] = {
+        "left",
+        "through",
+        "right",
+        "slight_left",
+        "slight_right",
+        "sharp_left",
+        "sharp_right",
+        "reverse",
+        "merge_to_left",
+        "merge_to_right",
+        "none"
+    };
+
+    /// state of the automaton if a lane starts (beginning of the value or after '|')
+    constexpr uint8_t LANE_START = 0;
+    /// state of the automaton after ';'
+    constexpr uint8_t DIRECTION_START = 1;
+    constexpr uint8_t REJECT = 255;
+
+    /// character classes: 0 = any other byte, 1 = '|', 2 = ';', 3... = letters of the directions
+    constexpr uint8_t CLASS_OTHER = 0;
+    constexpr uint8_t CLASS_PIPE = 1;
+    constexpr uint8_t CLASS_SEMICOLON = 2;
+
+    struct Automaton {
+        uint8_t char_class[256];
+        size_t class_count = 3;
+
+        /// transitions, class_count entries per state
+        std::vector<uint8_t> transitions;
+
+        /// true if a complete direction was read in this state
+        std::vector<bool> accepting;
+
+        uint8_t add_state() {
+            transitions.resize(transitions.size() + class_count, REJECT);
+            accepting.push_back(false);
+            return static_cast<uint8_t>(accepting.size() - 1);
+        }
+
+        uint8_t& next(const uint8_t state, const uint8_t cls) {
+            return transitions[state * class_count + cls];
+        }
+
+        Automaton() {
+            std::memset(char_class, CLASS_OTHER, sizeof(char_class));
+            char_class[static_cast<unsigned char>('|')] = CLASS_PIPE;
+            char_class[static_cast<unsigned char>(';')] = CLASS_SEMICOLON;
+            for (const char* direction : DIRECTIONS) {
+                for (const char* c = direction; *c; ++c) {
+                    uint8_t& cls = char_class[static_cast<unsigned char>(*c)];
+                    if (cls == CLASS_OTHER) {
+                        cls = static_cast<uint8_t>(class_count++);
+                    }
+                }
+            }
+            add_state(); // LANE_START
+            add_state(); // DIRECTION_START
+            // The trie of the directions is built from LANE_START. DIRECTION_START gets the same
+            // transitions for letters afterwards.
+            for (const char* direction : DIRECTIONS) {
+                uint8_t state = LANE_START;
+                for (const char* c = direction; *c; ++c) {
+                    const uint8_t cls = char_class[static_cast<unsigned char>(*c)];
+                    if (next(state, cls) == REJECT) {
+                        const uint8_t new_state = add_state();
+                        next(state, cls) = new_state;
+                    }
+                    state = next(state, cls);
+                }
+                accepting[state] = true;
+            }
+            for (uint8_t cls = CLASS_SEMICOLON + 1; cls < class_count; ++cls) {
+                next(DIRECTION_START, cls) = next(LANE_START, cls);
+            }
+            for (uint8_t state = 0; state < accepting.size(); ++state) {
+                if (accepting[state]) {
+                    next(state, CLASS_PIPE) = LANE_START;
+                    next(state, CLASS_SEMICOLON) = DIRECTION_START;
+                }
+            }
+            // empty lane
+            next(LANE_START, CLASS_PIPE) = LANE_START;
+        }
+
+        /**
+         * Check if the value may end in this state.
+         */
+        bool final_state(const uint8_t state) const {
+            return state == LANE_START || state == DIRECTION_START || accepting[state];
+        }
+    };
+
+    const Automaton& automaton() {
+        static const Automaton instance;
+        return instance;
+    }
+
+    /**
+     * Length of the direction starting at token.
+     */
+    size_t token_length(const char* token) noexcept {
+        return std::strcspn(token, "|;");
+    }
+
+} // anonymous namespace
+
+turn_lanes::TurnLanes turn_lanes::lex(const char* value) noexcept {
+    TurnLanes result;
+    if (!value) {
+        return result;
+    }
+    result.count = 1;
+    const Automaton& dfa = automaton();
+    const uint8_t* transitions = dfa.transitions.data();
+    const size_t class_count = dfa.class_count;
+    uint8_t state = LANE_START;
+    const char* token = value;
+    const char* c = value;
+    for (; *c; ++c) {
+        const uint8_t cls = dfa.char_class[static_cast<unsigned char>(*c)];
+        state = transitions[state * class_count + cls];
+        if (cls == CLASS_PIPE) {
+            ++result.count;
+        }
+        if (state == REJECT) {
+            result.valid = false;
+            result.invalid_token = token;
+            result.invalid_length = token_length(token);
+            break;
+        }
+        if (cls == CLASS_PIPE || cls == CLASS_SEMICOLON) {
+            token = c + 1;
+        }
+    }
+    if (result.valid) {
+        if (!dfa.final_state(state)) {
+            result.valid = false;
+            result.invalid_token = token;
+            result.invalid_length = token_length(token);
+        } else if (c - value < 4) {
+            result.valid = false;
+            result.invalid_token = value;
+            result.invalid_length = token_length(value);
+        }
+        return result;
+    }
+    // count the remaining lanes
+    for (++c; *c; ++c) {
+        if (*c == '|') {
+            ++result.count;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,61 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_TURN_LANES_HPP_
+#define SRC_TURN_LANES_HPP_
+
+#include <cstddef>
+
+/**
+ * Lexer for the values of turn:lanes, turn:lanes:forward and turn:lanes:backward.
+ *
+ * Lanes are separated by '|', the directions of a lane by ';'. Valid directions are left, through,
+ * right, slight_left, slight_right, sharp_left, sharp_right, reverse, merge_to_left,
+ * merge_to_right and none. An empty lane (shortcut for none) is valid but an empty direction
+ * between or before semicolons is not. An empty direction at the end of the value is accepted.
+ * Values shorter than four bytes are invalid.
+ *
+ * The value is read once by a deterministic automaton whose transition table is built when the
+ * lexer is used for the first time.
+ */
+namespace turn_lanes {
+
+    struct TurnLanes {
+        /// number of lanes, i.e. number of '|' plus one, 0 if the tag is missing
+        int count = 0;
+
+        bool valid = true;
+
+        /// first invalid direction (nullptr if the value is valid)
+        const char* invalid_token = nullptr;
+
+        /// length of the first invalid direction in bytes
+        size_t invalid_length = 0;
+    };
+
+    /**
+     * Validate a turn:lanes value and count its lanes.
+     *
+     * \param value value of the tag, nullptr if the tag is missing (which is valid)
+     */
+    TurnLanes lex(const char* value) noexcept;
+
+} // namespace turn_lanes
+
+#endif /* SRC_TURN_LANES_HPP_ */
@@ -0,0 +1,194 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utf8.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+# include <immintrin.h>
+#elif defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
+namespace {
+
+    inline bool is_continuation(const unsigned char c) noexcept {
+        return (c & 0xc0) == 0x80;
+    }
+
+    /**
+     * Number of leading bytes which are ASCII.
+     */
+    size_t ascii_prefix(const char* str, const size_t length) noexcept {
+        size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 32 <= length; i += 32) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i));
+            const uint32_t high_bits = static_cast<uint32_t>(_mm256_movemask_epi8(v));
+            if (high_bits) {
+                return i + static_cast<size_t>(__builtin_ctz(high_bits));
+            }
+        }
+#endif
+#if defined(__SSE2__)
+        for (; i + 16 <= length; i += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+            const uint32_t high_bits = static_cast<uint32_t>(_mm_movemask_epi8(v));
+            if (high_bits) {
+                return i + static_cast<size_t>(__builtin_ctz(high_bits));
+            }
+        }
+#endif
+        for (; i < length; ++i) {
+            if (static_cast<unsigned char>(str[i]) & 0x80) {
+                return i;
+            }
+        }
+        return length;
+    }
+
+} // anonymous namespace
+
+size_t utf8::sequence_length(const char* str, const size_t remaining) noexcept {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(str);
+    if (remaining == 0) {
+        return 0;
+    }
+    if (s[0] < 0x80) {
+        return 1;
+    }
+    // valid range of the second byte depends on the first one (excludes overlong encodings,
+    // surrogates and code points above U+10FFFF)
+    size_t length;
+    unsigned char low = 0x80;
+    unsigned char high = 0xbf;
+    if (s[0] >= 0xc2 && s[0] <= 0xdf) {
+        length = 2;
+    } else if (s[0] >= 0xe0 && s[0] <= 0xef) {
+        length = 3;
+        if (s[0] == 0xe0) {
+            low = 0xa0;
+        } else if (s[0] == 0xed) {
+            high = 0x9f;
+        }
+    } else if (s[0] >= 0xf0 && s[0] <= 0xf4) {
+        length = 4;
+        if (s[0] == 0xf0) {
+            low = 0x90;
+        } else if (s[0] == 0xf4) {
+            high = 0x8f;
+        }
+    } else {
+        return 0;
+    }
+    if (remaining < length || s[1] < low || s[1] > high) {
+        return 0;
+    }
+    for (size_t i = 2; i < length; ++i) {
+        if (!is_continuation(s[i])) {
+            return 0;
+        }
+    }
+    return length;
+}
+
+size_t utf8::count_code_points(const char* str, const size_t length) noexcept {
+    size_t continuation_bytes = 0;
+    size_t i = 0;
+    // Continuation bytes 0x80 to 0xbf are the signed bytes -128 to -65.
+#if defined(__AVX2__)
+    const __m256i limit32 = _mm256_set1_epi8(-64);
+    for (; i + 32 <= length; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i));
+        continuation_bytes += __builtin_popcount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(limit32, v))));
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i limit16 = _mm_set1_epi8(-64);
+    for (; i + 16 <= length; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+        continuation_bytes += __builtin_popcount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmplt_epi8(v, limit16))));
+    }
+#endif
+    for (; i < length; ++i) {
+        continuation_bytes += is_continuation(static_cast<unsigned char>(str[i]));
+    }
+    return length - continuation_bytes;
+}
+
+bool utf8::is_valid(const char* str, const size_t length) noexcept {
+    size_t i = 0;
+    while (true) {
+        i += ascii_prefix(str + i, length - i);
+        if (i == length) {
+            return true;
+        }
+        const size_t sequence = sequence_length(str + i, length - i);
+        if (sequence == 0) {
+            return false;
+        }
+        i += sequence;
+    }
+}
+
+bool utf8::is_valid(const char* str) noexcept {
+    return is_valid(str, std::strlen(str));
+}
+
+size_t utf8::safe_cut(const char* str, const size_t length, const size_t limit) noexcept {
+    if (length <= limit) {
+        return length;
+    }
+    // str[limit] is the first byte which is cut off. If it is a continuation byte, the
+    // character it belongs to has to be removed completely.
+    size_t cut = limit;
+    while (cut > 0 && limit - cut < 3 && is_continuation(static_cast<unsigned char>(str[cut]))) {
+        --cut;
+    }
+    return cut;
+}
+
+std::string utf8::sanitize(const char* str, const size_t length, const size_t max_length) {
+    std::string result;
+    result.reserve(length < max_length ? length : max_length);
+    size_t i = 0;
+    while (i < length) {
+        const size_t ascii = ascii_prefix(str + i, length - i);
+        result.append(str + i, ascii);
+        i += ascii;
+        if (i == length) {
+            break;
+        }
+        const size_t sequence = sequence_length(str + i, length - i);
+        if (sequence == 0) {
+            result += '?';
+            ++i;
+        } else {
+            result.append(str + i, sequence);
+            i += sequence;
+        }
+        if (result.size() > max_length) {
+            break;
+        }
+    }
+    result.resize(safe_cut(result.data(), result.size(), max_length));
+    return result;
+}
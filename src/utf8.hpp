@@ -0,0 +1,76 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_UTF8_HPP_
+#define SRC_UTF8_HPP_
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Counting, validation and truncation of UTF-8 strings.
+ *
+ * Blocks of pure ASCII are processed 32 (AVX2) or 16 (SSE2) bytes at a time if the compiler
+ * targets these instruction sets. Only multi-byte sequences are decoded byte by byte.
+ *
+ * Valid UTF-8 is defined as in RFC 3629: no overlong encodings, no surrogates and no code
+ * points above U+10FFFF.
+ */
+namespace utf8 {
+
+    /**
+     * Length of the valid UTF-8 sequence starting at str.
+     *
+     * \param str start of the sequence
+     * \param remaining number of bytes available from str on
+     *
+     * \returns length of the sequence in bytes, 0 if it is invalid or truncated
+     */
+    size_t sequence_length(const char* str, const size_t remaining) noexcept;
+
+    /**
+     * Number of code points of a string. Every byte which is not a continuation byte
+     * (0b10xxxxxx) starts a code point.
+     */
+    size_t count_code_points(const char* str, const size_t length) noexcept;
+
+    bool is_valid(const char* str, const size_t length) noexcept;
+
+    /**
+     * Check if a null-terminated string is valid UTF-8.
+     */
+    bool is_valid(const char* str) noexcept;
+
+    /**
+     * Find the longest prefix of a string which is at most limit bytes long and does not end in
+     * the middle of a multi-byte character.
+     *
+     * \returns length of the prefix
+     */
+    size_t safe_cut(const char* str, const size_t length, const size_t limit) noexcept;
+
+    /**
+     * Copy a string, replace each byte which is not part of a valid UTF-8 sequence by '?' and
+     * cut it to at most max_length bytes without splitting a character.
+     */
+    std::string sanitize(const char* str, const size_t length, const size_t max_length);
+
+} // namespace utf8
+
+#endif /* SRC_UTF8_HPP_ */
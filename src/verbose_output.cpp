@@ -0,0 +1,56 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "verbose_output.hpp"
+
+VerboseOutput::VerboseOutput(const bool verbose) :
+    m_output(verbose),
+    m_verbose(verbose),
+    m_mutex(),
+    m_lines() {
+}
+
+VerboseOutput::~VerboseOutput() {
+    for (const auto& line : m_lines) {
+        m_output << line.second + '\n';
+    }
+}
+
+void VerboseOutput::verbose(const bool verbose) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_output.verbose(verbose);
+    m_verbose = verbose;
+}
+
+void VerboseOutput::write(const std::string& text) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const std::thread::id thread = std::this_thread::get_id();
+    std::string& line = m_lines[thread];
+    line += text;
+    const size_t end = line.rfind('\n');
+    if (end == std::string::npos) {
+        return;
+    }
+    m_output << line.substr(0, end + 1);
+    if (end + 1 == line.size()) {
+        m_lines.erase(thread);
+    } else {
+        line.erase(0, end + 1);
+    }
+}
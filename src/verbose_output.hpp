@@ -0,0 +1,79 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_VERBOSE_OUTPUT_HPP_
+#define SRC_VERBOSE_OUTPUT_HPP_
+
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <osmium/util/verbose_output.hpp>
+
+/**
+ * Verbose output which may be written by several threads at the same time, e.g. by the handlers
+ * closed in parallel.
+ *
+ * The output of every thread is collected until the end of a line. Complete lines are written
+ * with osmium::util::VerboseOutput (i.e. prefixed by the elapsed time) while a mutex is locked,
+ * so lines of different threads are not interleaved.
+ */
+class VerboseOutput {
+    osmium::util::VerboseOutput m_output;
+
+    bool m_verbose;
+
+    std::mutex m_mutex;
+
+    /// incomplete lines of the threads
+    std::unordered_map<std::thread::id, std::string> m_lines;
+
+    /**
+     * Append text to the line of the current thread and write the line if it is complete.
+     */
+    void write(const std::string& text);
+
+public:
+    explicit VerboseOutput(const bool verbose);
+
+    /**
+     * Write the incomplete lines which are left.
+     */
+    ~VerboseOutput();
+
+    bool verbose() const noexcept {
+        return m_verbose;
+    }
+
+    void verbose(const bool verbose);
+
+    template <typename T>
+    VerboseOutput& operator<<(const T& value) {
+        if (m_verbose) {
+            std::ostringstream output;
+            output << value;
+            write(output.str());
+        }
+        return *this;
+    }
+};
+
+#endif /* SRC_VERBOSE_OUTPUT_HPP_ */
@@ -0,0 +1,106 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "way_segments.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <osmium/geom/haversine.hpp>
+#include <osmium/geom/util.hpp>
+
+size_t WaySegments::load(const osmium::WayNodeList& nodes, const double max_abs_lat) {
+    const size_t count = nodes.size();
+    m_x.resize(count);
+    m_y.resize(count);
+    m_refs.resize(count);
+    // range of valid locations (see osmium::Location::valid()), the latitude limit is exclusive
+    const int32_t max_abs_x = 180 * osmium::Location::coordinate_precision;
+    int32_t max_abs_y = 90 * osmium::Location::coordinate_precision + 1;
+    if (max_abs_lat > 0 && max_abs_lat <= 90.0) {
+        max_abs_y = static_cast<int32_t>(max_abs_lat * osmium::Location::coordinate_precision);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const osmium::NodeRef& node_ref = nodes[i];
+        m_x[i] = node_ref.location().x();
+        m_y[i] = node_ref.location().y();
+        m_refs[i] = node_ref.ref();
+    }
+    // Check all locations at once. An undefined location is outside the valid range, too.
+    int32_t invalid = 0;
+    for (size_t i = 0; i < count; ++i) {
+        invalid |= (m_x[i] < -max_abs_x) | (m_x[i] > max_abs_x) | (m_y[i] <= -max_abs_y) | (m_y[i] >= max_abs_y);
+    }
+    if (invalid) {
+        for (size_t i = 0; i < count; ++i) {
+            if (m_x[i] < -max_abs_x || m_x[i] > max_abs_x || m_y[i] <= -max_abs_y || m_y[i] >= max_abs_y) {
+                return i;
+            }
+        }
+    }
+    compute();
+    return count;
+}
+
+void WaySegments::compute() {
+    const size_t nodes = m_x.size();
+    const size_t segments = segment_count();
+    m_lon.resize(nodes);
+    m_lat.resize(nodes);
+    m_cos_lat.resize(nodes);
+    m_length.resize(segments);
+    m_zero_length.resize(segments);
+    m_duplicate.resize(segments);
+    m_min_x.resize(segments);
+    m_max_x.resize(segments);
+    m_min_y.resize(segments);
+    m_max_y.resize(segments);
+
+    const double precision = osmium::Location::coordinate_precision;
+    for (size_t i = 0; i < nodes; ++i) {
+        m_lon[i] = static_cast<double>(m_x[i]) / precision;
+        m_lat[i] = static_cast<double>(m_y[i]) / precision;
+    }
+    for (size_t i = 0; i < nodes; ++i) {
+        m_cos_lat[i] = std::cos(osmium::geom::deg_to_rad(m_lat[i]));
+    }
+    // same formula as osmium::geom::haversine::distance()
+    for (size_t i = 0; i < segments; ++i) {
+        double lonh = std::sin(osmium::geom::deg_to_rad(m_lon[i] - m_lon[i + 1]) * 0.5);
+        lonh *= lonh;
+        double lath = std::sin(osmium::geom::deg_to_rad(m_lat[i] - m_lat[i + 1]) * 0.5);
+        lath *= lath;
+        m_length[i] = 2.0 * osmium::geom::haversine::EARTH_RADIUS_IN_METERS
+            * std::asin(std::sqrt(lath + m_cos_lat[i] * m_cos_lat[i + 1] * lonh));
+    }
+    size_t zero_length_count = 0;
+    for (size_t i = 0; i < segments; ++i) {
+        const uint8_t zero_length = (m_x[i] == m_x[i + 1]) & (m_y[i] == m_y[i + 1]);
+        m_zero_length[i] = zero_length;
+        m_duplicate[i] = zero_length | (m_refs[i] == m_refs[i + 1]);
+        zero_length_count += zero_length;
+    }
+    m_zero_length_count = zero_length_count;
+    for (size_t i = 0; i < segments; ++i) {
+        m_min_x[i] = std::min(m_x[i], m_x[i + 1]);
+        m_max_x[i] = std::max(m_x[i], m_x[i + 1]);
+        m_min_y[i] = std::min(m_y[i], m_y[i + 1]);
+        m_max_y[i] = std::max(m_y[i], m_y[i + 1]);
+    }
+}
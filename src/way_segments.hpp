@@ -0,0 +1,138 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SRC_WAY_SEGMENTS_HPP_
+#define SRC_WAY_SEGMENTS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <osmium/osm/location.hpp>
+#include <osmium/osm/undirected_segment.hpp>
+#include <osmium/osm/way.hpp>
+
+/**
+ * Locations of the nodes of a way and properties of its segments for the checks of the geometry
+ * view.
+ *
+ * The node list is read once and copied into one array per attribute (structure of arrays).
+ * Segment lengths, flags and bounding boxes are computed for all segments in loops without
+ * branches over these arrays which the compiler can vectorize. The arrays are reused for the
+ * next way, i.e. they do not allocate memory once they are large enough.
+ */
+class WaySegments {
+
+    /// coordinates of the nodes (in 1e-7 degrees)
+    std::vector<int32_t> m_x;
+    std::vector<int32_t> m_y;
+    std::vector<osmium::object_id_type> m_refs;
+
+    /// coordinates of the nodes in degrees
+    std::vector<double> m_lon;
+    std::vector<double> m_lat;
+    /// cosine of the latitude of the nodes (computed once per node instead of twice per segment)
+    std::vector<double> m_cos_lat;
+
+    /// length of the segments in metres (haversine formula)
+    std::vector<double> m_length;
+    /// both ends of the segment have the same location
+    std::vector<uint8_t> m_zero_length;
+    /// both ends of the segment have the same ID or location
+    std::vector<uint8_t> m_duplicate;
+    /// bounding boxes of the segments
+    std::vector<int32_t> m_min_x;
+    std::vector<int32_t> m_max_x;
+    std::vector<int32_t> m_min_y;
+    std::vector<int32_t> m_max_y;
+
+    size_t m_zero_length_count = 0;
+
+    void compute();
+
+public:
+    /**
+     * Read the nodes of a way and compute the properties of all segments.
+     *
+     * \param nodes node list of the way
+     * \param max_abs_lat maximum absolute latitude of a location (exclusive), e.g. to exclude
+     * locations which cannot be projected to Web Mercator, 0 = no limit
+     *
+     * \returns index of the first node with an invalid location or a latitude beyond the limit,
+     * the number of nodes if all locations are valid. The segments are only computed in the latter
+     * case.
+     */
+    size_t load(const osmium::WayNodeList& nodes, const double max_abs_lat = 0);
+
+    size_t node_count() const noexcept {
+        return m_x.size();
+    }
+
+    size_t segment_count() const noexcept {
+        return m_x.empty() ? 0 : m_x.size() - 1;
+    }
+
+    osmium::Location location(const size_t node) const noexcept {
+        return osmium::Location{m_x[node], m_y[node]};
+    }
+
+    osmium::object_id_type ref(const size_t node) const noexcept {
+        return m_refs[node];
+    }
+
+    /**
+     * Segment from the node with the same index to the next node.
+     */
+    osmium::UndirectedSegment segment(const size_t segment) const noexcept {
+        return osmium::UndirectedSegment{location(segment), location(segment + 1)};
+    }
+
+    double length(const size_t segment) const noexcept {
+        return m_length[segment];
+    }
+
+    bool duplicate(const size_t segment) const noexcept {
+        return m_duplicate[segment];
+    }
+
+    /**
+     * Check if the way has only one node or if all its segments have zero length.
+     */
+    bool degenerated() const noexcept {
+        return m_zero_length_count == segment_count();
+    }
+
+    int32_t min_x(const size_t segment) const noexcept {
+        return m_min_x[segment];
+    }
+
+    int32_t max_x(const size_t segment) const noexcept {
+        return m_max_x[segment];
+    }
+
+    int32_t min_y(const size_t segment) const noexcept {
+        return m_min_y[segment];
+    }
+
+    int32_t max_y(const size_t segment) const noexcept {
+        return m_max_y[segment];
+    }
+};
+
+#endif /* SRC_WAY_SEGMENTS_HPP_ */
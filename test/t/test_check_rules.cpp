@@ -0,0 +1,164 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <check_rules.hpp>
+
+struct TestTag {
+    const char* k;
+    const char* v;
+
+    const char* key() const {
+        return k;
+    }
+
+    const char* value() const {
+        return v;
+    }
+};
+
+bool accepts(const char* check, const char* value, const bool closed = false) {
+    static CheckRules rules;
+    if (rules.size() == 0) {
+        rules.load_string(CheckRules::default_rules());
+    }
+    const CheckRule* rule = rules.find(check);
+    REQUIRE(rule);
+    return rule->accepts(value, closed);
+}
+
+TEST_CASE("default rules: maxspeed") {
+    REQUIRE(accepts("highway_maxspeed", "50"));
+    REQUIRE(accepts("highway_maxspeed", "150"));
+    REQUIRE_FALSE(accepts("highway_maxspeed", "151"));
+    REQUIRE_FALSE(accepts("highway_maxspeed", "0"));
+    REQUIRE_FALSE(accepts("highway_maxspeed", "50.5"));
+    REQUIRE(accepts("highway_maxspeed", "30 mph"));
+    REQUIRE(accepts("highway_maxspeed", "112 mph"));
+    REQUIRE_FALSE(accepts("highway_maxspeed", "113 mph"));
+    REQUIRE_FALSE(accepts("highway_maxspeed", "30mph"));
+    REQUIRE(accepts("highway_maxspeed", "none"));
+    REQUIRE(accepts("highway_maxspeed", " none"));
+    REQUIRE(accepts("highway_maxspeed", "signals"));
+    REQUIRE(accepts("highway_maxspeed", "DE:urban"));
+    REQUIRE(accepts("highway_maxspeed", "RU:living_street"));
+    REQUIRE_FALSE(accepts("highway_maxspeed", "DE:motorway"));
+    REQUIRE_FALSE(accepts("highway_maxspeed", ""));
+}
+
+TEST_CASE("default rules: maxweight") {
+    REQUIRE(accepts("highway_maxweight", "7.5"));
+    REQUIRE_FALSE(accepts("highway_maxweight", "90"));
+    REQUIRE(accepts("highway_maxweight", "unsigned"));
+    REQUIRE(accepts("highway_maxweight", "12 t"));
+    REQUIRE_FALSE(accepts("highway_maxweight", "12t"));
+    REQUIRE(accepts("highway_maxweight", "81 st"));
+    REQUIRE_FALSE(accepts("highway_maxweight", "82 st"));
+    REQUIRE(accepts("highway_maxweight", "91 lt"));
+    REQUIRE_FALSE(accepts("highway_maxweight", "92 lt"));
+    REQUIRE(accepts("highway_maxweight", "3500 kg"));
+    REQUIRE_FALSE(accepts("highway_maxweight", "7.5 t"));
+}
+
+TEST_CASE("default rules: maxheight") {
+    REQUIRE(accepts("highway_maxheight", "3.5"));
+    REQUIRE(accepts("highway_maxheight", "default"));
+    REQUIRE_FALSE(accepts("highway_maxheight", "0"));
+    REQUIRE_FALSE(accepts("highway_maxheight", "3.5 m"));
+    REQUIRE(accepts("highway_maxheight", "12'"));
+    REQUIRE(accepts("highway_maxheight", "12'6\""));
+    REQUIRE(accepts("highway_maxheight", "12'0\""));
+    REQUIRE_FALSE(accepts("highway_maxheight", "12'x"));
+    REQUIRE_FALSE(accepts("highway_maxheight", "0'6\""));
+}
+
+TEST_CASE("default rules: value lists") {
+    REQUIRE(accepts("highway_oneway", "-1"));
+    REQUIRE_FALSE(accepts("highway_oneway", "true"));
+    REQUIRE(accepts("highway_unknown_way", "residential"));
+    REQUIRE_FALSE(accepts("highway_unknown_way", "residental"));
+    REQUIRE_FALSE(accepts("highway_unknown_way", "services"));
+    REQUIRE(accepts("highway_unknown_way", "services", true));
+    REQUIRE(accepts("highway_unknown_node", "traffic_signals"));
+    REQUIRE_FALSE(accepts("highway_unknown_node", "residential"));
+    REQUIRE(accepts("place_type", "isolated_dwelling"));
+    REQUIRE_FALSE(accepts("place_type", "city_block"));
+}
+
+TEST_CASE("decision table") {
+    CheckRules rules;
+    rules.load_string(CheckRules::default_rules());
+    CheckTable table = rules.table("highways", CheckRule::object_type::way);
+    std::vector<const CheckRule*> failed;
+
+    SECTION("valid tags") {
+        std::vector<TestTag> tags = {{"highway", "primary"}, {"maxspeed", "50"}, {"oneway", "yes"}, {"name", "Main Street"}};
+        table.evaluate(tags, false, failed);
+        REQUIRE(failed.empty());
+    }
+
+    SECTION("invalid tags") {
+        std::vector<TestTag> tags = {{"highway", "primry"}, {"maxspeed", "fast"}, {"oneway", "yes"}};
+        table.evaluate(tags, false, failed);
+        REQUIRE(failed.size() == 2);
+        REQUIRE(failed[0]->name == "highway_unknown_way");
+        REQUIRE(failed[1]->name == "highway_maxspeed");
+    }
+
+    SECTION("node checks are not part of the way table") {
+        CheckTable node_table = rules.table("highways", CheckRule::object_type::node);
+        std::vector<TestTag> tags = {{"highway", "primary"}};
+        node_table.evaluate(tags, false, failed);
+        REQUIRE(failed.size() == 1);
+        REQUIRE(failed[0]->name == "highway_unknown_node");
+    }
+}
+
+TEST_CASE("parse rules") {
+    CheckRules rules;
+
+    SECTION("custom rule") {
+        rules.load_string("[width]\nview = highways\nkey = width\nlayer = highway_width\n"
+                "values = \"very wide\"\nnumber = real [0.5,20]\nnumber = real \" m\" [0.5,20]\n");
+        REQUIRE(rules.size() == 1);
+        const CheckRule* rule = rules.find("width");
+        REQUIRE(rule);
+        REQUIRE(rule->accepts("0.5"));
+        REQUIRE(rule->accepts("20 m"));
+        REQUIRE(rule->accepts("very wide"));
+        REQUIRE_FALSE(rule->accepts("0.4"));
+        REQUIRE_FALSE(rule->accepts("20.1 m"));
+        REQUIRE_FALSE(rules.find("maxspeed"));
+    }
+
+    SECTION("errors") {
+        REQUIRE_THROWS_AS(rules.load_string("view = highways\n"), CheckRulesError&);
+        REQUIRE_THROWS_AS(rules.load_string("[a]\nview = highways\n"), CheckRulesError&);
+        REQUIRE_THROWS_AS(rules.load_string("[a]\nview = highways\nkey = a\nnumber = decimal\n"), CheckRulesError&);
+        REQUIRE_THROWS_AS(rules.load_string("[a]\nview = highways\nkey = a\nnumber = real (0;1)\n"), CheckRulesError&);
+        REQUIRE_THROWS_AS(rules.load_string("[a]\nview = highways\nkey = a\nvalues = \"x\n"), CheckRulesError&);
+        REQUIRE_THROWS_AS(rules.load_string("[a]\nview = highways\nkey = a\ncolour = red\n"), CheckRulesError&);
+        REQUIRE_THROWS_AS(rules.load_string("[a]\nview = highways\nkey = a\n[a]\nview = highways\nkey = b\n"), CheckRulesError&);
+        REQUIRE_THROWS_AS(rules.load_file("/nonexistent/rules"), CheckRulesError&);
+    }
+}
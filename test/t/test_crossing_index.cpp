@@ -0,0 +1,125 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <osmium/builder/attr.hpp>
+
+#include <crossing_index.hpp>
+
+/**
+ * Add a way with the given nodes to the index.
+ */
+void add_way(CrossingIndex& index, const osmium::object_id_type id, const std::vector<osmium::NodeRef>& nodes,
+        const int8_t layer = 0) {
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer{1024, osmium::memory::Buffer::auto_grow::yes};
+    const size_t offset = osmium::builder::add_way(buffer, _id(id), _nodes(nodes));
+    index.add_way(id, buffer.get<osmium::Way>(offset).nodes(), layer);
+}
+
+osmium::NodeRef node(const osmium::object_id_type id, const double lon, const double lat) {
+    return osmium::NodeRef{id, osmium::Location{lon, lat}};
+}
+
+TEST_CASE("crossing index") {
+
+    CrossingIndex index;
+
+    SECTION("crossing ways") {
+        add_way(index, 1, {node(1, 9.0, 50.0), node(2, 9.1, 50.1)});
+        add_way(index, 2, {node(3, 9.0, 50.1), node(4, 9.1, 50.0)});
+        const std::vector<CrossingIndex::Crossing> crossings = index.find_crossings(2);
+        REQUIRE(crossings.size() == 1);
+        REQUIRE(index.id(crossings.front().way1) == 1);
+        REQUIRE(index.id(crossings.front().way2) == 2);
+        REQUIRE(crossings.front().location == osmium::Location(9.05, 50.05));
+    }
+
+    SECTION("shared node") {
+        add_way(index, 1, {node(1, 9.0, 50.0), node(2, 9.05, 50.05), node(3, 9.1, 50.1)});
+        add_way(index, 2, {node(4, 9.0, 50.1), node(2, 9.05, 50.05), node(5, 9.1, 50.0)});
+        REQUIRE(index.find_crossings(2).empty());
+    }
+
+    SECTION("touching and parallel ways") {
+        add_way(index, 1, {node(1, 9.0, 50.0), node(2, 9.1, 50.0)});
+        add_way(index, 2, {node(3, 9.05, 50.0), node(4, 9.05, 50.1)});
+        add_way(index, 3, {node(5, 9.0, 50.0), node(6, 9.1, 50.0)});
+        REQUIRE(index.find_crossings(1).empty());
+    }
+
+    SECTION("different layers") {
+        add_way(index, 1, {node(1, 9.0, 50.0), node(2, 9.1, 50.1)}, 1);
+        add_way(index, 2, {node(3, 9.0, 50.1), node(4, 9.1, 50.0)});
+        REQUIRE(index.find_crossings(1).empty());
+    }
+
+    SECTION("self intersection is no crossing") {
+        add_way(index, 1, {node(1, 9.0, 50.0), node(2, 9.1, 50.1), node(3, 9.1, 50.0), node(4, 9.0, 50.1)});
+        REQUIRE(index.find_crossings(1).empty());
+    }
+
+    SECTION("crossings spanning many cells are reported once") {
+        // long ways crossing each other and a grid of short ways
+        add_way(index, 1, {node(1, 0.0, 0.0), node(2, 1.0, 1.0)});
+        add_way(index, 2, {node(3, 0.0, 1.0), node(4, 1.0, 0.0)});
+        for (osmium::object_id_type i = 0; i < 20; ++i) {
+            const double x = 0.025 + i * 0.05;
+            add_way(index, 10 + i, {node(100 + i * 2, x, 0.0), node(101 + i * 2, x, 1.0)});
+        }
+        for (const unsigned int threads : {1u, 3u, 8u}) {
+            const std::vector<CrossingIndex::Crossing> crossings = index.find_crossings(threads);
+            // 1 x 2 and both of them with all 20 vertical ways
+            REQUIRE(crossings.size() == 41);
+            REQUIRE(index.id(crossings.front().way1) == 1);
+            REQUIRE(index.id(crossings.front().way2) == 2);
+        }
+        // The budget is exceeded by every row of the grid, the rows are processed one by one.
+        const std::vector<CrossingIndex::Crossing> expected = index.find_crossings(2);
+        const std::vector<CrossingIndex::Crossing> crossings = index.find_crossings(2, 64);
+        REQUIRE(crossings.size() == expected.size());
+        size_t errors = 0;
+        for (size_t i = 0; i < crossings.size(); ++i) {
+            if (crossings[i].way1 != expected[i].way1 || crossings[i].way2 != expected[i].way2
+                    || crossings[i].location != expected[i].location) {
+                ++errors;
+            }
+        }
+        REQUIRE(errors == 0);
+    }
+
+    SECTION("long diagonal segments") {
+        // only the cells along the segments are registered
+        add_way(index, 1, {node(1, -170.0, -80.0), node(2, 170.0, 80.0)});
+        add_way(index, 2, {node(3, -170.0, 80.0), node(4, 170.0, -80.0)});
+        add_way(index, 3, {node(5, 100.0, 40.0), node(6, 100.1, 50.0)});
+        const std::vector<CrossingIndex::Crossing> crossings = index.find_crossings(4, 1024 * 1024);
+        REQUIRE(crossings.size() == 2);
+        REQUIRE(crossings.front().location == osmium::Location(0.0, 0.0));
+        REQUIRE(index.id(crossings.back().way1) == 1);
+        REQUIRE(index.id(crossings.back().way2) == 3);
+    }
+
+    SECTION("clear") {
+        add_way(index, 1, {node(1, 9.0, 50.0), node(2, 9.1, 50.1)});
+        index.clear();
+        REQUIRE(index.size() == 0);
+        REQUIRE(index.find_crossings(2).empty());
+    }
+}
@@ -0,0 +1,94 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <osmium/builder/attr.hpp>
+
+#include <deferred_ways.hpp>
+
+/**
+ * Add ways with IDs 1 to count to the store, each with three nodes.
+ */
+void add_ways(DeferredWays& store, const osmium::object_id_type count) {
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer{1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+    for (osmium::object_id_type id = 1; id <= count; ++id) {
+        buffer.clear();
+        const size_t offset = osmium::builder::add_way(buffer, _id(id), _nodes({id, id + 1, id + 2}));
+        store.add(buffer.get<osmium::Way>(offset));
+    }
+}
+
+/**
+ * Check that all ways are handed back in order.
+ */
+void check_ways(DeferredWays& store, const osmium::object_id_type count) {
+    osmium::object_id_type expected = 1;
+    size_t errors = 0;
+    store.for_each([&expected, &errors](const osmium::Way& way) {
+        if (way.id() != expected || way.nodes().size() != 3 || way.nodes().front().ref() != expected) {
+            ++errors;
+        }
+        ++expected;
+    });
+    REQUIRE(errors == 0);
+    REQUIRE(expected == count + 1);
+}
+
+TEST_CASE("deferred ways") {
+
+    SECTION("empty") {
+        DeferredWays store;
+        check_ways(store, 0);
+        REQUIRE(store.size() == 0);
+    }
+
+    SECTION("in memory") {
+        DeferredWays store;
+        add_ways(store, 1000);
+        REQUIRE(store.size() == 1000);
+        REQUIRE_FALSE(store.spilled());
+        check_ways(store, 1000);
+        // can be read twice
+        check_ways(store, 1000);
+    }
+
+    SECTION("buffers do not grow") {
+        using namespace osmium::builder::attr;
+        osmium::memory::Buffer buffer{1024, osmium::memory::Buffer::auto_grow::yes};
+        const size_t way_size = buffer.get<osmium::Way>(osmium::builder::add_way(buffer, _id(1), _nodes({1, 2, 3}))).padded_size();
+        DeferredWays store;
+        add_ways(store, 500000);
+        // All buffers have the initial size of 16 MB and are filled.
+        const size_t chunk_size = 16 * 1024 * 1024;
+        REQUIRE(store.used_memory() <= (500000 * way_size / chunk_size + 1) * chunk_size);
+        check_ways(store, 500000);
+    }
+
+    SECTION("spilled to disk") {
+        // The budget is exceeded as soon as the first buffer is full.
+        DeferredWays store{1};
+        add_ways(store, 500000);
+        REQUIRE(store.spilled());
+        check_ways(store, 500000);
+        store.clear();
+        REQUIRE(store.size() == 0);
+        REQUIRE_FALSE(store.spilled());
+    }
+}
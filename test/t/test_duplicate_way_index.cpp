@@ -0,0 +1,189 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <osmium/builder/attr.hpp>
+
+#include <duplicate_way_index.hpp>
+
+/**
+ * Add a way with the given nodes to the index.
+ *
+ * \returns ID of the way it is a duplicate of, 0 if none
+ */
+osmium::object_id_type add_way(DuplicateWayIndex& index, const osmium::object_id_type id,
+        const std::vector<osmium::object_id_type>& node_ids, const uint32_t category,
+        std::vector<DuplicateWayIndex::Overlap>& overlaps) {
+    using namespace osmium::builder::attr;
+    std::vector<osmium::NodeRef> nodes;
+    for (const osmium::object_id_type node_id : node_ids) {
+        nodes.emplace_back(node_id);
+    }
+    osmium::memory::Buffer buffer{1024, osmium::memory::Buffer::auto_grow::yes};
+    const size_t offset = osmium::builder::add_way(buffer, _id(id), _nodes(nodes));
+    return index.add_way(id, buffer.get<osmium::Way>(offset).nodes(), category, overlaps);
+}
+
+/// memory budget of the indexes in the tests
+constexpr size_t MAX_MEMORY = 1024 * 1024;
+
+std::vector<osmium::object_id_type> range(const osmium::object_id_type first, const osmium::object_id_type last) {
+    std::vector<osmium::object_id_type> ids;
+    for (osmium::object_id_type id = first; id <= last; ++id) {
+        ids.push_back(id);
+    }
+    return ids;
+}
+
+std::vector<osmium::object_id_type> concat(std::vector<osmium::object_id_type> a,
+        const std::vector<osmium::object_id_type>& b) {
+    a.insert(a.end(), b.begin(), b.end());
+    return a;
+}
+
+TEST_CASE("duplicate ways") {
+    DuplicateWayIndex index{MAX_MEMORY};
+    std::vector<DuplicateWayIndex::Overlap> overlaps;
+
+    SECTION("same and reversed nodes") {
+        REQUIRE(add_way(index, 1, {1, 2, 3}, 0, overlaps) == 0);
+        REQUIRE(add_way(index, 2, {1, 2, 4}, 0, overlaps) == 0);
+        REQUIRE(add_way(index, 3, {1, 2, 3}, 0, overlaps) == 1);
+        REQUIRE(add_way(index, 4, {3, 2, 1}, 0, overlaps) == 1);
+        REQUIRE(add_way(index, 5, {1, 2}, 0, overlaps) == 0);
+        REQUIRE(add_way(index, 6, {2, 3, 1}, 0, overlaps) == 0);
+        REQUIRE(index.size() == 4);
+    }
+
+    SECTION("way IDs which do not fit in 31 bits") {
+        REQUIRE(add_way(index, -1, {1, 2, 3}, 0, overlaps) == 0);
+        REQUIRE(add_way(index, 1LL << 40, {4, 5, 6}, 0, overlaps) == 0);
+        REQUIRE(add_way(index, 2, {3, 2, 1}, 0, overlaps) == -1);
+        REQUIRE(add_way(index, 3, {4, 5, 6}, 0, overlaps) == 1LL << 40);
+    }
+
+    SECTION("closed ways starting at different nodes") {
+        REQUIRE(add_way(index, 1, {10, 11, 12, 13, 10}, 0, overlaps) == 0);
+        REQUIRE(add_way(index, 2, {12, 13, 10, 11, 12}, 0, overlaps) == 1);
+        REQUIRE(add_way(index, 3, {11, 10, 13, 12, 11}, 0, overlaps) == 1);
+        REQUIRE(add_way(index, 4, {10, 12, 11, 13, 10}, 0, overlaps) == 0);
+        // not closed
+        REQUIRE(add_way(index, 5, {12, 13, 10, 11}, 0, overlaps) == 0);
+    }
+
+    SECTION("duplicates are not reported as overlaps") {
+        REQUIRE(add_way(index, 1, range(1, 30), 1, overlaps) == 0);
+        REQUIRE(add_way(index, 2, range(1, 30), 1, overlaps) == 1);
+        REQUIRE(overlaps.empty());
+    }
+}
+
+TEST_CASE("overlapping ways") {
+    DuplicateWayIndex index{MAX_MEMORY};
+    std::vector<DuplicateWayIndex::Overlap> overlaps;
+    REQUIRE(add_way(index, 1, range(1, 30), 1, overlaps) == 0);
+    REQUIRE(overlaps.empty());
+
+    SECTION("shared run of nodes") {
+        REQUIRE(add_way(index, 2, concat(concat(range(100, 110), range(11, 25)), range(200, 205)), 1, overlaps) == 0);
+        REQUIRE(overlaps.size() == 1);
+        REQUIRE(overlaps.front().other == 1);
+        REQUIRE(overlaps.front().first >= 11);
+        REQUIRE(overlaps.front().last <= 25);
+        REQUIRE(overlaps.front().last - overlaps.front().first + 1 >= DuplicateWayIndex::WINDOW_NODES);
+    }
+
+    SECTION("shared run of nodes in reverse order") {
+        std::vector<osmium::object_id_type> ids = range(11, 25);
+        std::reverse(ids.begin(), ids.end());
+        REQUIRE(add_way(index, 2, concat(ids, range(200, 205)), 1, overlaps) == 0);
+        REQUIRE(overlaps.size() == 1);
+        REQUIRE(overlaps.front().other == 1);
+        REQUIRE(overlaps.front().last <= 14);
+    }
+
+    SECTION("separate shared runs of nodes") {
+        REQUIRE(add_way(index, 2, range(31, 100), 1, overlaps) == 0);
+        REQUIRE(add_way(index, 3, concat(concat(range(1, 25), range(500, 530)), range(60, 90)), 1, overlaps) == 0);
+        REQUIRE(overlaps.size() == 2);
+        REQUIRE(overlaps[0].other == 1);
+        REQUIRE(overlaps[0].last <= 24);
+        REQUIRE(overlaps[1].other == 2);
+        REQUIRE(overlaps[1].first >= 56);
+    }
+
+    SECTION("separate shared runs of nodes with the same way") {
+        REQUIRE(add_way(index, 2, range(31, 100), 1, overlaps) == 0);
+        REQUIRE(add_way(index, 3, concat(concat(range(40, 60), range(500, 530)), range(70, 90)), 1, overlaps) == 0);
+        REQUIRE(overlaps.size() == 2);
+        REQUIRE(overlaps[0].other == 2);
+        REQUIRE(overlaps[0].last <= 20);
+        REQUIRE(overlaps[1].other == 2);
+        REQUIRE(overlaps[1].first >= 52);
+    }
+
+    SECTION("other category") {
+        REQUIRE(add_way(index, 2, concat(range(11, 25), range(200, 205)), 2, overlaps) == 0);
+        REQUIRE(overlaps.empty());
+        REQUIRE(add_way(index, 3, concat(range(11, 25), range(300, 305)), 0, overlaps) == 0);
+        REQUIRE(overlaps.empty());
+    }
+
+    SECTION("short shared run") {
+        REQUIRE(add_way(index, 2, concat(concat(range(100, 110), range(11, 15)), range(200, 210)), 1, overlaps) == 0);
+        REQUIRE(overlaps.empty());
+    }
+
+    SECTION("closed way sharing a run with itself") {
+        REQUIRE(add_way(index, 2, concat(range(100, 130), range(100, 101)), 1, overlaps) == 0);
+        REQUIRE(overlaps.empty());
+    }
+}
+
+TEST_CASE("overlaps of the minimum length are always found") {
+    DuplicateWayIndex index{MAX_MEMORY};
+    std::vector<DuplicateWayIndex::Overlap> overlaps;
+    REQUIRE(add_way(index, 1, range(1, 1000), 1, overlaps) == 0);
+    size_t found = 0;
+    const osmium::object_id_type count = 1000 - DuplicateWayIndex::MIN_OVERLAP_NODES;
+    for (osmium::object_id_type start = 1; start <= count; ++start) {
+        const std::vector<osmium::object_id_type> ids = concat(
+                range(start, start + DuplicateWayIndex::MIN_OVERLAP_NODES - 1), {-start});
+        add_way(index, start + 1, ids, 1, overlaps);
+        if (overlaps.size() == 1 && overlaps.front().other == 1) {
+            ++found;
+        }
+    }
+    REQUIRE(found == static_cast<size_t>(count));
+}
+
+TEST_CASE("duplicate ways with memory budget") {
+    // 2^16 slots, three quarters of them are used
+    DuplicateWayIndex index{(1 << 16) * 8};
+    std::vector<DuplicateWayIndex::Overlap> overlaps;
+    for (osmium::object_id_type id = 1; id <= 100000; ++id) {
+        add_way(index, id, {id, id + 1000000}, 0, overlaps);
+    }
+    REQUIRE(index.full());
+    REQUIRE(index.size() == (1 << 16) / 4 * 3);
+    REQUIRE(index.used_memory() >= (1 << 16) * 8);
+    // early ways are still found, later ones are not
+    REQUIRE(add_way(index, 200001, {1, 1000001}, 0, overlaps) == 1);
+    REQUIRE(add_way(index, 200002, {100000, 1100000}, 0, overlaps) == 0);
+}
@@ -18,10 +18,10 @@
  */
 #include "catch.hpp"
 
-#include <highway_view_handler.hpp>
+#include <turn_lanes.hpp>
 
 bool check_turn(const char* value) {
-    return HighwayViewHandler::check_valid_turns(value);
+    return turn_lanes::lex(value).valid;
 }
 
 TEST_CASE("test valid turn:lane values") {
@@ -0,0 +1,84 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <key_scan.hpp>
+
+bool same(const key_scan::KeyClass& a, const key_scan::KeyClass& b) {
+    return a.length == b.length && a.unusual == b.unusual && a.whitespace == b.whitespace;
+}
+
+TEST_CASE("key scan") {
+
+    SECTION("usual keys") {
+        for (const char* key : {"", "highway", "addr:housenumber", "name:de-CH", "building_1",
+                "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"}) {
+            const key_scan::KeyClass result = key_scan::scan(key);
+            REQUIRE(result.length == strlen(key));
+            REQUIRE_FALSE(result.unusual);
+            REQUIRE_FALSE(result.whitespace);
+        }
+    }
+
+    SECTION("unusual characters") {
+        for (const char* key : {"name@de", "höhe", "a.b", "a/b", "[x]", "`", "{", "very_long_key_with_an_unusual_character_at_the_end."}) {
+            const key_scan::KeyClass result = key_scan::scan(key);
+            REQUIRE(result.unusual);
+            REQUIRE_FALSE(result.whitespace);
+        }
+    }
+
+    SECTION("whitespace") {
+        for (const char* key : {" ", "a b", "name ", "\tname", "a\nb", "a\rb", "a\vb", "a\fb"}) {
+            const key_scan::KeyClass result = key_scan::scan(key);
+            REQUIRE(result.unusual);
+            REQUIRE(result.whitespace);
+        }
+    }
+
+    SECTION("same result as the scalar implementation for all bytes, positions and alignments") {
+        std::vector<char> memory(256, 'a');
+        size_t mismatches = 0;
+        for (size_t start = 0; start < 64; ++start) {
+            for (size_t length = 0; length < 70; ++length) {
+                for (int byte = 1; byte < 256; byte += (length < 40 ? 1 : 17)) {
+                    std::fill(memory.begin(), memory.end(), 'a');
+                    char* key = memory.data() + start;
+                    key[length] = '\0';
+                    // garbage after the end of the string must be ignored
+                    key[length + 1] = ' ';
+                    if (length > 0) {
+                        key[(byte * 7) % length] = static_cast<char>(byte);
+                    }
+                    if (start > 0) {
+                        key[-1] = '.';
+                    }
+                    if (!same(key_scan::scan(key), key_scan::scan_scalar(key))) {
+                        ++mismatches;
+                    }
+                }
+            }
+        }
+        REQUIRE(mismatches == 0);
+    }
+}
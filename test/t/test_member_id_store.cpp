@@ -0,0 +1,68 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <member_id_store.hpp>
+
+TEST_CASE("member ID store in memory") {
+    MemberIdStore store;
+    store.add(17);
+    store.add(3);
+    store.add(17);
+    store.add(-5);
+    store.prepare();
+
+    REQUIRE(store.size() == 3);
+    REQUIRE_FALSE(store.spilled());
+    REQUIRE(store.contains(-5));
+    REQUIRE(store.contains(3));
+    REQUIRE(store.contains(17));
+    REQUIRE_FALSE(store.contains(4));
+    REQUIRE_FALSE(store.contains(18));
+}
+
+TEST_CASE("member ID store spilling to disk") {
+    // budget of 100 IDs
+    MemberIdStore store(100 * sizeof(int64_t));
+    for (int64_t i = 100000; i > 0; --i) {
+        if (i % 3 == 0) {
+            store.add(i);
+            store.add(i);
+        }
+    }
+    store.prepare();
+
+    REQUIRE(store.spilled());
+    REQUIRE(store.size() == 33333);
+
+    SECTION("ascending lookups") {
+        for (int64_t i = 1; i <= 100001; ++i) {
+            REQUIRE(store.contains(i) == (i % 3 == 0 && i <= 100000));
+        }
+    }
+
+    SECTION("lookups out of order") {
+        REQUIRE(store.contains(99999));
+        REQUIRE_FALSE(store.contains(100000));
+        REQUIRE(store.contains(3));
+        REQUIRE_FALSE(store.contains(1));
+        REQUIRE(store.contains(66666));
+        REQUIRE(store.contains(66666));
+    }
+}
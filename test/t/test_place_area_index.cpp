@@ -0,0 +1,153 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <algorithm>
+#include <random>
+
+#include <osmium/osm/way.hpp>
+
+#include <place_area_index.hpp>
+
+/**
+ * Add a ring given by coordinates in degrees.
+ */
+void add_ring(PlaceAreaIndex& index, const std::vector<std::pair<double, double>>& coordinates) {
+    std::vector<osmium::NodeRef> ring;
+    for (const auto& c : coordinates) {
+        ring.emplace_back(0, osmium::Location{c.first, c.second});
+    }
+    index.add_ring(ring.begin(), ring.end());
+}
+
+/**
+ * Add a square polygon with the given lower left corner and size (in units of osmium::Location).
+ */
+size_t add_square(PlaceAreaIndex& index, const int32_t x, const int32_t y, const int32_t size) {
+    std::vector<osmium::NodeRef> ring;
+    ring.emplace_back(0, osmium::Location{x, y});
+    ring.emplace_back(0, osmium::Location{x + size, y});
+    ring.emplace_back(0, osmium::Location{x + size, y + size});
+    ring.emplace_back(0, osmium::Location{x, y + size});
+    ring.emplace_back(0, osmium::Location{x, y});
+    index.add_ring(ring.begin(), ring.end());
+    return index.finish_polygon();
+}
+
+std::vector<size_t> search(const PlaceAreaIndex& index, const PlaceAreaIndex::Box& box) {
+    std::vector<size_t> result;
+    index.search(box, [&result](const size_t polygon) {
+        result.push_back(polygon);
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+TEST_CASE("point in polygon") {
+    PlaceAreaIndex index;
+    // square with a hole
+    add_ring(index, {{0, 0}, {10, 0}, {10, 10}, {0, 10}, {0, 0}});
+    add_ring(index, {{2, 2}, {2, 4}, {4, 4}, {4, 2}, {2, 2}});
+    REQUIRE(index.finish_polygon() == 0);
+    // concave polygon with many edges (several bands): a comb
+    std::vector<std::pair<double, double>> comb = {{20, 0}};
+    for (int i = 0; i < 50; ++i) {
+        comb.emplace_back(21 + i * 0.2, 0);
+        comb.emplace_back(21 + i * 0.2, 5);
+        comb.emplace_back(21.1 + i * 0.2, 5);
+        comb.emplace_back(21.1 + i * 0.2, 0);
+    }
+    comb.emplace_back(40, 0);
+    comb.emplace_back(40, -1);
+    comb.emplace_back(20, -1);
+    comb.emplace_back(20, 0);
+    add_ring(index, comb);
+    REQUIRE(index.finish_polygon() == 1);
+    index.prepare();
+
+    REQUIRE(index.contains(0, osmium::Location{1.0, 1.0}));
+    REQUIRE(index.contains(0, osmium::Location{9.9, 5.0}));
+    REQUIRE_FALSE(index.contains(0, osmium::Location{3.0, 3.0}));
+    REQUIRE_FALSE(index.contains(0, osmium::Location{11.0, 5.0}));
+    REQUIRE_FALSE(index.contains(0, osmium::Location{-0.1, 5.0}));
+
+    REQUIRE(index.contains(1, osmium::Location{25.0, -0.5}));
+    REQUIRE(index.contains(1, osmium::Location{21.05, 2.0}));
+    REQUIRE(index.contains(1, osmium::Location{30.85, 4.9}));
+    REQUIRE_FALSE(index.contains(1, osmium::Location{21.15, 2.0}));
+    REQUIRE_FALSE(index.contains(1, osmium::Location{30.95, 4.9}));
+    REQUIRE_FALSE(index.contains(1, osmium::Location{25.0, 6.0}));
+    REQUIRE_FALSE(index.contains(1, osmium::Location{5.0, 5.0}));
+}
+
+TEST_CASE("polygon without edges") {
+    PlaceAreaIndex index;
+    REQUIRE(index.finish_polygon() == 0);
+    index.prepare();
+    REQUIRE_FALSE(index.contains(0, osmium::Location{0.0, 0.0}));
+    REQUIRE(search(index, PlaceAreaIndex::Box{-1000, -1000, 1000, 1000}).empty());
+}
+
+TEST_CASE("search in R-tree") {
+    PlaceAreaIndex index;
+
+    SECTION("empty index") {
+        index.prepare();
+        REQUIRE(search(index, PlaceAreaIndex::Box{0, 0, 10, 10}).empty());
+    }
+
+    SECTION("same result as a linear search") {
+        std::mt19937 random{42};
+        std::uniform_int_distribution<int32_t> coordinate{-100000000, 100000000};
+        std::uniform_int_distribution<int32_t> size{1, 5000000};
+        for (int i = 0; i < 5000; ++i) {
+            add_square(index, coordinate(random), coordinate(random), size(random));
+        }
+        index.prepare();
+        size_t errors = 0;
+        for (int i = 0; i < 1000; ++i) {
+            const int32_t x = coordinate(random);
+            const int32_t y = coordinate(random);
+            const PlaceAreaIndex::Box box{x, y, x + size(random), y + size(random)};
+            std::vector<size_t> expected;
+            for (size_t polygon = 0; polygon < index.size(); ++polygon) {
+                if (index.box(polygon).intersects(box)) {
+                    expected.push_back(polygon);
+                }
+            }
+            if (search(index, box) != expected) {
+                ++errors;
+            }
+        }
+        REQUIRE(errors == 0);
+    }
+}
+
+TEST_CASE("memory usage") {
+    PlaceAreaIndex index;
+    REQUIRE(index.used_memory() == 0);
+    for (int32_t i = 0; i < 100; ++i) {
+        add_square(index, i * 1000, 0, 500);
+    }
+    index.prepare();
+    // at least 16 bytes for each of the four edges of a square
+    REQUIRE(index.used_memory() >= 100 * 4 * 16);
+    index.clear();
+    REQUIRE(index.used_memory() == 0);
+}
@@ -0,0 +1,204 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <osmium/builder/attr.hpp>
+
+#include <places_area_collector.hpp>
+
+/**
+ * ID of the first object and number of objects of a buffer handed to the callback
+ */
+struct Delivery {
+    osmium::object_id_type first_id;
+    size_t count;
+};
+
+/**
+ * Add a closed way tagged with place=island. Its first and last node share their location.
+ */
+size_t add_closed_way(osmium::memory::Buffer& buffer, const osmium::object_id_type id) {
+    using namespace osmium::builder::attr;
+    const osmium::object_id_type n = id * 10;
+    return osmium::builder::add_way(buffer, _id(id), _tag("place", "island"),
+            _nodes({osmium::NodeRef{n, osmium::Location{1.0, 1.0}}, osmium::NodeRef{n + 1, osmium::Location{2.0, 1.0}},
+                    osmium::NodeRef{n + 2, osmium::Location{2.0, 2.0}}, osmium::NodeRef{n, osmium::Location{1.0, 1.0}}}));
+}
+
+TEST_CASE("areas are delivered in the order the tasks were submitted") {
+    using namespace osmium::builder::attr;
+    Options options;
+    osmium::area::Assembler::config_type assembler_config;
+    PlacesAreaCollector collector{options, assembler_config};
+
+    // The tasks of the first relations take longest, i.e. they complete after the later tasks.
+    // Instead of areas, the tasks return their input.
+    collector.set_assemble_function([](osmium::memory::Buffer input) {
+        const osmium::object_id_type first_id = input.begin<osmium::OSMObject>()->id();
+        if (first_id < 3) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200 / first_id));
+        }
+        return input;
+    });
+    std::vector<Delivery> deliveries;
+    collector.set_callback([&deliveries](const osmium::memory::Buffer& buffer) {
+        size_t count = 0;
+        for (auto it = buffer.cbegin<osmium::OSMObject>(); it != buffer.cend<osmium::OSMObject>(); ++it) {
+            ++count;
+        }
+        deliveries.push_back(Delivery{buffer.cbegin<osmium::OSMObject>()->id(), count});
+    });
+
+    // relations 1 to 3, each with a single member way (IDs 11 to 13)
+    osmium::memory::Buffer relations{1024, osmium::memory::Buffer::auto_grow::yes};
+    for (osmium::object_id_type id = 1; id <= 3; ++id) {
+        osmium::builder::add_relation(relations, _id(id), _tag("type", "multipolygon"), _tag("place", "island"),
+                _member(osmium::item_type::way, 10 + id, "outer"));
+    }
+    for (auto it = relations.cbegin<osmium::Relation>(); it != relations.cend<osmium::Relation>(); ++it) {
+        collector.add_relation(*it);
+    }
+    collector.finish_relations();
+
+    // The member ways of the relations are followed by 2500 closed ways which are not members of
+    // any relation. They are assembled in batches of 1000 ways.
+    osmium::memory::Buffer ways{1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+    for (osmium::object_id_type id = 11; id <= 13; ++id) {
+        ways.clear();
+        collector.process_way(ways.get<osmium::Way>(add_closed_way(ways, id)));
+    }
+    for (osmium::object_id_type id = 1000; id < 3500; ++id) {
+        ways.clear();
+        collector.process_way(ways.get<osmium::Way>(add_closed_way(ways, id)));
+    }
+    // The relations and the last, partial batch are submitted by flush().
+    REQUIRE(deliveries.size() < 6);
+    collector.flush();
+
+    REQUIRE(deliveries.size() == 6);
+    // batches of closed ways
+    REQUIRE(deliveries[0].first_id == 1000);
+    REQUIRE(deliveries[0].count == 1000);
+    REQUIRE(deliveries[1].first_id == 2000);
+    REQUIRE(deliveries[1].count == 1000);
+    // relation and its member way
+    REQUIRE(deliveries[2].first_id == 1);
+    REQUIRE(deliveries[2].count == 2);
+    REQUIRE(deliveries[3].first_id == 2);
+    REQUIRE(deliveries[3].count == 2);
+    REQUIRE(deliveries[4].first_id == 3);
+    REQUIRE(deliveries[4].count == 2);
+    REQUIRE(deliveries[5].first_id == 3000);
+    REQUIRE(deliveries[5].count == 500);
+}
+
+TEST_CASE("relations are handed over with all of their member ways") {
+    using namespace osmium::builder::attr;
+    Options options;
+    osmium::area::Assembler::config_type assembler_config;
+    PlacesAreaCollector collector{options, assembler_config};
+    collector.set_assemble_function([](osmium::memory::Buffer input) {
+        return input;
+    });
+    std::vector<Delivery> deliveries;
+    collector.set_callback([&deliveries](const osmium::memory::Buffer& buffer) {
+        size_t count = 0;
+        for (auto it = buffer.cbegin<osmium::OSMObject>(); it != buffer.cend<osmium::OSMObject>(); ++it) {
+            ++count;
+        }
+        deliveries.push_back(Delivery{buffer.cbegin<osmium::OSMObject>()->id(), count});
+    });
+
+    // Relation 1 references way 11 twice and a node, way 12 is also a member of relation 2.
+    // Relation 3 is not a place, relation 4 misses way 14.
+    osmium::memory::Buffer relations{1024, osmium::memory::Buffer::auto_grow::yes};
+    osmium::builder::add_relation(relations, _id(1), _tag("type", "multipolygon"), _tag("place", "island"),
+            _member(osmium::item_type::way, 11, "outer"), _member(osmium::item_type::way, 12, "outer"),
+            _member(osmium::item_type::way, 11, "outer"), _member(osmium::item_type::node, 1, "label"));
+    osmium::builder::add_relation(relations, _id(2), _tag("type", "boundary"), _tag("boundary", "administrative"),
+            _tag("name", "Bla"), _member(osmium::item_type::way, 12, "outer"));
+    osmium::builder::add_relation(relations, _id(3), _tag("type", "multipolygon"), _tag("natural", "water"),
+            _member(osmium::item_type::way, 13, "outer"));
+    osmium::builder::add_relation(relations, _id(4), _tag("type", "multipolygon"), _tag("place", "island"),
+            _member(osmium::item_type::way, 13, "outer"), _member(osmium::item_type::way, 14, "outer"));
+    for (auto it = relations.cbegin<osmium::Relation>(); it != relations.cend<osmium::Relation>(); ++it) {
+        collector.add_relation(*it);
+    }
+    collector.finish_relations();
+
+    osmium::memory::Buffer ways{1024, osmium::memory::Buffer::auto_grow::yes};
+    for (osmium::object_id_type id = 13; id >= 11; --id) {
+        ways.clear();
+        collector.process_way(ways.get<osmium::Way>(add_closed_way(ways, id)));
+    }
+    collector.flush();
+
+    REQUIRE(deliveries.size() == 2);
+    REQUIRE(deliveries[0].first_id == 1);
+    REQUIRE(deliveries[0].count == 3);
+    REQUIRE(deliveries[1].first_id == 2);
+    REQUIRE(deliveries[1].count == 2);
+}
+
+TEST_CASE("flush delivers a partial batch of closed ways") {
+    Options options;
+    osmium::area::Assembler::config_type assembler_config;
+    PlacesAreaCollector collector{options, assembler_config};
+    collector.set_assemble_function([](osmium::memory::Buffer input) {
+        return input;
+    });
+    std::vector<Delivery> deliveries;
+    collector.set_callback([&deliveries](const osmium::memory::Buffer& buffer) {
+        size_t count = 0;
+        for (auto it = buffer.cbegin<osmium::OSMObject>(); it != buffer.cend<osmium::OSMObject>(); ++it) {
+            ++count;
+        }
+        deliveries.push_back(Delivery{buffer.cbegin<osmium::OSMObject>()->id(), count});
+    });
+
+    osmium::memory::Buffer ways{1024, osmium::memory::Buffer::auto_grow::yes};
+    for (osmium::object_id_type id = 1; id <= 3; ++id) {
+        ways.clear();
+        collector.process_way(ways.get<osmium::Way>(add_closed_way(ways, id)));
+    }
+    REQUIRE(deliveries.empty());
+    collector.flush();
+
+    REQUIRE(deliveries.size() == 1);
+    REQUIRE(deliveries[0].first_id == 1);
+    REQUIRE(deliveries[0].count == 3);
+}
+
+TEST_CASE("exceptions of a task are thrown by flush") {
+    Options options;
+    osmium::area::Assembler::config_type assembler_config;
+    PlacesAreaCollector collector{options, assembler_config};
+    collector.set_assemble_function([](osmium::memory::Buffer) -> osmium::memory::Buffer {
+        throw std::runtime_error{"assembly failed"};
+    });
+
+    osmium::memory::Buffer ways{1024, osmium::memory::Buffer::auto_grow::yes};
+    collector.process_way(ways.get<osmium::Way>(add_closed_way(ways, 1)));
+    REQUIRE_THROWS_AS(collector.flush(), std::runtime_error);
+}
@@ -0,0 +1,71 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <cstdlib>
+#include <limits>
+
+#include <quantity.hpp>
+
+/**
+ * Compare with strtol() and strtod() (the program runs in the C locale).
+ */
+void check_like_strtol_strtod(const char* value) {
+    const Quantity quantity = Quantity::parse(value);
+    char* rest;
+    const long integer = std::strtol(value, &rest, 10);
+    REQUIRE(quantity.integer_end == rest);
+    REQUIRE(quantity.integer == integer);
+    const double real = std::strtod(value, &rest);
+    REQUIRE(quantity.real_end == rest);
+    REQUIRE(quantity.real == real);
+}
+
+TEST_CASE("quantity parser") {
+
+    SECTION("same result as strtol and strtod") {
+        for (const char* value : {"50", "30 mph", "7.5", "7.5 t", "12 t", "3500 kg", "12'6\"", "-3", "+4",
+                " 20", "\t20", "0.25", ".5", "5.", "abc", "", "-", ".", "-.5 m", "1234567890123",
+                "007", "81 st", "3.14159265358979", "0.000001", "2,5"}) {
+            check_like_strtol_strtod(value);
+        }
+    }
+
+    SECTION("integer") {
+        REQUIRE(Quantity::parse("16").is_integer());
+        REQUIRE_FALSE(Quantity::parse("16 ").is_integer());
+        REQUIRE_FALSE(Quantity::parse("2.5").is_integer());
+        REQUIRE_FALSE(Quantity::parse("").is_integer());
+        REQUIRE_FALSE(Quantity::parse("x").has_integer());
+    }
+
+    SECTION("no exponents, hexadecimal numbers, infinity or NaN") {
+        const Quantity exponent = Quantity::parse("1e3");
+        REQUIRE(exponent.real == 1);
+        REQUIRE(*exponent.real_end == 'e');
+        REQUIRE(Quantity::parse("0x10").integer == 0);
+        REQUIRE_FALSE(Quantity::parse("inf").has_real());
+        REQUIRE_FALSE(Quantity::parse("nan").has_real());
+    }
+
+    SECTION("overflow") {
+        REQUIRE(Quantity::parse("99999999999999999999").integer == std::numeric_limits<long>::max());
+        REQUIRE(Quantity::parse("-99999999999999999999").integer == std::numeric_limits<long>::min());
+    }
+}
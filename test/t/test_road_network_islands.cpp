@@ -0,0 +1,114 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <osmium/builder/attr.hpp>
+
+#include <road_network_islands.hpp>
+
+osmium::Location location_of(const osmium::object_id_type node_id) {
+    return osmium::Location{static_cast<double>(node_id % 3600) / 100, static_cast<double>(node_id % 1700) / 100};
+}
+
+/**
+ * Add a way with the given nodes, the locations of the nodes are derived from their IDs.
+ */
+void add_way(RoadNetworkIslands& network, const osmium::object_id_type id,
+        const std::vector<osmium::object_id_type>& node_ids, const double length = 100) {
+    using namespace osmium::builder::attr;
+    std::vector<osmium::NodeRef> nodes;
+    for (const osmium::object_id_type node_id : node_ids) {
+        nodes.emplace_back(node_id, location_of(node_id));
+    }
+    osmium::memory::Buffer buffer{1024, osmium::memory::Buffer::auto_grow::yes};
+    const size_t offset = osmium::builder::add_way(buffer, _id(id), _nodes(nodes));
+    network.add_way(id, buffer.get<osmium::Way>(offset).nodes(), length);
+}
+
+TEST_CASE("dense node index") {
+    DenseNodeIndex index;
+    const std::vector<osmium::unsigned_object_id_type> ids = {5, 1, 4095, 4096, 70000, 12000000000ULL, 64, 63};
+    for (const auto id : ids) {
+        index.set(id);
+    }
+    // duplicates do not change anything
+    index.set(5);
+    index.prepare();
+    REQUIRE(index.count() == ids.size());
+    REQUIRE(index.rank(1) == 0);
+    REQUIRE(index.rank(5) == 1);
+    REQUIRE(index.rank(63) == 2);
+    REQUIRE(index.rank(64) == 3);
+    REQUIRE(index.rank(4095) == 4);
+    REQUIRE(index.rank(4096) == 5);
+    REQUIRE(index.rank(70000) == 6);
+    REQUIRE(index.rank(12000000000ULL) == 7);
+}
+
+TEST_CASE("road network islands") {
+
+    RoadNetworkIslands network;
+
+    SECTION("empty") {
+        REQUIRE(network.find_islands(10, 1000).empty());
+    }
+
+    SECTION("connected network") {
+        add_way(network, 1, {1, 2, 3});
+        add_way(network, 2, {3, 4});
+        add_way(network, 3, {5, 2});
+        REQUIRE(network.find_islands(10, 1000).empty());
+    }
+
+    SECTION("small island") {
+        // main network
+        for (osmium::object_id_type i = 0; i < 20; ++i) {
+            add_way(network, 100 + i, {1000 + i, 1001 + i}, 500);
+        }
+        // island of two ways
+        add_way(network, 1, {5001, 5002}, 50);
+        add_way(network, 2, {5002, 5003}, 70);
+        // island of one long way
+        add_way(network, 3, {6001, 6002, 6003}, 5000);
+        // not connected to the island by a way only
+        add_way(network, 4, {5004, 5005}, 10);
+
+        std::vector<RoadNetworkIslands::Island> islands = network.find_islands(2, 1000);
+        REQUIRE(islands.size() == 3);
+        REQUIRE(islands[0].ways.size() == 2);
+        REQUIRE(network.id(islands[0].ways[0]) == 1);
+        REQUIRE(network.id(islands[0].ways[1]) == 2);
+        REQUIRE(islands[0].length == Approx(120));
+        REQUIRE(network.id(islands[1].ways[0]) == 3);
+        REQUIRE(network.id(islands[2].ways[0]) == 4);
+
+        // the long way is not small if one way is allowed
+        islands = network.find_islands(1, 1000);
+        REQUIRE(islands.size() == 2);
+    }
+
+    SECTION("locations are kept") {
+        add_way(network, 1, {12345, 1, 12345678});
+        const std::vector<osmium::Location> locations = network.locations(0);
+        REQUIRE(locations.size() == 3);
+        REQUIRE(locations[0] == location_of(12345));
+        REQUIRE(locations[1] == location_of(1));
+        REQUIRE(locations[2] == location_of(12345678));
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <vector>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/osm/way.hpp>
+
+#include <sorted_object_store.hpp>
+
+/**
+ * Add count ways to the store. Their keys are permuted, way i gets key (i * 7919) % 1000. The ID
+ * of a way is its insertion order.
+ */
+void add_ways(SortedObjectStore& store, const osmium::object_id_type count) {
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer{1024, osmium::memory::Buffer::auto_grow::yes};
+    for (osmium::object_id_type id = 0; id < count; ++id) {
+        buffer.clear();
+        const size_t offset = osmium::builder::add_way(buffer, _id(id), _nodes({id, id + 1, id + 2}));
+        store.add(static_cast<uint64_t>(id * 7919) % 1000, buffer.get<osmium::Way>(offset));
+    }
+}
+
+/**
+ * Check that all ways are handed back ordered by key and, for the same key, by insertion order.
+ */
+void check_ways(SortedObjectStore& store, const osmium::object_id_type count) {
+    uint64_t last_key = 0;
+    osmium::object_id_type last_id = -1;
+    size_t errors = 0;
+    osmium::object_id_type seen = 0;
+    store.for_each([&](const uint64_t key, const osmium::memory::Item& item) {
+        const osmium::Way& way = static_cast<const osmium::Way&>(item);
+        if (key < last_key || (key == last_key && way.id() <= last_id)
+                || key != static_cast<uint64_t>(way.id() * 7919) % 1000
+                || way.nodes().size() != 3 || way.nodes().front().ref() != way.id()) {
+            ++errors;
+        }
+        last_key = key;
+        last_id = way.id();
+        ++seen;
+    });
+    REQUIRE(errors == 0);
+    REQUIRE(seen == count);
+}
+
+TEST_CASE("sorted object store") {
+
+    SECTION("empty") {
+        SortedObjectStore store;
+        check_ways(store, 0);
+        REQUIRE(store.size() == 0);
+    }
+
+    SECTION("in memory") {
+        SortedObjectStore store;
+        add_ways(store, 5000);
+        REQUIRE(store.size() == 5000);
+        REQUIRE_FALSE(store.spilled());
+        check_ways(store, 5000);
+    }
+
+    SECTION("spilled to disk") {
+        // The budget is exceeded as soon as the second buffer is needed.
+        SortedObjectStore store{1};
+        add_ways(store, 50000);
+        REQUIRE(store.spilled());
+        check_ways(store, 50000);
+        store.clear();
+        REQUIRE(store.size() == 0);
+        REQUIRE_FALSE(store.spilled());
+        REQUIRE(store.used_memory() == 0);
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+
+#include <osmium/builder/attr.hpp>
+
+#include <tag_summary.hpp>
+
+const osmium::TagList& build_tags(osmium::memory::Buffer& buffer, const std::vector<std::pair<std::string, std::string>>& tags) {
+    using namespace osmium::builder::attr;
+    buffer.clear();
+    const size_t offset = osmium::builder::add_way(buffer, _id(1), _tags(tags));
+    return buffer.get<osmium::Way>(offset).tags();
+}
+
+TEST_CASE("tag summary") {
+    osmium::memory::Buffer buffer{1024, osmium::memory::Buffer::auto_grow::yes};
+    TagSummary summary{254};
+
+    SECTION("all tags") {
+        const osmium::TagList& tags = build_tags(buffer, {{"highway", "primary"}, {"name", "Main Street"}});
+        REQUIRE(summary.get(tags, nullptr) == "highway=primary|name=Main Street");
+    }
+
+    SECTION("exclude a key") {
+        const osmium::TagList& tags = build_tags(buffer, {{"highway", "primary"}, {"name", "Main Street"}});
+        REQUIRE(summary.get(tags, "highway") == "name=Main Street");
+        REQUIRE(summary.get(tags, "name") == "highway=primary");
+        REQUIRE(summary.get(tags, nullptr) == "highway=primary|name=Main Street");
+    }
+
+    SECTION("no tags") {
+        const osmium::TagList& tags = build_tags(buffer, {});
+        REQUIRE(summary.get(tags, nullptr).empty());
+    }
+
+    SECTION("only the excluded key") {
+        const osmium::TagList& tags = build_tags(buffer, {{"highway", "primary"}});
+        REQUIRE(summary.get(tags, "highway").empty());
+    }
+
+    SECTION("long tags are omitted") {
+        const std::string long_value(48, 'x');
+        const osmium::TagList& tags = build_tags(buffer, {{"highway", "primary"}, {"note", long_value}, {"ref", "A 1"}});
+        REQUIRE(summary.get(tags, nullptr) == "highway=primary|ref=A 1");
+    }
+
+    SECTION("string is shorter than the maximum length") {
+        std::vector<std::pair<std::string, std::string>> tag_vector;
+        for (int i = 0; i < 20; ++i) {
+            tag_vector.emplace_back("key" + std::to_string(i), "value_value_value");
+        }
+        const osmium::TagList& tags = build_tags(buffer, tag_vector);
+        const std::string& result = summary.get(tags, nullptr);
+        REQUIRE(result.size() < 254);
+        REQUIRE(result.substr(0, 24) == "key0=value_value_value|k");
+        REQUIRE(result.back() != '|');
+    }
+
+    SECTION("tags which are not valid UTF-8 are omitted") {
+        const osmium::TagList& tags = build_tags(buffer, {{"highway", "primary"}, {"name", "Stra\xdf" "e"}, {"ref", "A 1"}});
+        REQUIRE(summary.get(tags, nullptr) == "highway=primary|ref=A 1");
+    }
+
+    SECTION("reset before the next object") {
+        const osmium::TagList& tags1 = build_tags(buffer, {{"highway", "primary"}});
+        REQUIRE(summary.get(tags1, nullptr) == "highway=primary");
+        summary.reset();
+        // The new object is located at the same address.
+        const osmium::TagList& tags2 = build_tags(buffer, {{"highway", "service"}});
+        REQUIRE(summary.get(tags2, nullptr) == "highway=service");
+    }
+}
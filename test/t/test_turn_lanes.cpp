@@ -0,0 +1,87 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <string>
+
+#include <turn_lanes.hpp>
+
+std::string invalid_token(const char* value) {
+    const turn_lanes::TurnLanes result = turn_lanes::lex(value);
+    REQUIRE_FALSE(result.valid);
+    return std::string{result.invalid_token, result.invalid_length};
+}
+
+TEST_CASE("turn:lanes lexer") {
+
+    SECTION("missing tag") {
+        const turn_lanes::TurnLanes result = turn_lanes::lex(nullptr);
+        REQUIRE(result.valid);
+        REQUIRE(result.count == 0);
+        REQUIRE(result.invalid_token == nullptr);
+    }
+
+    SECTION("lane count") {
+        REQUIRE(turn_lanes::lex("left").count == 1);
+        REQUIRE(turn_lanes::lex("left;through").count == 1);
+        REQUIRE(turn_lanes::lex("left|through;right").count == 2);
+        REQUIRE(turn_lanes::lex("left||right|").count == 4);
+        REQUIRE(turn_lanes::lex("||||").count == 5);
+    }
+
+    SECTION("invalid values are counted completely") {
+        REQUIRE(turn_lanes::lex("lefX|through|right").count == 3);
+        REQUIRE(turn_lanes::lex("|").count == 2);
+        REQUIRE(turn_lanes::lex("").count == 1);
+    }
+
+    SECTION("all directions") {
+        REQUIRE(turn_lanes::lex("sharp_left;sharp_right|reverse|merge_to_left|merge_to_right").valid);
+        REQUIRE(turn_lanes::lex("none;slight_left;slight_right|left;through;right").valid);
+    }
+
+    SECTION("prefixes and extensions of directions") {
+        REQUIRE(invalid_token("lef|right") == "lef");
+        REQUIRE(invalid_token("left|rights") == "rights");
+        REQUIRE(invalid_token("left|slight") == "slight");
+        REQUIRE(invalid_token("merge_to|left") == "merge_to");
+    }
+
+    SECTION("first invalid token") {
+        REQUIRE(invalid_token("left|throuXgh|Xright") == "throuXgh");
+        REQUIRE(invalid_token("left;through;rEght") == "rEght");
+        REQUIRE(invalid_token("left|through;back|right|right") == "back");
+        REQUIRE(invalid_token("Left") == "Left");
+    }
+
+    SECTION("empty directions") {
+        REQUIRE(invalid_token(";left;through|right").empty());
+        REQUIRE(invalid_token("none|;|").empty());
+        REQUIRE(invalid_token("left|through;;right").empty());
+        // an empty direction at the end is accepted
+        REQUIRE(turn_lanes::lex("left;").valid);
+        REQUIRE(turn_lanes::lex("left|").valid);
+    }
+
+    SECTION("short values") {
+        REQUIRE(invalid_token("||") == "");
+        REQUIRE(invalid_token("abc") == "abc");
+        REQUIRE(turn_lanes::lex("||||").valid);
+    }
+}
@@ -0,0 +1,147 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <cstdint>
+#include <string>
+
+#include <utf8.hpp>
+
+/**
+ * Reference implementation decoding code point by code point
+ */
+bool reference_valid(const std::string& str) {
+    size_t i = 0;
+    while (i < str.size()) {
+        const unsigned char c = static_cast<unsigned char>(str[i]);
+        size_t length;
+        uint32_t code_point;
+        if (c < 0x80) {
+            length = 1;
+            code_point = c;
+        } else if ((c & 0xe0) == 0xc0) {
+            length = 2;
+            code_point = c & 0x1f;
+        } else if ((c & 0xf0) == 0xe0) {
+            length = 3;
+            code_point = c & 0x0f;
+        } else if ((c & 0xf8) == 0xf0) {
+            length = 4;
+            code_point = c & 0x07;
+        } else {
+            return false;
+        }
+        if (i + length > str.size()) {
+            return false;
+        }
+        for (size_t j = 1; j < length; ++j) {
+            const unsigned char cont = static_cast<unsigned char>(str[i + j]);
+            if ((cont & 0xc0) != 0x80) {
+                return false;
+            }
+            code_point = (code_point << 6) | (cont & 0x3f);
+        }
+        static const uint32_t min_code_point[] = {0, 0, 0x80, 0x800, 0x10000};
+        if (code_point < min_code_point[length] || code_point > 0x10ffff
+                || (code_point >= 0xd800 && code_point <= 0xdfff)) {
+            return false;
+        }
+        i += length;
+    }
+    return true;
+}
+
+TEST_CASE("count code points") {
+    REQUIRE(utf8::count_code_points("", 0) == 0);
+    REQUIRE(utf8::count_code_points("abc", 3) == 3);
+    const std::string mixed = "Karlsruhe カールスルーエ Ärger Straße 𝄞";
+    REQUIRE(utf8::count_code_points(mixed.data(), mixed.size()) == 32);
+    std::string long_string;
+    for (int i = 0; i < 20; ++i) {
+        long_string += "äbc";
+    }
+    REQUIRE(utf8::count_code_points(long_string.data(), long_string.size()) == 60);
+}
+
+TEST_CASE("validate UTF-8") {
+
+    SECTION("valid strings") {
+        REQUIRE(utf8::is_valid(""));
+        REQUIRE(utf8::is_valid("highway=primary"));
+        REQUIRE(utf8::is_valid("Straße カールスルーエ 𝄞"));
+        REQUIRE(utf8::is_valid("\xed\x9f\xbf")); // U+D7FF
+        REQUIRE(utf8::is_valid("\xf4\x8f\xbf\xbf")); // U+10FFFF
+    }
+
+    SECTION("invalid strings") {
+        REQUIRE_FALSE(utf8::is_valid("\x80"));
+        REQUIRE_FALSE(utf8::is_valid("abc\xc3"));
+        REQUIRE_FALSE(utf8::is_valid("\xc0\xaf")); // overlong
+        REQUIRE_FALSE(utf8::is_valid("\xe0\x80\xaf")); // overlong
+        REQUIRE_FALSE(utf8::is_valid("\xed\xa0\x80")); // surrogate
+        REQUIRE_FALSE(utf8::is_valid("\xf4\x90\x80\x80")); // above U+10FFFF
+        REQUIRE_FALSE(utf8::is_valid("\xff"));
+        REQUIRE_FALSE(utf8::is_valid("long ASCII prefix of more than 32 bytes \xe4 and an invalid byte"));
+    }
+
+    SECTION("same result as the reference for all short byte sequences") {
+        size_t mismatches = 0;
+        const unsigned char bytes[] = {0x00, 0x41, 0x7f, 0x80, 0x8f, 0x90, 0x9f, 0xa0, 0xbf, 0xc0, 0xc1,
+            0xc2, 0xdf, 0xe0, 0xe1, 0xec, 0xed, 0xee, 0xef, 0xf0, 0xf1, 0xf3, 0xf4, 0xf5, 0xff};
+        const size_t count = sizeof(bytes);
+        for (size_t a = 0; a < count; ++a) {
+            for (size_t b = 0; b < count; ++b) {
+                for (size_t c = 0; c < count; ++c) {
+                    for (size_t d = 0; d < count; ++d) {
+                        std::string str{"0123456789abcdef0123456789abcde"};
+                        str += static_cast<char>(bytes[a]);
+                        str += static_cast<char>(bytes[b]);
+                        str += static_cast<char>(bytes[c]);
+                        str += static_cast<char>(bytes[d]);
+                        if (utf8::is_valid(str.data(), str.size()) != reference_valid(str)) {
+                            ++mismatches;
+                        }
+                    }
+                }
+            }
+        }
+        REQUIRE(mismatches == 0);
+    }
+}
+
+TEST_CASE("safe cut") {
+    const std::string str = "aä€𝄞"; // 1 + 2 + 3 + 4 bytes
+    REQUIRE(utf8::safe_cut(str.data(), str.size(), 20) == 10);
+    REQUIRE(utf8::safe_cut(str.data(), str.size(), 10) == 10);
+    REQUIRE(utf8::safe_cut(str.data(), str.size(), 9) == 6);
+    REQUIRE(utf8::safe_cut(str.data(), str.size(), 7) == 6);
+    REQUIRE(utf8::safe_cut(str.data(), str.size(), 6) == 6);
+    REQUIRE(utf8::safe_cut(str.data(), str.size(), 5) == 3);
+    REQUIRE(utf8::safe_cut(str.data(), str.size(), 2) == 1);
+    REQUIRE(utf8::safe_cut(str.data(), str.size(), 0) == 0);
+}
+
+TEST_CASE("sanitize") {
+    REQUIRE(utf8::sanitize("abc", 3, 254) == "abc");
+    REQUIRE(utf8::sanitize("a\xff" "b\xc3", 4, 254) == "a?b?");
+    const std::string str = "äää";
+    REQUIRE(utf8::sanitize(str.data(), str.size(), 5) == "ää");
+    std::string long_string(300, 'x');
+    REQUIRE(utf8::sanitize(long_string.data(), long_string.size(), 254).size() == 254);
+}
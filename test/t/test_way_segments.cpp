@@ -0,0 +1,83 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/geom/haversine.hpp>
+
+#include <way_segments.hpp>
+
+const osmium::Way& build_way(osmium::memory::Buffer& buffer, const std::initializer_list<osmium::NodeRef>& nodes) {
+    using namespace osmium::builder::attr;
+    buffer.clear();
+    const size_t offset = osmium::builder::add_way(buffer, _id(1), _nodes(nodes));
+    return buffer.get<osmium::Way>(offset);
+}
+
+TEST_CASE("way segments") {
+    osmium::memory::Buffer buffer{1024, osmium::memory::Buffer::auto_grow::yes};
+    WaySegments segments;
+
+    SECTION("lengths, duplicates and bounding boxes") {
+        const osmium::Way& way = build_way(buffer, {
+            {1, osmium::Location{8.0, 49.0}},
+            {2, osmium::Location{8.5, 49.0}},
+            {2, osmium::Location{8.6, 49.1}},
+            {3, osmium::Location{8.6, 49.1}},
+            {4, osmium::Location{7.0, 48.0}}
+        });
+        REQUIRE(segments.load(way.nodes()) == 5);
+        REQUIRE(segments.segment_count() == 4);
+        REQUIRE_FALSE(segments.degenerated());
+        for (size_t i = 0; i < segments.segment_count(); ++i) {
+            const double expected = osmium::geom::haversine::distance(way.nodes()[i].location(), way.nodes()[i + 1].location());
+            REQUIRE(segments.length(i) == Approx(expected));
+        }
+        REQUIRE_FALSE(segments.duplicate(0));
+        // same ID
+        REQUIRE(segments.duplicate(1));
+        // same location
+        REQUIRE(segments.duplicate(2));
+        REQUIRE(segments.length(2) == 0);
+        REQUIRE(segments.min_x(3) == osmium::Location{7.0, 48.0}.x());
+        REQUIRE(segments.max_x(3) == osmium::Location{8.6, 49.1}.x());
+        REQUIRE(segments.min_y(3) == osmium::Location{7.0, 48.0}.y());
+        REQUIRE(segments.max_y(3) == osmium::Location{8.6, 49.1}.y());
+    }
+
+    SECTION("degenerated ways") {
+        const osmium::Way& way1 = build_way(buffer, {{1, osmium::Location{8.0, 49.0}}});
+        REQUIRE(segments.load(way1.nodes()) == 1);
+        REQUIRE(segments.degenerated());
+        const osmium::Way& way2 = build_way(buffer, {{1, osmium::Location{8.0, 49.0}}, {2, osmium::Location{8.0, 49.0}}});
+        REQUIRE(segments.load(way2.nodes()) == 2);
+        REQUIRE(segments.degenerated());
+    }
+
+    SECTION("invalid locations") {
+        const osmium::Way& way = build_way(buffer, {{1, osmium::Location{8.0, 49.0}}, {2, osmium::Location{}}});
+        REQUIRE(segments.load(way.nodes()) == 1);
+    }
+
+    SECTION("latitude limit") {
+        const osmium::Way& way = build_way(buffer, {{1, osmium::Location{8.0, 49.0}}, {2, osmium::Location{8.0, 90.0}}});
+        REQUIRE(segments.load(way.nodes()) == 2);
+        REQUIRE(segments.load(way.nodes(), 90.0) == 1);
+    }
+}